@@ -36,6 +36,8 @@
 #include "PROPOSAL/geometry/Box.h"
 #include "PROPOSAL/geometry/Cylinder.h"
 #include "PROPOSAL/geometry/GeometryFactory.h"
+#include "PROPOSAL/geometry/GeometryVariant.h"
+#include "PROPOSAL/geometry/Mesh.h"
 #include "PROPOSAL/geometry/Sphere.h"
 
 #include "PROPOSAL/crosssection/parametrization/Annihilation.h"
@@ -97,11 +99,13 @@
 #include "PROPOSAL/secondaries/parametrization/weakinteraction/WeakCooperSarkarMertsch.h"
 
 #include "PROPOSAL/secondaries/SecondariesCalculator.h"
+#include "PROPOSAL/secondaries/Thinning.h"
 
 #include "PROPOSAL/crosssection/CrossSection.h"
 #include "PROPOSAL/crosssection/CrossSectionBuilder.h"
 #include "PROPOSAL/crosssection/CrossSectionIntegral.h"
 #include "PROPOSAL/crosssection/CrossSectionInterpolant.h"
+#include "PROPOSAL/crosssection/CrossSectionBias.h"
 #include "PROPOSAL/crosssection/CrossSectionMultiplier.h"
 
 #include "PROPOSAL/crosssection/ParticleDefaultCrossSectionList.h"
@@ -114,8 +118,11 @@
 
 #include "PROPOSAL/density_distr/density_exponential.h"
 #include "PROPOSAL/density_distr/density_homogeneous.h"
+#include "PROPOSAL/density_distr/density_layered.h"
 #include "PROPOSAL/density_distr/density_polynomial.h"
 #include "PROPOSAL/density_distr/density_splines.h"
+#include "PROPOSAL/density_distr/density_variant.h"
+#include "PROPOSAL/density_distr/density_voxel.h"
 
 #include "PROPOSAL/math/Cartesian3D.h"
 #include "PROPOSAL/math/Function.h"
@@ -128,10 +135,13 @@
 #include "PROPOSAL/math/Spline.h"
 #include "PROPOSAL/math/TableWriter.h"
 
+#include "PROPOSAL/output/EventFile.h"
+
 #include "PROPOSAL/particle/Particle.h"
 #include "PROPOSAL/particle/ParticleDef.h"
 
 #include "PROPOSAL/Propagator.h"
+#include "PROPOSAL/PropagatorService.h"
 
 #include "PROPOSAL/propagation_utility/ContRand.h"
 #include "PROPOSAL/propagation_utility/ContRandBuilder.h"
@@ -140,6 +150,7 @@
 #include "PROPOSAL/propagation_utility/Displacement.h"
 #include "PROPOSAL/propagation_utility/DisplacementBuilder.h"
 #include "PROPOSAL/propagation_utility/Interaction.h"
+#include "PROPOSAL/propagation_utility/InteractionBias.h"
 #include "PROPOSAL/propagation_utility/InteractionBuilder.h"
 #include "PROPOSAL/propagation_utility/PropagationUtility.h"
 #include "PROPOSAL/propagation_utility/PropagationUtilityIntegral.h"
@@ -163,6 +174,7 @@
 #include "PROPOSAL/scattering/multiple_scattering/Highland.h"
 #include "PROPOSAL/scattering/multiple_scattering/HighlandIntegral.h"
 #include "PROPOSAL/scattering/multiple_scattering/Moliere.h"
+#include "PROPOSAL/scattering/multiple_scattering/MoliereInterpol.h"
 #include "PROPOSAL/scattering/multiple_scattering/ScatteringFactory.h"
 
 #include "PROPOSAL/scattering/Scattering.h"
@@ -1,7 +1,12 @@
 #pragma once
 
 #include "PROPOSAL/Secondaries.h"
+#include "PROPOSAL/density_distr/density_variant.h"
+#include "PROPOSAL/geometry/GeometryVariant.h"
+#include "PROPOSAL/propagation_utility/CSDARange.h"
+#include <functional>
 #include <nlohmann/json.hpp>
+#include <random>
 #include <unordered_map>
 
 namespace PROPOSAL {
@@ -13,6 +18,8 @@ using Sector = std::tuple<std::shared_ptr<const Geometry>, PropagationUtility,
     std::shared_ptr<const Density_distr>>;
 
 struct CrossSectionBase;
+class EventRecord;
+class EventWriter;
 }
 
 namespace PROPOSAL {
@@ -28,21 +35,219 @@ public:
     Secondaries Propagate(const ParticleState& initial_particle,
         double max_distance = 1e20, double min_energy = 0.,
         unsigned int hierarchy_condition = 0);
+
+    /**
+     * Propagate the particle with the random numbers drawn from rnd instead
+     * of the global RandomGenerator. The propagator itself is not modified
+     * and the utilities and scattering parametrizations keep no state
+     * between calls, so several threads can propagate with the same
+     * propagator as long as every thread uses its own rnd.
+     */
+    Secondaries Propagate(const ParticleState& initial_particle,
+        std::function<double()> rnd, double max_distance = 1e20,
+        double min_energy = 0., unsigned int hierarchy_condition = 0);
+
+    /**
+     * Propagate all particles on n_threads threads, n_threads = 0 uses all
+     * available cores. Every particle gets its own std::mt19937 seeded with
+     * (seed, index of the particle), so the result does not depend on the
+     * number of threads. The tracks are returned in the order of the
+     * initial particles.
+     */
+    std::vector<Secondaries> PropagateBatch(
+        const std::vector<ParticleState>& initial_particles,
+        unsigned int n_threads = 0, unsigned int seed = 0,
+        double max_distance = 1e20, double min_energy = 0.,
+        unsigned int hierarchy_condition = 0);
+
+    /**
+     * Propagate the particle and store the result in record instead of a
+     * Secondaries object. The record is cleared before.
+     */
+    void Propagate(const ParticleState& initial_particle,
+        std::function<double()> rnd, EventRecord& record,
+        double max_distance = 1e20, double min_energy = 0.,
+        unsigned int hierarchy_condition = 0);
+
+    /**
+     * Propagate all particles on n_threads threads and stream the results
+     * to writer in chunks of chunk_size consecutive events. Particle i gets
+     * the event id first_event + i and its generator is seeded with
+     * (seed, event id), like in PropagateBatch. A thread only starts a
+     * chunk which is less than writer.GetMaxPending() chunks ahead of the
+     * written events, so the memory for held back chunks stays bounded.
+     * Returns the number of propagated particles.
+     */
+    uint64_t PropagateToFile(const std::vector<ParticleState>& initial_particles,
+        EventWriter& writer, unsigned int n_threads = 0, unsigned int seed = 0,
+        size_t chunk_size = 1000, uint64_t first_event = 0,
+        double max_distance = 1e20, double min_energy = 0.,
+        unsigned int hierarchy_condition = 0);
+
+    /**
+     * Adjoint propagation: starting from the state a particle should have at
+     * a target, e.g. a muon entering a detector, the particle is propagated
+     * backwards through the sectors along the opposite direction until
+     * max_distance is reached or it leaves all sectors. The energy increases
+     * by the continuous losses, the stochastic losses are reverted using the
+     * crosssections of the interaction tables. The returned source state
+     * carries a weight, so that the mean of weight * S(source) over many
+     * calls is the differential flux in the target energy caused by a source
+     * with the differential flux S in energy, located at max_distance or
+     * the border of the sectors. The weight is multiplied with the weight of
+     * the target state. It is 0 if the energy exceeds the upper limit of
+     * the interpolation tables. Biased crosssections are only used to
+     * sample the losses, the weight corrects them to the true ones.
+     *
+     * The particle moves on a straight line, multiple scattering, stochastic
+     * deflections and continuous randomization are not reverted. Only
+     * charged particles with continuous losses are supported.
+     */
+    ParticleState PropagateAdjoint(const ParticleState& target_particle,
+        std::function<double()> rnd, double max_distance = 1e20);
+
+    /**
+     * Sample n_samples source states of the target state with the global
+     * RandomGenerator, see PropagateAdjoint.
+     */
+    std::vector<ParticleState> PropagateAdjoint(
+        const ParticleState& target_particle, size_t n_samples,
+        double max_distance = 1e20);
+
+    /**
+     * Seed rng for the event with the given id. Used by PropagateBatch and
+     * PropagateToFile.
+     */
+    static void SeedEvent(std::mt19937& rng, unsigned int seed, uint64_t event);
+
+    /**
+     * Stop the propagation as soon as the particle can not reach target any
+     * more. The particle can not travel further than the largest
+     * continuous slowing down range of all sectors, converted to a distance
+     * with the smallest density. This range is multiplied with
+     * safety_factor to cover fluctuations of the continuous losses.
+     * The density of homogeneous sectors is known; for other density
+     * distributions min_density (in g/cm^3) has to be given. A null target
+     * disables the check.
+     */
+    void SetTarget(std::shared_ptr<const Geometry> target,
+        double safety_factor = 1.2, double min_density = 0.);
+
+    /**
+     * Variance reduction for interactions inside a small volume. If
+     * force_interaction is set, the first stochastic interaction of the
+     * particle inside volume is forced to happen before the particle leaves
+     * the volume along its current direction. It is sampled from the free
+     * path distribution truncated at the exit and, when the interaction is
+     * reached, the weight of the particle is multiplied with the
+     * probability p of an interaction inside the volume. If a decay or the
+     * minimal energy ends the propagation before, the weight is set to 0.
+     * Histories without an interaction inside the volume are not sampled:
+     * the mean of weight * f over the tracks is E[f * 1{interaction}], the
+     * expectation of f restricted to histories with an interaction inside
+     * the volume, not the mean of f conditioned on it, which is
+     * E[f * 1{interaction}] / p. The exit is limited to max_distance and
+     * to the border of the sector the particle enters the volume in. For a
+     * volume spanning several sectors, only the part inside this sector is
+     * forced: p is the probability of an interaction inside volume and
+     * sector, and the mean estimates E[f * 1{interaction}] restricted to
+     * histories whose first interaction inside the volume happens in this
+     * sector. In the following sectors the particle is propagated as usual.
+     *
+     * If n_copies is larger than one, PropagateSplit splits the particle on
+     * entry into the volume into n_copies copies with the weight divided by
+     * n_copies. A null volume disables both.
+     */
+    void SetForcedVolume(std::shared_ptr<const Geometry> volume,
+        bool force_interaction = true, unsigned int n_copies = 1);
+
+    /**
+     * Propagate the particle like Propagate. If it enters the volume set
+     * with SetForcedVolume, it is split into n_copies independently
+     * propagated copies. Every returned track contains the full history of
+     * one copy, the weights of all its points are divided by n_copies.
+     */
+    std::vector<Secondaries> PropagateSplit(
+        const ParticleState& initial_particle, std::function<double()> rnd,
+        double max_distance = 1e20, double min_energy = 0.,
+        unsigned int hierarchy_condition = 0);
+
+    const ParticleDef& GetParticleDef() const { return p_def; }
+
+    /**
+     * Configuration the propagator has been created from. Together with the
+     * particle definition and the interpolation settings it is sufficient to
+     * recreate the propagator from already written tables. Null if the
+     * propagator has been created from a list of sectors.
+     */
+    const nlohmann::json& GetConfig() const { return config; }
+
+    /**
+     * Values of the InterpolationSettings, which are global, at the
+     * construction of a propagator.
+     */
+    struct TableSettings {
+        std::string tables_path;
+        double upper_energy_lim;
+        unsigned int nodes_dedx;
+        unsigned int nodes_de2dx;
+        unsigned int nodes_dndx_e;
+        unsigned int nodes_dndx_v;
+        unsigned int nodes_utility;
+        unsigned int nodes_rate_interpolant;
+
+        //! Copy of the current InterpolationSettings.
+        static TableSettings Current();
+        //! Writes the values to the InterpolationSettings.
+        void Apply() const;
+    };
+
+    /**
+     * InterpolationSettings the tables of the propagator have been built
+     * with.
+     */
+    const TableSettings& GetInterpolationSettings() const
+    {
+        return interpolation_settings;
+    }
+
+    static nlohmann::json ParseConfig(const std::string& config_file);
+
     enum { GEOMETRY, UTILITY, DENSITY_DISTR };
 
 private:
+    // Returns true if the propagation stopped on entry into the forced
+    // volume because split is set.
+    template <typename Track>
+    bool PropagateTrack(Track&, const ParticleState& initial_particle,
+        std::function<double()>& rnd, double max_distance, double min_energy,
+        unsigned int hierarchy_condition, bool split = false);
+
     Interaction::Loss DoStochasticInteraction(
         ParticleState&, PropagationUtility&, std::function<double()>);
     int AdvanceParticle(ParticleState& p_cond, const double E_f,
                         const double max_distance, std::function<double()> rnd,
-                        Sector& current_sector, bool min_energy_step,
-                        const double min_energy);
-    double CalculateDistanceToBorder(const Vector3D& particle_position,
-        const Vector3D& particle_direction, const Geometry& current_geometry);
+                        Sector& current_sector, size_t& sector_index,
+                        bool min_energy_step, const double min_energy);
+
+    /*!
+     * Result of QueryGeometry: the intersection with the geometry of the
+     * current sector and the distance to the next border of the current
+     * geometry or of a geometry with a higher hierarchy. The latter is only
+     * calculated if the particle is inside the current geometry.
+     */
+    struct GeometryQuery {
+        Geometry::Intersection current;
+        double distance_to_border;
+    };
+    GeometryQuery QueryGeometry(const Vector3D& particle_position,
+        const Vector3D& particle_direction,
+        const GeometryVariant& current_geometry);
     int maximize(const std::array<double, 3>& InteractionEnergies);
     int minimize(const std::array<double, 3>& AdvanceDistances);
-    Sector GetCurrentSector(
+    size_t GetCurrentSectorIndex(
         const Vector3D& particle_position, const Vector3D& particle_direction);
+    void InitializeSectorVariants();
     // Global settings
     struct GlobalSettings {
         GlobalSettings();
@@ -53,24 +258,44 @@ private:
         std::shared_ptr<Medium> medium = nullptr;
         bool do_exact_time;
         bool do_interpolation;
+        bool do_binned_sampling;
     };
 
     // Initializing methods
-    static nlohmann::json ParseConfig(const std::string& config_file);
     void InitializeSectorFromJSON(
         const ParticleDef&, const nlohmann::json&, GlobalSettings);
 
     PropagationUtility::Collection CreateUtility(
         std::vector<std::shared_ptr<CrossSectionBase>> crosss,
         std::shared_ptr<Medium> medium, bool do_cont_rand, bool do_interpol,
-        bool do_exact_time, nlohmann::json scatter);
+        bool do_exact_time, nlohmann::json scatter,
+        bool do_binned_sampling = false);
 
     std::vector<std::shared_ptr<CrossSectionBase>> CreateCrossSectionList(
         const ParticleDef& p_def, const Medium& medium,
         std::shared_ptr<const EnergyCutSettings> cuts, bool interpolate,
         double density_correction, const nlohmann::json& config);
 
+    struct TargetCut {
+        std::shared_ptr<const Geometry> target;
+        std::vector<CSDARange> ranges;
+        double safety_factor;
+        double min_density;
+
+        bool IsReachable(const ParticleState&) const;
+    };
+
+    struct ForcedVolume {
+        std::shared_ptr<const Geometry> volume;
+        bool force_interaction;
+        unsigned int n_copies;
+    };
+
     ParticleDef p_def;
+    nlohmann::json config;
+    TableSettings interpolation_settings = TableSettings::Current();
+    std::shared_ptr<const TargetCut> target_cut;
+    std::shared_ptr<const ForcedVolume> forced_volume;
     enum Type : int {
         MinimalE = 0,
         Decay = 1,
@@ -84,6 +309,8 @@ private:
     };
 
     std::vector<Sector> sector_list;
+    std::vector<GeometryVariant> sector_geometries; //!< same order as sector_list
+    std::vector<DensityVariant> sector_densities; //!< same order as sector_list
 };
 
 } // namespace PROPOSAL
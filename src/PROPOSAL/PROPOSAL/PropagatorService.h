@@ -0,0 +1,72 @@
+#pragma once
+
+#include "PROPOSAL/Propagator.h"
+#include "PROPOSAL/particle/ParticleDef.h"
+
+#include <mutex>
+#include <shared_mutex>
+
+namespace PROPOSAL {
+
+/**
+ * Owns one propagator per particle type and routes the particles to the
+ * propagator of their type. All propagators created from one config share
+ * the tables in InterpolationSettings::TABLES_PATH, so every table is only
+ * calculated for the first particle type that needs it.
+ *
+ * Registering and propagating can be done from several threads at the same
+ * time.
+ */
+class PropagatorService {
+public:
+    PropagatorService() = default;
+
+    /**
+     * Create the propagators of all given particle types from one config.
+     * By default, propagators for mu, tau, e (and their antiparticles) and
+     * gamma are created.
+     */
+    PropagatorService(const nlohmann::json& config,
+        std::vector<ParticleType> types = DefaultTypes());
+    PropagatorService(const std::string& config_file,
+        std::vector<ParticleType> types = DefaultTypes());
+
+    /**
+     * Add a propagator. An already registered propagator of the same
+     * particle type is replaced.
+     */
+    void RegisterPropagator(std::shared_ptr<Propagator> propagator);
+
+    bool IsRegistered(ParticleType type) const;
+    std::shared_ptr<Propagator> GetPropagator(ParticleType type) const;
+
+    /**
+     * Propagate the particle with the propagator of its type. The random
+     * numbers are drawn from the global RandomGenerator, which is locked
+     * for every draw.
+     *
+     * @throw std::out_of_range if no propagator is registered for the type
+     */
+    Secondaries Propagate(const ParticleState& initial_particle,
+        double max_distance = 1e20, double min_energy = 0.,
+        unsigned int hierarchy_condition = 0);
+
+    /**
+     * Propagate the particle with the random numbers drawn from rnd. Calls
+     * with different rnd do not need any synchronization.
+     */
+    Secondaries Propagate(const ParticleState& initial_particle,
+        std::function<double()> rnd, double max_distance = 1e20,
+        double min_energy = 0., unsigned int hierarchy_condition = 0);
+
+    static std::vector<ParticleType> DefaultTypes();
+
+private:
+    std::unordered_map<ParticleType, std::shared_ptr<Propagator>,
+        ParticleType_hash>
+        propagators_;
+    mutable std::shared_timed_mutex propagators_mutex_;
+    std::mutex rnd_mutex_;
+};
+
+} // namespace PROPOSAL
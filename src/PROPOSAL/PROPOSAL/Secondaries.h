@@ -39,6 +39,7 @@ namespace PROPOSAL {
 
 class Density_distr;
 class Geometry;
+class Thinning;
 class Vector3D;
 
 using Sector = std::tuple<std::shared_ptr<const Geometry>, PropagationUtility,
@@ -210,6 +211,12 @@ public:
      */
     std::vector<ParticleState> GetDecayProducts() const;
 
+    /*!
+     * Decay products like GetDecayProducts, thinned with the given thinning.
+     * The surviving particles carry the corrected weights.
+     */
+    std::vector<ParticleState> GetDecayProducts(const Thinning&) const;
+
     // Loss functions
 
     /*!
@@ -341,6 +348,16 @@ public:
      */
     std::vector<double> GetTrackPropagatedDistances() const;
 
+    /*!
+     * Returns the list of the statistical weights of the propagated particle.
+     * The weights differ from 1 only if crosssections are biased, in which
+     * case every weighted quantity is an unbiased estimate. The last element
+     * is the weight of the whole event.
+     * @return List of doubles, describing the weights of the particle during
+     * propagation
+     */
+    std::vector<double> GetTrackWeights() const;
+
     /*!
      * Returns a list of interaction types describing the interactions of the
      * particle during propagation.
@@ -386,6 +403,15 @@ public:
     const ParticleState& back() const {return track_.back(); }
     const ParticleState& operator[](std::size_t idx) { return track_[idx]; };
 
+    /*!
+     * Read access to the underlying storage without copying, e.g. to expose
+     * it as numpy views. The references are invalidated when the track is
+     * modified.
+     */
+    const std::vector<ParticleState>& GetTrackData() const { return track_; };
+    const std::vector<InteractionType>& GetTrackTypesData() const { return types_; };
+    const std::vector<size_t>& GetTargetHashesData() const { return target_hashes_; };
+
 private:
     ParticleState RePropagateDistance(const ParticleState& init_state,
                                       const Cartesian3D& direction,
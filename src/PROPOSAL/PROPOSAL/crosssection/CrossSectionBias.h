@@ -0,0 +1,49 @@
+#pragma once
+#include "PROPOSAL/crosssection/CrossSectionMultiplier.h"
+
+#include <stdexcept>
+
+namespace PROPOSAL {
+    /**
+     * Enhances the rate of stochastic interactions of a crosssection by the
+     * factor bias, while the continuous losses are left untouched. In
+     * contrast to the CrossSectionMultiplier, the physics stays unbiased:
+     * the propagation utility collects the biased crosssections into an
+     * InteractionBias, which corrects the weight of the particle state after
+     * every step, so that the weighted distributions equal the ones
+     * propagated without bias.
+     */
+    struct CrossSectionBias : public CrossSectionMultiplier {
+        CrossSectionBias(std::shared_ptr<CrossSectionBase> cross, double bias)
+            : CrossSectionMultiplier(cross, bias)
+        {
+            if (bias <= 0)
+                throw std::invalid_argument("The bias of a crosssection must be positive.");
+        }
+
+        double CalculatedEdx(double energy) override {
+            return cross_->CalculatedEdx(energy);
+        }
+
+        double CalculatedE2dx(double energy) override {
+            return cross_->CalculatedE2dx(energy);
+        }
+
+        size_t GetHash() const noexcept override {
+            auto hash = CrossSectionMultiplier::GetHash();
+            hash_combine(hash, std::string("bias"));
+            return hash;
+        }
+
+        double GetBias() const noexcept { return multiplier_; }
+
+        //! the unbiased crosssection
+        std::shared_ptr<CrossSectionBase> GetCrossSection() const noexcept { return cross_; }
+    };
+}
+
+namespace PROPOSAL {
+    inline auto make_crosssection_bias(std::shared_ptr<CrossSectionBase> cross, double bias) {
+        return std::unique_ptr<CrossSectionBase>(new CrossSectionBias(cross, bias));
+    }
+}
@@ -88,12 +88,25 @@ class CrossSectionDNDXInterpolant : public CrossSectionDNDX, public LogTableCrea
     std::function<double(double, double, double)> retransform_v;
     cubic_splines::Interpolant<cubic_splines::BicubicSplines<double>>
         interpolant;
+
+    //!
+    //! Inverse of the interpolant. The transformed relative energy loss vbar
+    //! is tabulated as a function of the energy and w = sqrt(1 - r), where r
+    //! is the rate normalized to the total rate. The square root resolves
+    //! the behaviour near the kinematic limit, where dNdv vanishes for most
+    //! parametrizations.
+    //!
+    cubic_splines::Interpolant<cubic_splines::BicubicSplines<double>>
+        inverse_interpolant;
     InteractionType type_id;
 
     std::string gen_path() const;
     std::string gen_name() const;
+    std::string gen_inverse_name() const;
     size_t gen_hash(size_t) const;
     double evaluate_interpolant(double E, double vbar);
+    double solve_interpolant(double E, double rate);
+    cubic_splines::BicubicSplines<double>::Definition build_inverse_def();
 
 public:
     template <typename Param, typename Target>
@@ -104,6 +117,7 @@ public:
         , transform_v(transform_loss<Param>)
         , retransform_v(retransform_loss<Param>)
         , interpolant(build_dndx_def(param, p, t, cut), gen_path(), gen_name())
+        , inverse_interpolant(build_inverse_def(), gen_path(), gen_inverse_name())
         , type_id(static_cast<InteractionType>(
                 crosssection::ParametrizationId<Param>::value))
     {
@@ -57,7 +57,7 @@ namespace PROPOSAL {
             return cross_->GetEnergyCutSettings();
         }
 
-    private:
+    protected:
         std::shared_ptr<CrossSectionBase> cross_;
         double multiplier_;
     };
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -59,7 +60,18 @@ public:
     // Public methods
     // --------------------------------------------------------------------- //
 
-    virtual std::vector<ParticleState> Decay(const ParticleDef&, const ParticleState&) = 0;
+    // ----------------------------------------------------------------------------
+    /// @brief Decay the particle with the global RandomGenerator
+    // ----------------------------------------------------------------------------
+    std::vector<ParticleState> Decay(const ParticleDef&, const ParticleState&);
+
+    // ----------------------------------------------------------------------------
+    /// @brief Decay the particle with the random numbers drawn from rnd
+    ///
+    /// Every random number of the decay is taken from rnd, so decays with
+    /// separate generators can run on several threads at once.
+    // ----------------------------------------------------------------------------
+    virtual std::vector<ParticleState> Decay(const ParticleDef&, const ParticleState&, std::function<double()> rnd) = 0;
 
     // ----------------------------------------------------------------------------
     /// @brief Boost the particle along a direction
@@ -120,6 +132,7 @@ public:
     /// @return
     // ----------------------------------------------------------------------------
     static Cartesian3D GenerateRandomDirection();
+    static Cartesian3D GenerateRandomDirection(const std::function<double()>& rnd);
 
     // ----------------------------------------------------------------------------
     /// @brief Sets the uniform flag in the ManyBodyPhaseSpace channels
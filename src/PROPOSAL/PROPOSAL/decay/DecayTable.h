@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <ostream>
 #include <vector>
@@ -37,6 +38,8 @@ namespace PROPOSAL {
 
 class DecayChannel;
 class DecayTable;
+struct ParticleDef;
+struct ParticleState;
 
 void swap(DecayTable&, DecayTable&);
 
@@ -60,12 +63,44 @@ public:
     // ----------------------------------------------------------------------------
     /// @brief Get a decay channel
     ///
-    /// The Decay channels will be sampled from the previous given branching ratios
+    /// The Decay channels will be sampled from the previous given branching ratios.
+    /// The cumulative branching ratios are precomputed whenever the table
+    /// changes, so the selection is a binary search.
     ///
     /// @return Sampled Decay channel
     // ----------------------------------------------------------------------------
     DecayChannel& SelectChannel(double rnd) const;
 
+    // ----------------------------------------------------------------------------
+    /// @brief Select the channels and decay several parents at once
+    ///
+    /// The channel of parent i is selected with rnd_channel[i]. Parents decaying
+    /// into the same channel are passed to the channel together. The products
+    /// of parent i are stored in products[offsets[i], offsets[i + 1]).
+    /// The channels draw their random numbers from rnd. Several threads may
+    /// decay with the same table at once if every thread passes its own
+    /// generator. The overload without rnd uses the global RandomGenerator
+    /// and must not be called from several threads at once.
+    ///
+    /// @param p_def definition of the parents, all parents must be of this type
+    /// @param p_conditions the states of the parents
+    /// @param rnd_channel one random number per parent for the channel selection
+    /// @param products will be filled with the decay products
+    /// @param offsets will be filled with p_conditions.size() + 1 offsets
+    /// @param rnd random numbers of the decays
+    // ----------------------------------------------------------------------------
+    void Decay(const ParticleDef& p_def,
+               const std::vector<ParticleState>& p_conditions,
+               const std::vector<double>& rnd_channel,
+               std::vector<ParticleState>& products,
+               std::vector<size_t>& offsets) const;
+    void Decay(const ParticleDef& p_def,
+               const std::vector<ParticleState>& p_conditions,
+               const std::vector<double>& rnd_channel,
+               std::vector<ParticleState>& products,
+               std::vector<size_t>& offsets,
+               std::function<double()> rnd) const;
+
     // ----------------------------------------------------------------------------
     /// @brief Add decay channels to the decay table
     ///
@@ -100,8 +135,14 @@ public:
 
 private:
     void clearTable();
+    void BuildSelector();
+    size_t SelectChannelIndex(double rnd) const;
 
     DecayMap channels_;
+
+    // Frozen view on channels_ for the selection
+    std::vector<double> cumulative_br_;
+    std::vector<DecayChannel*> selector_channels_;
 };
 
 std::ostream& operator<<(std::ostream&, PROPOSAL::DecayTable const&);
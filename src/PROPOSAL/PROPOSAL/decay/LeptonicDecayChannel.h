@@ -31,6 +31,10 @@
 #include "PROPOSAL/decay/DecayChannel.h"
 #include "PROPOSAL/particle/ParticleDef.h"
 
+#include <map>
+#include <memory>
+#include <shared_mutex>
+
 namespace PROPOSAL {
 
 class Particle;
@@ -44,7 +48,8 @@ public:
     // No copy and assignemnt -> done by clone
     DecayChannel* clone() const { return new LeptonicDecayChannelApprox(*this); }
 
-    std::vector<ParticleState> Decay(const ParticleDef&, const ParticleState&);
+    using DecayChannel::Decay;
+    std::vector<ParticleState> Decay(const ParticleDef&, const ParticleState&, std::function<double()>);
 
     const std::string& GetName() const { return name_; }
 
@@ -60,16 +65,44 @@ protected:
     void print(std::ostream&) const;
 
     // ----------------------------------------------------------------------------
-    /// @brief Function for electron energy calculation - interface to FindRoot
+    /// @brief Function for electron energy calculation - solved for the nodes
+    /// of the inverse rate table
     // ----------------------------------------------------------------------------
     virtual double DecayRate(double x, double parent_mass, double E_max, double right_side);
 
     // ----------------------------------------------------------------------------
-    /// @brief Function for electron energy calculation - interface to FindRoot
+    /// @brief Derivative of DecayRate in x
     // ----------------------------------------------------------------------------
     virtual double DifferentialDecayRate(double x, double parent_mass, double E_max);
 
-    double FindRoot(double min, double parent_mass, double E_max, double right_side);
+    // ----------------------------------------------------------------------------
+    /// @brief Inverse of the normalised decay rate
+    ///
+    /// The energy fraction x is tabulated on an equidistant grid in
+    /// u = rnd^(1/3), which absorbs the cubic onset of the rate at x_min and
+    /// keeps x(u) smooth. The tables are cached per parent mass and shared
+    /// with the copies of the channel. A table is built once, under the
+    /// exclusive lock, while lookups only take a shared lock.
+    // ----------------------------------------------------------------------------
+    struct InverseRateTable
+    {
+        std::vector<double> x;
+        std::vector<double> slope;
+    };
+
+    struct InverseRateCache
+    {
+        std::map<double, std::shared_ptr<const InverseRateTable>> tables;
+        std::shared_timed_mutex mutex;
+    };
+
+    static constexpr size_t INVERSE_RATE_NODES = 200;
+
+    std::shared_ptr<const InverseRateTable> GetInverseRateTable(double parent_mass);
+    std::shared_ptr<const InverseRateTable> BuildInverseRateTable(double parent_mass);
+    static double SampleEnergyFraction(const InverseRateTable&, double rnd);
+
+    std::shared_ptr<InverseRateCache> inverse_rate_cache_;
 };
 
 class LeptonicDecayChannel : public LeptonicDecayChannelApprox
@@ -31,8 +31,10 @@
 
 #include <unordered_map>
 #include <functional>
+#include <shared_mutex>
 
 #include "PROPOSAL/decay/DecayChannel.h"
+#include "PROPOSAL/methods.h"
 #include "PROPOSAL/particle/ParticleDef.h"
 
 namespace PROPOSAL {
@@ -56,7 +58,21 @@ public:
         double weight;
     };
 
-    typedef std::unordered_map<ParticleDef, PhaseSpaceParameters> ParameterMap;
+    // The phase space parameters only depend on the parent mass, the particle
+    // type is part of the key to keep parents of equal mass apart.
+    typedef std::pair<int, double> ParameterKey;
+
+    struct ParameterKeyHash
+    {
+        std::size_t operator()(const ParameterKey& key) const
+        {
+            std::size_t seed = 0;
+            hash_combine(seed, key.first, key.second);
+            return seed;
+        }
+    };
+
+    typedef std::unordered_map<ParameterKey, PhaseSpaceParameters, ParameterKeyHash> ParameterMap;
     typedef std::function<double(const ParticleState&, const std::vector<ParticleState>&)> MatrixElementFunction;
     typedef std::function<void(PhaseSpaceParameters&, const ParticleDef&)> EstimateFunction;
 
@@ -77,7 +93,32 @@ public:
     ///
     /// @return Vector of particles, the decay products
     // ----------------------------------------------------------------------------
-    std::vector<ParticleState> Decay(const ParticleDef& p_def, const ParticleState& p_condition);
+    using DecayChannel::Decay;
+    std::vector<ParticleState> Decay(const ParticleDef& p_def, const ParticleState& p_condition, std::function<double()> rnd);
+
+    // ----------------------------------------------------------------------------
+    /// @brief Many body phase space decay of several parents
+    ///
+    /// All parents must be of type p_def. The phase space parameters are
+    /// looked up once and the intermediate storage is reused for every event.
+    /// The products of parent i are written to
+    /// products[i * n, (i + 1) * n), with n = GetNumberOfDaughters().
+    ///
+    /// @param p_def
+    /// @param p_conditions
+    /// @param products will be resized to hold all decay products
+    /// @param rnd random numbers of the decays, the global RandomGenerator
+    ///        is used by the overload without rnd
+    // ----------------------------------------------------------------------------
+    void Decay(const ParticleDef& p_def,
+               const std::vector<ParticleState>& p_conditions,
+               std::vector<ParticleState>& products);
+    void Decay(const ParticleDef& p_def,
+               const std::vector<ParticleState>& p_conditions,
+               std::vector<ParticleState>& products,
+               std::function<double()> rnd);
+
+    size_t GetNumberOfDaughters() const { return daughters_.size(); }
 
     // ----------------------------------------------------------------------------
     /// @brief Evalutate the matrix element of this channel
@@ -114,6 +155,25 @@ public:
 private:
     /* ManyBodyPhaseSpace& operator=(const ManyBodyPhaseSpace&); // Undefined & not allowed */
 
+    // Storage reused between the events of one decay call
+    struct Workspace
+    {
+        PhaseSpaceKinematics kinematics;
+        std::vector<double> randoms;
+        std::vector<ParticleState> products;
+    };
+
+    // ----------------------------------------------------------------------------
+    /// @brief Generate the decay products of one parent in the lab frame
+    ///
+    /// The products are stored in workspace.products.
+    // ----------------------------------------------------------------------------
+    void DecayEvent(const ParticleDef& p_def,
+                    const PhaseSpaceParameters& params,
+                    const ParticleState& p_condition,
+                    Workspace& workspace,
+                    const std::function<double()>& rnd);
+
 
     // ----------------------------------------------------------------------------
     /// @brief Many body phase space decay
@@ -124,7 +184,7 @@ private:
     ///
     /// @return Vector of particles, the decay products
     // ----------------------------------------------------------------------------
-    void GenerateEvent(std::vector<ParticleState>& products, const PhaseSpaceKinematics& kinematics);
+    void GenerateEvent(std::vector<ParticleState>& products, const PhaseSpaceKinematics& kinematics, const std::function<double()>& rnd);
 
     // ----------------------------------------------------------------------------
     /// @brief Calculate the normalization of the phase space density
@@ -167,7 +227,9 @@ private:
     /// @param parent
     ///
     /// For every particle definition the normalization and maximum weight is unique.
-    /// Both values will be created and stored in an hash table.
+    /// Both values will be created and stored in an hash table. Lookups take
+    /// a shared lock, only missing parameters are calculated under the
+    /// exclusive lock.
     ///
     /// @return struct containing the normalization and maximum weight
     // ----------------------------------------------------------------------------
@@ -183,7 +245,8 @@ private:
     /// @return struct containing the weight of the phase space point,
     ///         intermediate momenta and virtual masses for the algorithm.
     // ----------------------------------------------------------------------------
-    PhaseSpaceKinematics CalculateKinematics(double normalization, double parent_mass);
+    PhaseSpaceKinematics CalculateKinematics(double normalization, double parent_mass, const std::function<double()>& rnd);
+    void CalculateKinematics(PhaseSpaceKinematics&, std::vector<double>& randoms, double normalization, double parent_mass, const std::function<double()>& rnd);
 
     bool compare(const DecayChannel&) const;
     void print(std::ostream&) const;
@@ -203,6 +266,7 @@ private:
     static const std::string name_;
 
     ParameterMap parameter_map_;
+    std::shared_timed_mutex parameter_mutex_;
 };
 
 class ManyBodyPhaseSpace::Builder
@@ -45,7 +45,8 @@ public:
     DecayChannel* clone() const { return new StableChannel(*this); }
 
 
-    std::vector<ParticleState> Decay(const ParticleDef&, const ParticleState&);
+    using DecayChannel::Decay;
+    std::vector<ParticleState> Decay(const ParticleDef&, const ParticleState&, std::function<double()>);
 
     const std::string& GetName() const { return name_; }
 
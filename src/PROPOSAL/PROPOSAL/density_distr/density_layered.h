@@ -0,0 +1,113 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "PROPOSAL/density_distr/density_distr.h"
+
+namespace PROPOSAL {
+/**
+ * Spherically layered density, e.g. the PREM earth model. The density in
+ * layer i is a polynomial in the scaled radius x = r / radius_scale,
+ * rho(x) = density_scale * sum_k coefficients[k] * x^k, for radii between
+ * the outer radius of the layer below and the own outer radius. Outside of
+ * the last layer the density is zero.
+ *
+ * The grammage along a straight line is integrated in closed form. The
+ * line is split at the layer boundaries and at its closest approach to the
+ * center, so the density is a polynomial in sqrt(b^2 + s^2) on every piece,
+ * where b is the impact parameter and s the distance to the closest
+ * approach.
+ *
+ * Only the density changes from layer to layer. The medium, and therefore
+ * the cross sections and interpolation tables of the sector, is the same
+ * in all layers. Layers of different media, e.g. a rock mantle and an iron
+ * core, still have to be described by one sector per medium.
+ */
+class Density_layered : public Density_distr {
+   public:
+    struct Layer {
+        double outer_radius;
+        std::vector<double> coefficients;
+    };
+
+    Density_layered(const Vector3D& center,
+                    std::vector<Layer> layers,
+                    double radius_scale = 1.,
+                    double density_scale = 1.);
+    Density_layered(const nlohmann::json&);
+    Density_layered(const Density_layered&) = default;
+
+    bool compare(const Density_distr& dens_distr) const override;
+
+    Density_distr* clone() const override {
+        return new Density_layered(*this);
+    };
+
+    double Correct(const Vector3D& xi,
+                   const Vector3D& direction,
+                   double res,
+                   double distance_to_border) const override;
+    double Integrate(const Vector3D& xi,
+                     const Vector3D& direction,
+                     double l) const override;
+    double Calculate(const Vector3D& xi,
+                     const Vector3D& direction,
+                     double distance) const override;
+    double Evaluate(const Vector3D& xi) const override;
+
+    const std::vector<Layer>& GetLayers() const { return layers_; }
+
+    //! Preliminary reference earth model (Dziewonski & Anderson, 1981) with
+    //! radius_scale EARTH_RADIUS.
+    static std::vector<Layer> PREM();
+    static constexpr double EARTH_RADIUS = 6.371e8; // cm
+
+   private:
+    struct Chord {
+        double s0; // distance of xi to the closest approach, scaled
+        double b2; // squared impact parameter, scaled
+    };
+
+    Chord GetChord(const Vector3D& xi, const Vector3D& direction) const;
+    int GetLayer(double x) const;
+    double EvaluateLayer(int layer, double x) const;
+    double IntegrateLayer(int layer, const Chord&, double s) const;
+
+    //! Call f(layer, s_low, s_high) for the pieces of the chord between
+    //! s_begin and s_end, in this order, until f returns false.
+    template <typename Function>
+    void ForEachPiece(const Chord&, double s_begin, double s_end,
+                      Function&& f) const;
+
+    std::vector<Layer> layers_;
+    double radius_scale_;
+    std::vector<double> outer_x_; // scaled outer radii of the layers
+};
+}  // namespace PROPOSAL
@@ -61,19 +61,12 @@ class Density_polynomial : public Density_distr {
                      double distance) const override;
 
    protected:
-    double Helper_function(const Vector3D& xi,
-                           const Vector3D& direction,
-                           double res,
-                           double l) const;
-    double helper_function(const Vector3D& xi,
-                           const Vector3D& direction,
-                           double res,
-                           double l) const;
-
     Polynom polynom_;
     Polynom Polynom_;
 
     std::function<double(double)> density_distribution;
     std::function<double(double)> antiderived_density_distribution;
+
+    std::vector<double> antiderivative_coefficients_;
 };
 }  // namespace PROPOSAL
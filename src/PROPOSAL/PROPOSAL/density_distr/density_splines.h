@@ -77,9 +77,18 @@ class Density_splines : public Density_distr {
                            double l) const;
 
    protected:
+    void InitSegments();
+    size_t GetSegment(double depth) const;
+    double EvaluateAntiderivative(size_t segment, double depth) const;
+
     Spline* spline_;
     Spline* integrated_spline_;
 
+    // borders and antiderivative coefficients of the spline segments, the
+    // antiderivative is continuous over the segment borders
+    std::vector<double> segment_borders_;
+    std::vector<std::vector<double>> segment_antiderivatives_;
+
     std::function<double(double)> density_distribution;
     std::function<double(double)> antiderived_density_distribution;
 };
@@ -0,0 +1,156 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "PROPOSAL/density_distr/density_exponential.h"
+#include "PROPOSAL/density_distr/density_homogeneous.h"
+#include "PROPOSAL/density_distr/density_layered.h"
+#include "PROPOSAL/density_distr/density_polynomial.h"
+#include "PROPOSAL/density_distr/density_splines.h"
+#include "PROPOSAL/density_distr/density_voxel.h"
+
+namespace PROPOSAL {
+
+/*!
+ * Closed set of the built-in density distributions for the propagation
+ * loop, the counterpart of GeometryVariant. Homogeneous densities are
+ * evaluated inline, the other built-in distributions are called directly
+ * instead of through the vtable. Other distributions, including classes
+ * derived from the built-in ones, use the virtual interface of
+ * Density_distr. The variant does not own the distribution.
+ */
+class DensityVariant {
+public:
+    explicit DensityVariant(const Density_distr&);
+
+    double Correct(const Vector3D& xi, const Vector3D& direction, double res,
+        double distance_to_border) const
+    {
+        switch (type_) {
+        case Type::Homogeneous:
+            return res / mass_density_;
+        case Type::Exponential:
+            return static_cast<const Density_exponential*>(density_)
+                ->Density_exponential::Correct(
+                    xi, direction, res, distance_to_border);
+        case Type::Polynomial:
+            return static_cast<const Density_polynomial*>(density_)
+                ->Density_polynomial::Correct(
+                    xi, direction, res, distance_to_border);
+        case Type::Splines:
+            return static_cast<const Density_splines*>(density_)
+                ->Density_splines::Correct(
+                    xi, direction, res, distance_to_border);
+        case Type::Layered:
+            return static_cast<const Density_layered*>(density_)
+                ->Density_layered::Correct(
+                    xi, direction, res, distance_to_border);
+        case Type::Voxel:
+            return static_cast<const Density_voxel*>(density_)
+                ->Density_voxel::Correct(
+                    xi, direction, res, distance_to_border);
+        case Type::Other:
+            break;
+        }
+        return density_->Correct(xi, direction, res, distance_to_border);
+    }
+
+    double Calculate(
+        const Vector3D& xi, const Vector3D& direction, double distance) const
+    {
+        switch (type_) {
+        case Type::Homogeneous:
+            return mass_density_ * distance;
+        case Type::Exponential:
+            return static_cast<const Density_exponential*>(density_)
+                ->Density_exponential::Calculate(xi, direction, distance);
+        case Type::Polynomial:
+            return static_cast<const Density_polynomial*>(density_)
+                ->Density_polynomial::Calculate(xi, direction, distance);
+        case Type::Splines:
+            return static_cast<const Density_splines*>(density_)
+                ->Density_splines::Calculate(xi, direction, distance);
+        case Type::Layered:
+            return static_cast<const Density_layered*>(density_)
+                ->Density_layered::Calculate(xi, direction, distance);
+        case Type::Voxel:
+            return static_cast<const Density_voxel*>(density_)
+                ->Density_voxel::Calculate(xi, direction, distance);
+        case Type::Other:
+            break;
+        }
+        return density_->Calculate(xi, direction, distance);
+    }
+
+    double Evaluate(const Vector3D& xi) const
+    {
+        switch (type_) {
+        case Type::Homogeneous:
+            return mass_density_;
+        case Type::Exponential:
+            return static_cast<const Density_exponential*>(density_)
+                ->Density_exponential::Evaluate(xi);
+        case Type::Polynomial:
+            return static_cast<const Density_polynomial*>(density_)
+                ->Density_polynomial::Evaluate(xi);
+        case Type::Splines:
+            return static_cast<const Density_splines*>(density_)
+                ->Density_splines::Evaluate(xi);
+        case Type::Layered:
+            return static_cast<const Density_layered*>(density_)
+                ->Density_layered::Evaluate(xi);
+        case Type::Voxel:
+            return static_cast<const Density_voxel*>(density_)
+                ->Density_voxel::Evaluate(xi);
+        case Type::Other:
+            break;
+        }
+        return density_->Evaluate(xi);
+    }
+
+    const Density_distr& GetDensity() const { return *density_; }
+
+private:
+    enum class Type {
+        Homogeneous,
+        Exponential,
+        Polynomial,
+        Splines,
+        Layered,
+        Voxel,
+        Other
+    };
+
+    const Density_distr* density_;
+    Type type_;
+    double mass_density_; //!< only used for homogeneous densities
+};
+
+} // namespace PROPOSAL
@@ -0,0 +1,127 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include "PROPOSAL/density_distr/density_distr.h"
+#include "PROPOSAL/math/Cartesian3D.h"
+
+namespace PROPOSAL {
+/**
+ * Regular grid of n[0] x n[1] x n[2] voxels, starting at origin with the
+ * edge lengths spacing. The values are the mass density scale factors of
+ * the voxels, with the x index running fastest. Optionally, every voxel
+ * carries a medium index.
+ *
+ * The binary file format is the magic "PPVX", the version, n as uint64,
+ * origin and spacing as doubles, a uint8 flag for the medium indices, the
+ * values as doubles and, if flagged, the medium indices as int32.
+ */
+struct VoxelGrid {
+    static constexpr uint32_t MAGIC = 0x58565050; // "PPVX"
+    static constexpr uint32_t VERSION = 1;
+
+    std::array<size_t, 3> n;
+    Cartesian3D origin;
+    std::array<double, 3> spacing;
+    std::vector<double> values;
+    std::vector<int32_t> media;
+
+    static VoxelGrid Read(const std::string& path);
+    void Write(const std::string& path) const;
+
+    size_t size() const { return n[0] * n[1] * n[2]; }
+    size_t GetIndex(size_t i, size_t j, size_t k) const {
+        return i + n[0] * (j + n[1] * k);
+    }
+    //! Returns false if the position is outside of the grid.
+    bool GetVoxel(const Vector3D& position, std::array<size_t, 3>& voxel) const;
+};
+
+/**
+ * Density given by a voxel grid, rho = mass_density * scale factor of the
+ * voxel. Outside of the grid, the scale factor outside_scale is used.
+ * Calculate and Correct march along the track through the voxels
+ * (Amanatides & Woo, 1987) and sum up the grammage voxel by voxel, so
+ * Correct finds the displacement in the same pass without iterations.
+ *
+ * The grid is shared between copies of the distribution.
+ */
+class Density_voxel : public Density_distr {
+   public:
+    Density_voxel(std::shared_ptr<const VoxelGrid> grid,
+                  double massDensity,
+                  double outside_scale = 1.);
+    Density_voxel(const std::string& path,
+                  double massDensity,
+                  double outside_scale = 1.);
+    Density_voxel(const nlohmann::json&);
+    Density_voxel(const Density_voxel&) = default;
+
+    bool compare(const Density_distr& dens_distr) const override;
+
+    Density_distr* clone() const override {
+        return new Density_voxel(*this);
+    };
+
+    double Correct(const Vector3D& xi,
+                   const Vector3D& direction,
+                   double res,
+                   double distance_to_border) const override;
+    double Integrate(const Vector3D& xi,
+                     const Vector3D& direction,
+                     double l) const override;
+    double Calculate(const Vector3D& xi,
+                     const Vector3D& direction,
+                     double distance) const override;
+    double Evaluate(const Vector3D& xi) const override;
+
+    //! Medium index of the voxel at xi, -1 outside of the grid or if the
+    //! grid has no medium indices.
+    int GetMediumIndex(const Vector3D& xi) const;
+
+    std::shared_ptr<const VoxelGrid> GetGrid() const { return grid_; }
+    double GetOutsideScale() const { return outside_scale_; }
+
+   private:
+    //! Call f(t_low, t_high, scale) for the pieces of the track between 0
+    //! and t_max with constant scale factor, in this order, until f
+    //! returns false.
+    template <typename Function>
+    void ForEachVoxel(const Vector3D& xi, const Vector3D& direction,
+                      double t_max, Function&& f) const;
+
+    std::shared_ptr<const VoxelGrid> grid_;
+    double outside_scale_;
+};
+}  // namespace PROPOSAL
@@ -43,6 +43,7 @@ public:
 
     // Methods
     std::pair<double, double> DistanceToBorder(const Vector3D& position, const Vector3D& direction) const override;
+    double MinimalDistance(const Vector3D& position) const override;
 
     // Getter & Setter
     double GetX() const { return x_; }
@@ -44,6 +44,22 @@ public:
         enum Enum { InfrontGeometry= 0, InsideGeometry, BehindGeometry };
     };
 
+    /*!
+     * Location of a particle relative to the geometry together with the
+     * distances to the border along its direction.
+     */
+    struct Intersection {
+        ParticleLocation::Enum location;
+        double entry; //!< distance to the entry point, -1 if not in front
+        double exit;  //!< distance to the exit point, -1 if behind
+
+        //! distance to the next border, DistanceToBorder().first
+        double NextBorder() const
+        {
+            return location == ParticleLocation::InfrontGeometry ? entry : exit;
+        }
+    };
+
 public:
     Geometry(const std::string, const Vector3D& position);
     Geometry(const nlohmann::json&);
@@ -84,11 +100,31 @@ public:
      */
     virtual std::pair<double, double> DistanceToBorder(const Vector3D& position, const Vector3D& direction) const = 0;
 
+    /*!
+     * Location of the particle and distances to the border, calculated with
+     * a single evaluation of DistanceToBorder. IsInside, IsInfront,
+     * IsBehind and GetLocation are based on it, so if more than one of them
+     * is needed, the intersection should be used directly.
+     */
+    Intersection Intersect(const Vector3D& position, const Vector3D& direction) const;
+
+    /*!
+     * Classifies the result of DistanceToBorder.
+     */
+    static Intersection Intersect(const std::pair<double, double>& distance);
+
     /*!
      * Calculates the distance to the closest approch to the geometry center
      */
     double DistanceToClosestApproach(const Vector3D& position, const Vector3D& direction) const;
 
+    /*!
+     * Lower bound of the distance between position and the geometry in any
+     * direction, 0 if position is inside. The default implementation returns
+     * 0, which is a valid bound for every geometry.
+     */
+    virtual double MinimalDistance(const Vector3D& position) const;
+
     // void swap(Geometry &geometry);
 
     // ----------------------------------------------------------------- //
@@ -121,9 +157,9 @@ protected:
 } // namespace PROPOSAL
 
 namespace PROPOSAL {
-    enum Geometry_Type : int { SPHERE, BOX, CYLINDER };
+    enum Geometry_Type : int { SPHERE, BOX, CYLINDER, MESH };
 } // namespace PROPOSAL
 
 namespace PROPOSAL {
-    const std::array<std::string, 3>  Geometry_Name = { "sphere", "box", "cylinder" };
+    const std::array<std::string, 4>  Geometry_Name = { "sphere", "box", "cylinder", "mesh" };
 } // namespace PROPOSAL
@@ -34,11 +34,13 @@
 #include "PROPOSAL/geometry/Box.h"
 #include "PROPOSAL/geometry/Cylinder.h"
 #include "PROPOSAL/geometry/Geometry.h"
+#include "PROPOSAL/geometry/Mesh.h"
 #include "PROPOSAL/geometry/Sphere.h"
 
 namespace PROPOSAL {
-static constexpr std::array<Geometry_Type, 3> Geometry_Map
-    = { Geometry_Type::SPHERE, Geometry_Type::BOX, Geometry_Type::CYLINDER };
+static constexpr std::array<Geometry_Type, 4> Geometry_Map
+    = { Geometry_Type::SPHERE, Geometry_Type::BOX, Geometry_Type::CYLINDER,
+          Geometry_Type::MESH };
 } // namespace PROPOSAL
 
 namespace PROPOSAL {
@@ -0,0 +1,90 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "PROPOSAL/geometry/Box.h"
+#include "PROPOSAL/geometry/Cylinder.h"
+#include "PROPOSAL/geometry/Mesh.h"
+#include "PROPOSAL/geometry/Sphere.h"
+
+namespace PROPOSAL {
+
+/*!
+ * Closed set of the built-in geometries for the propagation loop. The type
+ * of the geometry is determined once on construction, afterwards the
+ * DistanceToBorder of the built-in geometries is called directly instead of
+ * through the vtable. Other geometries, including classes derived from the
+ * built-in ones, use the virtual interface of Geometry.
+ * The variant does not own the geometry.
+ */
+class GeometryVariant {
+public:
+    explicit GeometryVariant(const Geometry&);
+
+    std::pair<double, double> DistanceToBorder(
+        const Vector3D& position, const Vector3D& direction) const
+    {
+        switch (type_) {
+        case Type::Sphere:
+            return static_cast<const Sphere*>(geometry_)
+                ->Sphere::DistanceToBorder(position, direction);
+        case Type::Box:
+            return static_cast<const Box*>(geometry_)
+                ->Box::DistanceToBorder(position, direction);
+        case Type::Cylinder:
+            return static_cast<const Cylinder*>(geometry_)
+                ->Cylinder::DistanceToBorder(position, direction);
+        case Type::Mesh:
+            return static_cast<const Mesh*>(geometry_)
+                ->Mesh::DistanceToBorder(position, direction);
+        case Type::Other:
+            break;
+        }
+        return geometry_->DistanceToBorder(position, direction);
+    }
+
+    //! Same as Geometry::Intersect.
+    Geometry::Intersection Intersect(
+        const Vector3D& position, const Vector3D& direction) const
+    {
+        return Geometry::Intersect(DistanceToBorder(position, direction));
+    }
+
+    unsigned int GetHierarchy() const { return geometry_->GetHierarchy(); }
+    const Geometry& GetGeometry() const { return *geometry_; }
+
+private:
+    enum class Type { Sphere, Box, Cylinder, Mesh, Other };
+
+    const Geometry* geometry_;
+    Type type_;
+};
+
+} // namespace PROPOSAL
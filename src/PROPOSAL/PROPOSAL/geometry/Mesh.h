@@ -0,0 +1,102 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "PROPOSAL/geometry/Geometry.h"
+
+namespace PROPOSAL {
+
+/*!
+ * Closed triangle mesh, e.g. a terrain model or a detector housing. The
+ * vertices are given relative to the position of the geometry. The mesh has
+ * to be closed and its triangles consistently oriented; the orientation is
+ * flipped on construction if the normals point inwards.
+ *
+ * The triangles are stored in a bounding volume hierarchy built with the
+ * surface area heuristic, so a ray intersection only tests a logarithmic
+ * number of triangles. Whether a position is inside is taken from the
+ * orientation of the first triangle hit in direction of the trajectory.
+ */
+class Mesh : public Geometry
+{
+public:
+    using Vertex = std::array<double, 3>;
+    using Face = std::array<size_t, 3>;
+
+    Mesh(const Vector3D& position, const std::vector<Vertex>& vertices, const std::vector<Face>& faces);
+    /*!
+     * Read the mesh from an OBJ, STL (ascii or binary) or PLY (ascii or
+     * binary little endian) file. The coordinates are multiplied by scale.
+     */
+    Mesh(const Vector3D& position, const std::string& path, double scale = 1.);
+    Mesh(const nlohmann::json& config);
+
+    // Methods
+    std::pair<double, double> DistanceToBorder(const Vector3D& position, const Vector3D& direction) const override;
+    double MinimalDistance(const Vector3D& position) const override;
+
+    // Getter
+    size_t GetNumberOfTriangles() const { return triangles_.size(); }
+    size_t GetNumberOfNodes() const { return nodes_.size(); }
+
+private:
+    struct Triangle {
+        Vertex v0, e1, e2; //!< first vertex and edges to the other vertices
+    };
+
+    struct Node {
+        Vertex lower, upper;
+        uint32_t offset; //!< first triangle of a leaf, second child otherwise
+        uint32_t count;  //!< number of triangles, 0 for inner nodes
+    };
+
+    struct Hit {
+        double distance;
+        bool leaving;
+    };
+
+    void Init(std::vector<Vertex> vertices, const std::vector<Face>& faces);
+    uint32_t Build(std::vector<Triangle>& triangles, std::vector<size_t>& indices,
+        const std::vector<Vertex>& centroids, size_t first, size_t count, size_t depth);
+
+    //! Closest intersection with a distance larger than min_distance.
+    bool IntersectBVH(const Vertex& origin, const Vertex& direction, double min_distance, Hit& hit) const;
+
+    bool compare(const Geometry&) const override;
+    void print(std::ostream&) const override;
+
+    std::vector<Triangle> triangles_;
+    std::vector<Node> nodes_;
+};
+
+} // namespace PROPOSAL
@@ -0,0 +1,57 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace PROPOSAL {
+
+// ----------------------------------------------------------------------------
+/// @brief Walker alias table to sample from a discrete distribution
+///
+/// The table is built in O(n) from arbitrary non-negative weights. Sampling
+/// is O(1) and needs a single random number. The fraction of the random
+/// number which is not required to select the index is returned rescaled to
+/// [0, 1), so it can be used for further sampling.
+// ----------------------------------------------------------------------------
+class AliasTable {
+    std::vector<double> probability_;
+    std::vector<size_t> alias_;
+
+public:
+    AliasTable() = default;
+    AliasTable(std::vector<double> const& weights);
+
+    std::pair<size_t, double> Sample(double rnd) const;
+
+    size_t GetSize() const noexcept { return probability_.size(); }
+    bool Empty() const noexcept { return probability_.empty(); }
+};
+} // namespace PROPOSAL
@@ -1,10 +1,16 @@
 #pragma once
 #include "PROPOSAL/math/Vector3D.h"
+#include <cmath>
 #include <nlohmann/json_fwd.hpp>
 
 namespace PROPOSAL{
     class Spherical3D;
-    class Cartesian3D : public Vector3D {
+    /*!
+     * Cartesian vectors are the vectors the propagation works with. The
+     * class is final and its arithmetic is defined inline, so calls on a
+     * Cartesian3D do not go through the virtual interface of Vector3D.
+     */
+    class Cartesian3D final : public Vector3D {
     public:
         Cartesian3D() = default;
         Cartesian3D(std::array<double, 3> val) : Vector3D(val) {};
@@ -29,13 +35,70 @@ namespace PROPOSAL{
         friend Cartesian3D vector_product(const Cartesian3D&, const Cartesian3D&);
 
         void deflect(double, double);
-        double magnitude() const override;
-        void normalize() override;
-        std::array<double, 3> GetCartesianCoordinates() const override;
+        double magnitude() const override
+        {
+            return std::sqrt(coordinates[0] * coordinates[0]
+                + coordinates[1] * coordinates[1]
+                + coordinates[2] * coordinates[2]);
+        }
+        void normalize() override
+        {
+            auto length = magnitude();
+            for (size_t i = 0; i < 3; i++)
+                coordinates[i] /= length;
+        }
+        std::array<double, 3> GetCartesianCoordinates() const override
+        {
+            return coordinates;
+        }
         std::array<double, 3> GetSphericalCoordinates() const override;
 
     protected:
         void print(std::ostream&) const override;
     };
 
+    inline Cartesian3D operator+(const Cartesian3D& lhs, const Cartesian3D& rhs)
+    {
+        return Cartesian3D(lhs[0] + rhs[0], lhs[1] + rhs[1], lhs[2] + rhs[2]);
+    }
+
+    inline Cartesian3D operator-(const Cartesian3D& lhs, const Cartesian3D& rhs)
+    {
+        return Cartesian3D(lhs[0] - rhs[0], lhs[1] - rhs[1], lhs[2] - rhs[2]);
+    }
+
+    inline double operator*(const Cartesian3D& lhs, const Cartesian3D& rhs)
+    {
+        return lhs[0] * rhs[0] + lhs[1] * rhs[1] + lhs[2] * rhs[2];
+    }
+
+    inline Cartesian3D operator*(const Cartesian3D& lhs, double val)
+    {
+        return Cartesian3D(lhs[0] * val, lhs[1] * val, lhs[2] * val);
+    }
+
+    inline Cartesian3D operator*(double val, const Cartesian3D& rhs)
+    {
+        return rhs * val;
+    }
+
+    inline Cartesian3D Cartesian3D::operator-() const
+    {
+        return Cartesian3D(-coordinates[0], -coordinates[1], -coordinates[2]);
+    }
+
+    inline Cartesian3D& Cartesian3D::operator+=(const Cartesian3D& rhs)
+    {
+        for (size_t i = 0; i < 3; i++)
+            coordinates[i] += rhs[i];
+        return *this;
+    }
+
+    inline Cartesian3D vector_product(const Cartesian3D& lhs, const Cartesian3D& rhs)
+    {
+        return Cartesian3D(lhs.GetY() * rhs.GetZ() - lhs.GetZ() * rhs.GetY(),
+            lhs.GetZ() * rhs.GetX() - lhs.GetX() * rhs.GetZ(),
+            lhs.GetX() * rhs.GetY() - lhs.GetY() * rhs.GetX());
+    }
+
 } // namespace PROPOSAL
@@ -108,6 +108,26 @@ double dilog(double x);
 double NewtonRaphson(std::function<double(double)> f, std::function<double(double)> df, double x1, double x2,
         double xinit, int MAX_STEPS = 101, double xacc = 1.e-6);
 
+/// @brief Real roots of the polynomial p(x) = sum_k coefficients[k] x^k,
+///        calculated in closed form. Only polynomials up to degree three are
+///        supported.
+/// @param coefficients coefficients of p, starting with the lowest order
+/// @return real roots of p in ascending order
+
+std::vector<double> PolynomialRoots(std::vector<double> coefficients);
+
+/// @brief Solves p(x) = y for the polynomial p(x) = sum_k coefficients[k] x^k
+/// @param x1   x where the search starts
+/// @param x2   x where the search ends, can be smaller than x1
+/// @return root inside the interval [x1, x2] closest to x1. Up to degree
+///         three, the roots are calculated in closed form. For higher degrees,
+///         the NewtonRaphson method is used, which requires p(x) - y to change
+///         its sign in the interval. Throws a MathException if there is no
+///         root.
+
+double SolvePolynomial(const std::vector<double>& coefficients, double y,
+        double x1, double x2);
+
 // from stackoverflow https://stackoverflow.com/a/4609795/8227894
 template <typename T> int sgn(T val) {
     return (T(0) < val) - (val < T(0));
@@ -4,7 +4,7 @@
 
 namespace PROPOSAL  {
     class Cartesian3D;
-    class Spherical3D : public Vector3D {
+    class Spherical3D final : public Vector3D {
     public:
         Spherical3D() : Vector3D() {};
         Spherical3D(std::array<double, 3> val) : Vector3D(val) {};
@@ -21,10 +21,13 @@ namespace PROPOSAL  {
         void SetAzimuth(double azimuth) {coordinates[Azimuth] = azimuth;}
         void SetZenith(double zenith) {coordinates[Zenith] = zenith;}
 
-        double magnitude() const override;
-        void normalize() override;
+        double magnitude() const override { return GetRadius(); }
+        void normalize() override { SetRadius(1.); }
         std::array<double, 3> GetCartesianCoordinates() const override;
-        std::array<double, 3> GetSphericalCoordinates() const override;
+        std::array<double, 3> GetSphericalCoordinates() const override
+        {
+            return coordinates;
+        }
 
         enum SphericalCoordinate : int {
             Radius = 0,
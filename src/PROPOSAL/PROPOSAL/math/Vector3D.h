@@ -38,10 +38,13 @@ public:
     Vector3D(std::array<double, 3> val) : coordinates(val) {};
     virtual ~Vector3D() = default;
 
-    virtual bool operator==(const Vector3D&) const;
-    virtual bool operator!=(const Vector3D&) const;
-    double& operator[](size_t idx);
-    const double& operator[](size_t idx) const;
+    bool operator==(const Vector3D& rhs) const
+    {
+        return coordinates == rhs.coordinates;
+    }
+    bool operator!=(const Vector3D& rhs) const { return !(*this == rhs); }
+    double& operator[](size_t idx) { return coordinates[idx]; }
+    const double& operator[](size_t idx) const { return coordinates[idx]; }
     friend std::ostream& operator<<(std::ostream&, const Vector3D&);
 
     virtual double magnitude() const = 0;
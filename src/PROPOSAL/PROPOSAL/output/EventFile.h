@@ -0,0 +1,189 @@
+#pragma once
+
+#include "PROPOSAL/particle/Particle.h"
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace PROPOSAL {
+class Secondaries;
+
+/**
+ * Receives the track points of one event during propagation and keeps only
+ * what is written to an event file: the initial and final state, the
+ * stochastic losses and, optionally, the full track. It is passed to
+ * Propagator::Propagate instead of a Secondaries object and can be reused
+ * for the next event after clear().
+ */
+class EventRecord {
+public:
+    explicit EventRecord(bool store_track = false)
+        : store_track(store_track)
+    {
+    }
+
+    void push_back(const ParticleState& point, const InteractionType& type,
+        const size_t& target_hash = 0);
+    void clear();
+
+    bool store_track;
+    size_t n_points = 0;
+    ParticleState initial_state;
+    ParticleState final_state;
+    bool decayed = false;
+    std::vector<StochasticLoss> losses;
+    std::vector<ParticleState> track;
+    std::vector<InteractionType> track_types;
+};
+
+/**
+ * Columnar storage of consecutive events, starting with the event
+ * first_event. The losses of event i are stored at
+ * [loss_offsets[i], loss_offsets[i + 1]) of the loss columns, the track
+ * points accordingly at track_offsets. The track columns are empty if the
+ * tracks are not stored.
+ */
+struct EventChunk {
+    EventChunk() { clear(); }
+
+    void Append(const EventRecord&);
+    void Append(const Secondaries&, bool store_track = false);
+    size_t size() const { return final_energy.size(); }
+    void clear();
+
+    uint64_t first_event = 0;
+
+    // one entry per event
+    std::vector<double> initial_energy;
+    std::vector<double> final_energy;
+    std::vector<double> final_x, final_y, final_z;
+    std::vector<double> final_time;
+    std::vector<double> propagated_distance;
+    std::vector<uint8_t> decayed;
+    std::vector<double> final_weight;
+    std::vector<uint64_t> loss_offsets;
+    std::vector<uint64_t> track_offsets;
+
+    // one entry per stochastic loss
+    std::vector<int32_t> loss_type;
+    std::vector<double> loss_energy;
+    std::vector<double> loss_parent_energy;
+    std::vector<double> loss_x, loss_y, loss_z;
+    std::vector<double> loss_time;
+    std::vector<double> loss_distance;
+    std::vector<uint64_t> loss_target_hash;
+    std::vector<double> loss_weight;
+
+    // one entry per track point
+    std::vector<int32_t> track_type;
+    std::vector<double> track_energy;
+    std::vector<double> track_x, track_y, track_z;
+    std::vector<double> track_dx, track_dy, track_dz;
+    std::vector<double> track_time;
+    std::vector<double> track_distance;
+    std::vector<double> track_weight;
+};
+
+/**
+ * Header of an event file. The schema is a json description of the
+ * columns of a chunk, in the order they are stored. All values of the
+ * file are stored in little-endian byte order.
+ */
+struct EventFileHeader {
+    static constexpr uint32_t MAGIC = 0x56455050; // "PPEV"
+    static constexpr uint32_t VERSION = 2;
+
+    uint32_t version = VERSION;
+    uint64_t config_hash = 0;
+    int32_t particle_type = 0;
+    bool has_tracks = false;
+    std::string schema;
+};
+
+/**
+ * Writes chunks of events to a binary file. Write can be called from
+ * several threads. In ordered mode, chunks which arrive before their
+ * predecessors are held back until all previous events have been written,
+ * so the events in the file are sorted by their id. This requires the
+ * chunks to cover all events without gaps, starting at first_event. Write
+ * throws on a chunk with events that have already been written or that
+ * overlap a held back chunk. At most max_pending chunks are held back,
+ * Write throws if a further chunk would have to wait. In unordered mode,
+ * every chunk is written directly.
+ */
+class EventWriter {
+public:
+    EventWriter(const std::string& path, uint64_t config_hash,
+        int32_t particle_type = 0, bool write_tracks = false,
+        bool ordered = true, uint64_t first_event = 0,
+        size_t max_pending = 256);
+    ~EventWriter();
+
+    /**
+     * Continue writing an existing event file. The chunks written from now
+     * on start at first_event, the header of the file is kept. Only files
+     * of the current version can be continued.
+     */
+    static std::unique_ptr<EventWriter> Append(const std::string& path,
+        uint64_t first_event, bool ordered = true, size_t max_pending = 256);
+
+    void Write(EventChunk chunk);
+
+    /**
+     * Flush the written chunks to disk and return the size of the file.
+     * Chunks held back in ordered mode are not included.
+     */
+    uint64_t Flush();
+
+    /**
+     * Close the file. Throws if chunks are still held back in ordered mode,
+     * i.e. if events are missing. The held back chunks are not written.
+     */
+    void Close();
+
+    bool WritesTracks() const { return header_.has_tracks; }
+    uint64_t EventsWritten() const;
+    size_t GetMaxPending() const { return max_pending_; }
+
+private:
+    EventWriter(const std::string& path, bool ordered, uint64_t first_event,
+        size_t max_pending);
+
+    void WriteChunk(const EventChunk&);
+
+    std::ofstream file_;
+    EventFileHeader header_;
+    bool ordered_;
+    size_t max_pending_;
+    uint64_t next_event_;
+    uint64_t events_written_ = 0;
+    std::map<uint64_t, EventChunk> pending_;
+    mutable std::mutex mutex_;
+};
+
+/**
+ * Reads the chunks of a file written by EventWriter one after another.
+ * Files of version 1 have no weight columns, their weights are read as 1.
+ */
+class EventReader {
+public:
+    explicit EventReader(const std::string& path);
+
+    const EventFileHeader& GetHeader() const { return header_; }
+
+    /**
+     * Read the next chunk. Returns false if the end of the file is reached.
+     */
+    bool ReadChunk(EventChunk& chunk);
+
+private:
+    std::ifstream file_;
+    EventFileHeader header_;
+};
+
+} // namespace PROPOSAL
@@ -108,6 +108,7 @@ public:
     double energy;                 //!< energy [MeV]
     double time;                   //!< age [sec]
     double propagated_distance;    //!< propagation distance [cm]
+    double weight = 1.;            //!< statistical weight of biased sampling
 
     void SetType(ParticleType particle_type) { type = static_cast<int>(particle_type); }
     void SetMomentum(double momentum);
@@ -128,12 +129,13 @@ struct Loss {
 };
 
 struct StochasticLoss : public Loss {
-    StochasticLoss(int, double, const Vector3D&, const Vector3D&, double, double, double, size_t = 0);
+    StochasticLoss(int, double, const Vector3D&, const Vector3D&, double, double, double, size_t = 0, double = 1.);
     Cartesian3D position;
     Cartesian3D direction;
     double time;
     double propagated_distance;
     size_t target_hash;
+    double weight; //!< event weight after the interaction
 };
 
 struct ContinuousLoss : public Loss {
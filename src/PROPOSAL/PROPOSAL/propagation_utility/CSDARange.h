@@ -0,0 +1,38 @@
+#pragma once
+
+#include "PROPOSAL/Constants.h"
+
+#include <vector>
+
+namespace PROPOSAL {
+class Displacement;
+} // namespace PROPOSAL
+
+namespace PROPOSAL {
+/**
+ * Continuous slowing down range of a particle in one sector, i.e. the
+ * grammage it can traverse with only continuous losses until it reaches the
+ * lower energy limit of the displacement. The range is tabulated from the
+ * displacement integral on a logarithmic energy grid.
+ */
+class CSDARange {
+    double lower_lim;
+    double log_lower;
+    double log_step;
+    std::vector<double> grammage;
+
+public:
+    CSDARange(Displacement&,
+        double upper_lim = InterpolationSettings::UPPER_ENERGY_LIM,
+        size_t nodes = 200);
+
+    /**
+     * Upper bound of the range in g/cm^2. The range of the next node above
+     * energy is returned, so the range is never underestimated. INF is
+     * returned for energies above the upper limit of the table.
+     */
+    double GetGrammage(double energy) const;
+
+    double GetLowerLim() const noexcept { return lower_lim; }
+};
+} // namespace PROPOSAL
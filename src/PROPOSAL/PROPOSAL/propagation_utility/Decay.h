@@ -20,6 +20,10 @@ public:
     virtual ~Decay() = default;
 
     virtual double EnergyDecay(double, double, double) = 0;
+
+    //! probability that the particle does not decay between the energies
+    //! E_i and E_f in a medium of the given density
+    virtual double SurvivalProbability(double E_i, double E_f, double density) = 0;
     double FunctionToIntegral(double energy);
 
     auto GetHash() const noexcept { return hash; }
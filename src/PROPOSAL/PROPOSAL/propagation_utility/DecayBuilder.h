@@ -17,6 +17,7 @@ public:
     DecayBuilder(disp_ptr, double, double, std::false_type);
 
     double EnergyDecay(double energy, double rnd, double density) override;
+    double SurvivalProbability(double E_i, double E_f, double density) override;
 };
 
 std::unique_ptr<Decay> make_decay(
@@ -3,6 +3,8 @@
 #include <memory>
 #include <vector>
 
+#include "PROPOSAL/math/AliasTable.h"
+
 namespace PROPOSAL {
 struct CrossSectionBase;
 class Component;
@@ -23,6 +25,25 @@ protected:
 
     double calculate_total_rate(double energy) const;
 
+    // Tables for the binned sampling mode. For every energy node, the
+    // channel (crosssection and component) is drawn from an alias table.
+    // The relative loss is drawn from an alias table over bins which are
+    // equidistant in log(v) between the smallest and largest possible loss.
+    struct BinnedChannel {
+        cross_ptr crosssection;
+        size_t comp_hash;
+    };
+    struct BinnedNode {
+        AliasTable channel_table;
+        std::vector<AliasTable> loss_tables;
+        std::vector<double> log_v_low;
+        std::vector<double> log_v_up;
+    };
+    std::vector<BinnedChannel> binned_channels;
+    std::vector<BinnedNode> binned_nodes;
+    double binned_log_energy_low;
+    double binned_log_energy_step;
+
 public:
     Interaction(std::shared_ptr<Displacement>, crosssection_list_t const&);
     virtual ~Interaction() = default;
@@ -46,6 +67,21 @@ public:
     };
     Loss SampleLoss(double energy, std::vector<Rate> const& rates, double rnd);
 
+    //! Precompute the tables for the binned sampling mode. The energy range
+    //! between the lower limit of the displacement and the upper energy
+    //! limit of the interpolation tables is divided into bins_per_decade
+    //! nodes per decade, the relative loss into loss_bins bins per channel.
+    void BuildBinnedSampling(size_t bins_per_decade = 20,
+        size_t loss_bins = 100);
+    bool HasBinnedSampling() const noexcept { return !binned_nodes.empty(); }
+
+    //! Approximate sampling of a stochastic loss using the tables build by
+    //! BuildBinnedSampling. One of the two neighbouring energy nodes is chosen
+    //! randomly, weighted by the distance in log(E). The first random number
+    //! is used for the node and channel, the second one for the loss. Falls
+    //! back to SampleLoss if no tables are available for this energy.
+    Loss SampleLossBinned(double energy, double rnd1, double rnd2);
+
     virtual double MeanFreePath(double) = 0;
 
     auto GetHash() const noexcept { return hash; }
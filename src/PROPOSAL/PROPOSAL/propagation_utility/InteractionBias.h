@@ -0,0 +1,55 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace PROPOSAL {
+struct CrossSectionBase;
+class Displacement;
+class Interaction;
+enum class InteractionType;
+}
+
+namespace PROPOSAL {
+/**
+ * Weight correction for crosssections with an enhanced interaction rate
+ * (CrossSectionBias). The particle is propagated with the biased
+ * crosssections, the ratio of the true and the biased probability density
+ * of every step is collected into the weight of the particle state.
+ * Between two stochastic interactions, this is the ratio of the survival
+ * probabilities, exp(I_biased - I_true) with the interaction integrals I
+ * over the continuous energy loss. At an interaction, it is the ratio of
+ * the true and the biased rate of the sampled process, i.e. 1 / bias.
+ */
+class InteractionBias {
+    std::shared_ptr<Interaction> biased;
+    std::shared_ptr<Interaction> unbiased;
+    std::map<InteractionType, double> bias;
+
+public:
+    InteractionBias(std::shared_ptr<Interaction> biased,
+        std::shared_ptr<Interaction> unbiased,
+        std::map<InteractionType, double> bias);
+
+    //! weight factor of a continuous step from E_i to E_f without interaction
+    double WeightContinuous(double E_i, double E_f) const;
+
+    //! weight factor of a stochastic interaction of the given type
+    double WeightStochastic(InteractionType) const;
+
+    double GetBias(InteractionType) const;
+};
+} // namespace PROPOSAL
+
+namespace PROPOSAL {
+/**
+ * Creates the weight correction for the given crosssections and the
+ * interaction calculator which samples them. The unbiased interaction
+ * integral is build from the crosssections wrapped by CrossSectionBias.
+ * Returns nullptr if no crosssection is biased.
+ */
+std::unique_ptr<InteractionBias> make_interaction_bias(
+    std::shared_ptr<Interaction> biased, std::shared_ptr<Displacement>,
+    std::vector<std::shared_ptr<CrossSectionBase>> const&, bool interpolate);
+} // namespace PROPOSAL
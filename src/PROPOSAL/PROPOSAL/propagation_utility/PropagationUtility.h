@@ -40,6 +40,7 @@ class Displacement;
 class Time;
 class Scattering;
 class Decay;
+class InteractionBias;
 struct ContRand;
 class Vector3D;
 enum class InteractionType;
@@ -62,11 +63,13 @@ public:
         std::shared_ptr<Scattering> scattering;
         std::shared_ptr<Decay> decay_calc;
         std::shared_ptr<ContRand> cont_rand;
+        std::shared_ptr<InteractionBias> bias;
     };
 
     PropagationUtility(Collection const& collection);
 
     Interaction::Loss EnergyStochasticloss(double, double);
+    Interaction::Loss EnergyStochasticloss(double, std::function<double()>);
     double EnergyDecay(double, std::function<double()>, double);
     double EnergyInteraction(double, std::function<double()>);
     double EnergyRandomize(double, double, std::function<double()>, double);
@@ -74,6 +77,30 @@ public:
     double LengthContinuous(double, double);
     double TimeElapsed(double, double, double, double);
 
+    // Weight factors of a continuous step and a stochastic interaction if
+    // crosssections are biased, 1 otherwise.
+    double WeightContinuous(double, double) const;
+    double WeightStochastic(InteractionType) const;
+
+    // Energy of a stochastic interaction forced to happen before the energy
+    // E_f is reached, sampled from the free path distribution truncated at
+    // E_f. The second value is the probability of an interaction before E_f,
+    // the weight has to be multiplied with.
+    std::pair<double, double> EnergyForcedInteraction(
+        double, double, std::function<double()>);
+
+    // Adjoint propagation, see Propagator::PropagateAdjoint. The energies
+    // increase along the backward path. The energies are INF if they are
+    // above the upper limit of the interpolation tables.
+    struct AdjointLoss {
+        Interaction::Loss loss; //!< v_loss relative to the energy before the loss
+        double weight;
+    };
+    double EnergyAdjointInteraction(double, std::function<double()>);
+    double EnergyAdjointDistance(double, double);
+    AdjointLoss EnergyAdjointStochasticloss(double, std::function<double()>);
+    double WeightAdjointContinuous(double, double, double);
+
     // TODO: return value doesn't tell what it include. Maybe it would be better
     // to give a tuple of two directions back. One is the mean over the
     // displacement and the other is the actual direction. With a get method
@@ -32,9 +32,9 @@
 #include <string>
 
 namespace PROPOSAL {
+// The integrator is created for every call, so that a UtilityIntegral can be
+// used from several threads.
 class UtilityIntegral {
-    Integral integral;
-
 protected:
     double lower_lim;
     std::function<double(double)> FunctionToIntegral;
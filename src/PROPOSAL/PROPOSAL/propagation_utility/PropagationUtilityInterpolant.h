@@ -34,6 +34,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace PROPOSAL {
 class Integral;
@@ -48,6 +49,17 @@ class UtilityInterpolant : public UtilityIntegral {
     interpolant_ptr interpolant_;
     bool reverse_;
 
+    // Inverse of the interpolant on the nodes of the forward table. ln(E) is
+    // stored as a function of the integral (with negative sign if reverse_,
+    // so that the integral is rising with energy) together with its
+    // derivative. Empty if the integral is not strictly monotonic.
+    std::vector<double> inverse_integral_;
+    std::vector<double> inverse_log_energy_;
+    std::vector<double> inverse_derivative_;
+
+    void BuildInverse(size_t nodes);
+    double EvaluateInverse(double integral) const;
+
     // maybe interpolate function to integral will give a performance boost.
     // in general this function should be underfrequently called
     // Interpolant1DBuilder builder_diff;
@@ -43,7 +43,8 @@ namespace multiple_scattering {
         bool compare(const Parametrization&) const override;
         void print(std::ostream&) const override;
 
-        std::unique_ptr<Parametrization> clone() const final
+    protected:
+        std::unique_ptr<Parametrization> clone() const override
         {
             return std::make_unique<Moliere>(*this);
         }
@@ -58,21 +59,25 @@ namespace multiple_scattering {
         int max_weight_index_; // index of the maximium of mass weights of
                                // different components
 
-        // scattering parameters
-        double chiCSq_; // characteristic angle² in rad²
-        std::vector<double> B_;
+        // scattering parameters of one step, kept local to the call so that
+        // the parametrization can be shared between threads
+        struct StepParameters {
+            double chiCSq; // characteristic angle² in rad²
+            std::vector<double> B;
+        };
 
-        double f1M(double x);
-        double f2M(double x);
+        double f1M(double x) const;
+        double f2M(double x) const;
 
-        double f(double theta);
+        double f(double theta, const StepParameters&) const;
 
-        double F1M(double x);
-        double F2M(double x);
+        double F1M(double x) const;
+        double F2M(double x) const;
 
-        double F(double theta);
+        double F(double theta, const StepParameters&) const;
 
-        double GetRandom(double pre_factor, double rnd);
+        virtual double GetRandom(
+            const StepParameters&, double pre_factor, double rnd) const;
 
     public:
         // constructor
@@ -0,0 +1,89 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "CubicInterpolation/BicubicSplines.h"
+#include "CubicInterpolation/Interpolant.h"
+
+#include "PROPOSAL/scattering/multiple_scattering/Moliere.h"
+
+namespace PROPOSAL {
+namespace multiple_scattering {
+
+    //!
+    //! Moliere scattering with a tabulated inverse cumulative distribution.
+    //! The angle is sampled in units of sqrt(chi_c^2 * B) of the component
+    //! with maximum weight. In these reduced variables the distribution only
+    //! depends on B of this component and the differences of the screening
+    //! angles of the medium components, which are fixed for beta -> 1. The
+    //! table is therefore built once per medium over (B, rnd). If the
+    //! requested parameters are not covered by the table, the sampling falls
+    //! back to the Newton-Raphson method of Moliere.
+    //!
+    class MoliereInterpol : public Moliere {
+        using interpolant_t
+            = cubic_splines::Interpolant<cubic_splines::BicubicSplines<double>>;
+
+        std::shared_ptr<interpolant_t> inverse_cdf_;
+
+        // B_i - ln(B_i) - (B_ref - ln(B_ref)) for beta -> 1
+        std::vector<double> offsets_;
+        double B_min_;
+
+        double GetRandom(const StepParameters&, double pre_factor,
+            double rnd) const override;
+
+        double CalculateB(double B_ref, double offset) const;
+        double CalculateReducedAngle(double B_ref, double s) const;
+        void BuildTables(Medium const&);
+
+    public:
+        static constexpr double B_MAX = 100.;
+        static constexpr double S_MAX = 14.;
+        static constexpr size_t NODES_B = 100;
+        static constexpr size_t NODES_RND = 200;
+
+        MoliereInterpol(const ParticleDef&, Medium const&);
+
+        std::unique_ptr<Parametrization> clone() const override
+        {
+            return std::make_unique<MoliereInterpol>(*this);
+        }
+    };
+} // namespace multiple_scattering
+
+template <typename... Args> inline auto make_moliere_interpol(Args... args)
+{
+    return std::unique_ptr<multiple_scattering::Parametrization>(
+        new multiple_scattering::MoliereInterpol(std::forward<Args>(args)...));
+}
+
+} // namespace PROPOSAL
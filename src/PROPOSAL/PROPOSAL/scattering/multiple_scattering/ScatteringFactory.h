@@ -44,18 +44,21 @@
 #include "PROPOSAL/scattering/multiple_scattering/Highland.h"
 #include "PROPOSAL/scattering/multiple_scattering/HighlandIntegral.h"
 #include "PROPOSAL/scattering/multiple_scattering/Moliere.h"
+#include "PROPOSAL/scattering/multiple_scattering/MoliereInterpol.h"
 
 namespace PROPOSAL {
 
 enum class MultipleScatteringType : int {
     NoScattering,
     Moliere,
+    MoliereInterpol,
     Highland,
     HighlandIntegral
 };
 
 static const std::unordered_map<std::string, MultipleScatteringType>
     MultipleScatteringTable = { { "moliere", MultipleScatteringType::Moliere },
+        { "moliereinterpol", MultipleScatteringType::MoliereInterpol },
         { "highland", MultipleScatteringType::Highland },
         { "highlandintegral", MultipleScatteringType::HighlandIntegral },
         { "noscattering", MultipleScatteringType::NoScattering } };
@@ -68,6 +71,8 @@ inline auto make_multiple_scattering(
         return make_highland(p, m);
     case MultipleScatteringType::Moliere:
         return make_moliere(p, m);
+    case MultipleScatteringType::MoliereInterpol:
+        return make_moliere_interpol(p, m);
     case MultipleScatteringType::NoScattering:
         return std::unique_ptr<multiple_scattering::Parametrization>(nullptr);
     default:
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "PROPOSAL/DefaultFactory.h"
+#include "PROPOSAL/secondaries/Thinning.h"
 #include "PROPOSAL/secondaries/parametrization/Parametrization.h"
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -24,6 +26,8 @@ class SecondariesCalculator {
     std::unordered_map<InteractionType, param_ptr, InteractionType_hash>
         secondary_generator;
 
+    std::shared_ptr<const Thinning> thinning;
+
 public:
     //!
     //! Empty secondaries calculator. Parametrization has to be added by
@@ -61,12 +65,27 @@ public:
         return secondary_generator.find(type)->second->RequiredRandomNumbers();
     }
 
+    //!
+    //! Thin the calculated secondaries, e.g. with a different thinning for
+    //! every medium. A nullptr disables the thinning.
+    //!
+    inline void SetThinning(std::shared_ptr<const Thinning> t)
+    {
+        thinning = std::move(t);
+    }
+
     //!
     //! Calculates the secondary particle for a given loss. Initial particle is
     //! treated as a loss and returned as the first particle of the secondaries.
+    //! The secondaries carry the weight of the loss. If a thinning is set, it
+    //! is applied with random numbers of rnd_thinning to all but the first
+    //! particle. Without rnd_thinning the RandomGenerator is used.
     //!
     std::vector<ParticleState> CalculateSecondaries(
         StochasticLoss, Component const&, std::vector<double>&);
+    std::vector<ParticleState> CalculateSecondaries(StochasticLoss,
+        Component const&, std::vector<double>&,
+        std::function<double()> rnd_thinning);
 };
 
 //!
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "PROPOSAL/Constants.h"
+#include "PROPOSAL/particle/Particle.h"
+#include "PROPOSAL/particle/ParticleDef.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace PROPOSAL {
+
+//!
+//! Weighted thinning of secondary particle lists. Particles are removed
+//! randomly and the weights of the surviving particles are increased, so
+//! that weighted sums over the particles are unbiased. Three methods can be
+//! combined, they are applied in this order:
+//!
+//! - Russian roulette: particles of a type below its energy threshold
+//!   survive with a fixed probability.
+//! - Hillas thinning with the thinning energy E_thin: if the parent energy
+//!   is above E_thin, every particle below E_thin survives with the
+//!   probability E / E_thin. Otherwise only one of the particles survives,
+//!   chosen with a probability proportional to its energy.
+//! - Weight window: particles with a weight below the window play russian
+//!   roulette with the survival weight, particles above the window are
+//!   split into copies inside the window.
+//!
+//! Hillas thinning and weight windows only act on the thinned types, by
+//! default electrons, positrons and photons.
+//!
+class Thinning {
+public:
+    Thinning(std::vector<ParticleType> thinned_types
+        = { ParticleType::EMinus, ParticleType::EPlus, ParticleType::Gamma });
+
+    //!
+    //! Particles of the given type with an energy below threshold survive
+    //! with survival_probability.
+    //!
+    void SetRoulette(
+        ParticleType type, double threshold, double survival_probability);
+
+    //!
+    //! Hillas thinning with the given thinning energy, 0 disables it.
+    //!
+    void SetHillasThinning(double thinning_energy);
+
+    //!
+    //! Weights are kept in [lower, upper], particles below lower survive
+    //! with the weight survival.
+    //!
+    void SetWeightWindow(double lower, double upper, double survival);
+
+    //!
+    //! Thin the particles produced by a parent with parent_energy. The
+    //! weights of the surviving particles are corrected.
+    //!
+    std::vector<ParticleState> Apply(std::vector<ParticleState> particles,
+        std::function<double()> rnd, double parent_energy = INF) const;
+
+private:
+    struct Roulette {
+        double threshold;
+        double survival_probability;
+    };
+
+    bool IsThinned(const ParticleState&) const;
+    void HillasThinning(std::vector<ParticleState>&, std::function<double()>&,
+        double parent_energy) const;
+    void WeightWindow(
+        std::vector<ParticleState>&, std::function<double()>&) const;
+
+    std::vector<ParticleType> thinned_types;
+    std::unordered_map<ParticleType, Roulette, ParticleType_hash> roulette;
+    double thinning_energy = 0.;
+    double window_lower = 0.;
+    double window_upper = INF;
+    double window_survival = 1.;
+};
+
+} // namespace PROPOSAL
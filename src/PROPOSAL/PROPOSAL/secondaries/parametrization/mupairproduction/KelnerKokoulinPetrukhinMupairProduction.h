@@ -5,23 +5,52 @@
 #include "PROPOSAL/medium/Medium.h"
 #include "PROPOSAL/secondaries/parametrization/mupairproduction/MupairProduction.h"
 
+#include "CubicInterpolation/Axis.h"
+#include "CubicInterpolation/BicubicSplines.h"
+#include "CubicInterpolation/Interpolant.h"
+
+#include <unordered_map>
+
 namespace PROPOSAL {
 namespace secondaries {
     class KelnerKokoulinPetrukhinMupairProduction
         : public secondaries::MupairProduction,
           public DefaultSecondaries<KelnerKokoulinPetrukhinMupairProduction> {
 
+        using interpolant_t = cubic_splines::Interpolant<
+            cubic_splines::BicubicSplines<double>>;
+        using rho_slices_t = std::vector<std::unique_ptr<interpolant_t>>;
+
         crosssection::MupairKelnerKokoulinPetrukhin param;
         Integral integral;
         ParticleDef p_def;
 
+        //!
+        //! Inverse cumulative distribution of rho / rho_max in the reduced
+        //! variables (vbar, rnd), tabulated for every component on the nodes
+        //! of energy_axis. Empty if the integral is used for sampling.
+        //!
+        std::unique_ptr<cubic_splines::ExpAxis<double>> energy_axis;
+        std::unordered_map<size_t, rho_slices_t> rho_tables;
+
         static constexpr int n_rnd = 3;
 
+        static constexpr size_t NODES_RHO_E = 20;
+        static constexpr size_t NODES_RHO_V = 50;
+        static constexpr size_t NODES_RHO_RND = 50;
+
+        double GetRhoMax(double energy, double v) const;
+        double IntegrateRho(double, double, const Component&, double);
+        double InterpolateRho(double, double, const Component&, double);
+        void BuildRhoTables(const Medium&);
+
     public:
         KelnerKokoulinPetrukhinMupairProduction(
-            const ParticleDef& p, const Medium&)
+            const ParticleDef& p, const Medium& m, bool interpolate = true)
             : p_def(p)
         {
+            if (interpolate)
+                BuildRhoTables(m);
         }
 
         double CalculateRho(double, double, const Component&, double, double) final;
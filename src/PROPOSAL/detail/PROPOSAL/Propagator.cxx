@@ -1,7 +1,9 @@
 #include "PROPOSAL/Propagator.h"
+#include "PROPOSAL/Constants.h"
 #include "PROPOSAL/Logging.h"
 #include "PROPOSAL/Secondaries.h"
 #include "PROPOSAL/crosssection/CrossSection.h"
+#include "PROPOSAL/crosssection/CrossSectionBias.h"
 #include "PROPOSAL/crosssection/Factories/AnnihilationFactory.h"
 #include "PROPOSAL/crosssection/Factories/BremsstrahlungFactory.h"
 #include "PROPOSAL/crosssection/Factories/ComptonFactory.h"
@@ -16,16 +18,27 @@
 #include "PROPOSAL/crosssection/Factories/WeakInteractionFactory.h"
 #include "PROPOSAL/crosssection/ParticleDefaultCrossSectionList.h"
 #include "PROPOSAL/density_distr/density_distr.h"
+#include "PROPOSAL/density_distr/density_homogeneous.h"
 #include "PROPOSAL/geometry/GeometryFactory.h"
 #include "PROPOSAL/math/RandomGenerator.h"
 #include "PROPOSAL/medium/MediumFactory.h"
+#include "PROPOSAL/output/EventFile.h"
 #include "PROPOSAL/particle/ParticleDef.h"
 #include "PROPOSAL/propagation_utility/ContRandBuilder.h"
 #include "PROPOSAL/propagation_utility/DecayBuilder.h"
+#include "PROPOSAL/propagation_utility/InteractionBias.h"
 #include "PROPOSAL/propagation_utility/InteractionBuilder.h"
 #include "PROPOSAL/propagation_utility/TimeBuilder.h"
 #include "PROPOSAL/scattering/ScatteringFactory.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
 #include <fstream>
+#include <mutex>
+#include <random>
+#include <thread>
 
 #include <iomanip>
 
@@ -33,14 +46,31 @@ using namespace PROPOSAL;
 using std::get;
 using std::string;
 
+namespace {
+// Wraps the crosssection into a CrossSectionBias if a bias is given in its
+// config. The interaction rate is enhanced and the weight of the particle
+// corrected accordingly.
+std::unique_ptr<CrossSectionBase> apply_bias(
+    std::unique_ptr<CrossSectionBase> cross, const nlohmann::json& config)
+{
+    double bias = config.value("bias", 1.0);
+    if (bias != 1.0)
+        return make_crosssection_bias(
+            std::shared_ptr<CrossSectionBase>(std::move(cross)), bias);
+    return cross;
+}
+} // namespace
+
 Propagator::Propagator(const ParticleDef& p_def, std::vector<Sector> sectors)
     : p_def(p_def)
     , sector_list(sectors)
 {
+    InitializeSectorVariants();
 }
 
 Propagator::Propagator(const ParticleDef& p_def, const nlohmann::json& config)
     : p_def(p_def)
+    , config(config)
 {
     GlobalSettings global;
     if (config.contains("global"))
@@ -53,25 +83,93 @@ Propagator::Propagator(const ParticleDef& p_def, const nlohmann::json& config)
     } else {
         throw std::invalid_argument("No sector array found in json object");
     }
+    InitializeSectorVariants();
 }
 
 Secondaries Propagator::Propagate(const ParticleState& initial_particle,
     double max_distance, double min_energy, unsigned int hierarchy_condition)
 {
-    Secondaries track(std::make_shared<ParticleDef>(p_def), sector_list);
+    auto rnd
+        = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+    return Propagate(initial_particle, rnd, max_distance, min_energy,
+        hierarchy_condition);
+}
+
+std::vector<Secondaries> Propagator::PropagateBatch(
+    const std::vector<ParticleState>& initial_particles, unsigned int n_threads,
+    unsigned int seed, double max_distance, double min_energy,
+    unsigned int hierarchy_condition)
+{
+    if (n_threads == 0)
+        n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    n_threads = std::min<size_t>(n_threads, std::max<size_t>(initial_particles.size(), 1));
+
+    std::vector<std::unique_ptr<Secondaries>> tracks(initial_particles.size());
+    std::atomic<size_t> next_particle(0);
+    std::exception_ptr error = nullptr;
+    std::mutex error_mutex;
+
+    auto worker = [&]() {
+        std::mt19937 rng;
+        std::uniform_real_distribution<double> uniform(0., 1.);
+        auto rnd = [&rng, &uniform]() { return uniform(rng); };
+        try {
+            for (auto i = next_particle++; i < initial_particles.size();
+                 i = next_particle++) {
+                SeedEvent(rng, seed, i);
+                tracks[i] = PROPOSAL::make_unique<Secondaries>(Propagate(
+                    initial_particles[i], rnd, max_distance, min_energy,
+                    hierarchy_condition));
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+            next_particle = initial_particles.size();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < n_threads; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    std::vector<Secondaries> result;
+    result.reserve(tracks.size());
+    for (auto& track : tracks)
+        result.push_back(std::move(*track));
+    return result;
+}
+
+template <typename Track>
+bool Propagator::PropagateTrack(Track& track,
+    const ParticleState& initial_particle, std::function<double()>& rnd,
+    double max_distance, double min_energy, unsigned int hierarchy_condition,
+    bool split)
+{
 
     track.push_back(initial_particle, InteractionType::ContinuousEnergyLoss);
     auto state = ParticleState(initial_particle);
 
-    auto current_sector = GetCurrentSector(state.position, state.direction);
-    auto rnd
-        = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+    auto sector_index = GetCurrentSectorIndex(state.position, state.direction);
+    auto current_sector = sector_list[sector_index];
 
     int advancement_type;
     auto continue_propagation = true;
 
+    auto check_volume = forced_volume
+        && (split || forced_volume->force_interaction);
+
     std::array<double, 3> InteractionEnergy;
     while (continue_propagation) {
+        if (target_cut && !target_cut->IsReachable(state))
+            break;
+
         auto& utility = get<UTILITY>(current_sector);
         auto& density = get<DENSITY_DISTR>(current_sector);
 
@@ -82,15 +180,70 @@ Secondaries Propagator::Propagate(const ParticleState& initial_particle,
         InteractionEnergy[Stochastic]
             = utility.EnergyInteraction(state.energy, rnd);
 
+        // The step ends on entry into the forced volume. Inside, the particle
+        // is either split or its next interaction is forced to happen before
+        // the exit.
+        auto step_limit = max_distance;
+        auto forced_probability = 0.;
+        if (check_volume) {
+            auto intersection = forced_volume->volume->Intersect(
+                state.position, state.direction);
+            auto border = QueryGeometry(state.position, state.direction,
+                sector_geometries[sector_index])
+                              .distance_to_border;
+            auto entry = intersection.location
+                    == Geometry::ParticleLocation::InsideGeometry
+                ? 0.
+                : intersection.entry;
+            if (intersection.location
+                    != Geometry::ParticleLocation::BehindGeometry
+                && entry <= PARTICLE_POSITION_RESOLUTION) {
+                if (split)
+                    return true;
+                auto exit = std::min({ intersection.exit, border,
+                    max_distance - state.propagated_distance });
+                auto energy_at_exit = std::max(
+                    utility.EnergyDistance(state.energy,
+                        density->Calculate(
+                            state.position, state.direction, exit)),
+                    InteractionEnergy[MinimalE]);
+                auto forced = utility.EnergyForcedInteraction(
+                    state.energy, energy_at_exit, rnd);
+                if (forced.second > 0.) {
+                    InteractionEnergy[Stochastic] = forced.first;
+                    forced_probability = forced.second;
+                }
+                // only the part of the volume inside the current sector is
+                // forced, the check is not repeated in the next sector
+                check_volume = false;
+            } else if (intersection.location
+                    == Geometry::ParticleLocation::InfrontGeometry
+                && entry < border) {
+                step_limit = std::min(
+                    max_distance, state.propagated_distance + entry);
+            }
+        }
+
         auto next_interaction_type = maximize(InteractionEnergy);
         auto energy_at_next_interaction
             = InteractionEnergy[next_interaction_type];
 
         advancement_type = AdvanceParticle(
-                state, energy_at_next_interaction, max_distance, rnd,
-                current_sector, next_interaction_type == MinimalE,
+                state, energy_at_next_interaction, step_limit, rnd,
+                current_sector, sector_index, next_interaction_type == MinimalE,
                 InteractionEnergy[MinimalE]);
 
+        // The forced interaction is weighted with its probability once it is
+        // reached. Otherwise, the history has no interaction inside the
+        // volume, which is not part of the forced estimate.
+        if (forced_probability > 0.) {
+            if (advancement_type == ReachedInteraction
+                && next_interaction_type == Stochastic)
+                state.weight *= forced_probability;
+            else
+                state.weight = 0.;
+        }
+
         // If the particle is on the sector border before the continuous step is
         // performed in 'AdvanceParticle', we might enter a different sector due
         // to multiple scattering. Therefore, we have to update current_sector.
@@ -123,7 +276,8 @@ Secondaries Propagator::Propagate(const ParticleState& initial_particle,
             break;
         case ReachedBorder: {
             auto hierarchy_i = get<GEOMETRY>(current_sector)->GetHierarchy();
-            current_sector = GetCurrentSector(state.position, state.direction);
+            sector_index = GetCurrentSectorIndex(state.position, state.direction);
+            current_sector = sector_list[sector_index];
             auto hierarchy_f = get<GEOMETRY>(current_sector)->GetHierarchy();
             if (hierarchy_i > hierarchy_condition
                 && hierarchy_f < hierarchy_condition)
@@ -131,21 +285,275 @@ Secondaries Propagator::Propagate(const ParticleState& initial_particle,
             break;
         }
         case ReachedMaxDistance:
+            if (step_limit < max_distance)
+                break; // entry into the forced volume
             continue_propagation = false;
             break;
         }
     }
+    return false;
+}
+
+Secondaries Propagator::Propagate(const ParticleState& initial_particle,
+    std::function<double()> rnd, double max_distance, double min_energy,
+    unsigned int hierarchy_condition)
+{
+    Secondaries track(std::make_shared<ParticleDef>(p_def), sector_list);
+    PropagateTrack(track, initial_particle, rnd, max_distance, min_energy,
+        hierarchy_condition);
     return track;
 }
 
+std::vector<Secondaries> Propagator::PropagateSplit(
+    const ParticleState& initial_particle, std::function<double()> rnd,
+    double max_distance, double min_energy, unsigned int hierarchy_condition)
+{
+    auto primary = std::make_shared<ParticleDef>(p_def);
+    std::vector<Secondaries> tracks;
+    tracks.emplace_back(primary, sector_list);
+    auto split = forced_volume && forced_volume->n_copies > 1;
+    if (!PropagateTrack(tracks.front(), initial_particle, rnd, max_distance,
+            min_energy, hierarchy_condition, split))
+        return tracks;
+
+    // Every copy starts with the track up to the entry, the last point of
+    // which is the first point of its continuation.
+    auto head = std::move(tracks.front());
+    tracks.clear();
+    auto n_copies = forced_volume->n_copies;
+    const auto& head_points = head.GetTrackData();
+    const auto& head_types = head.GetTrackTypesData();
+    const auto& head_hashes = head.GetTargetHashesData();
+    auto entry_state = head_points.back();
+    entry_state.weight /= n_copies;
+    for (unsigned int i = 0; i < n_copies; ++i) {
+        Secondaries continuation(primary, sector_list);
+        PropagateTrack(continuation, entry_state, rnd, max_distance,
+            min_energy, hierarchy_condition);
+
+        Secondaries track(primary, sector_list);
+        for (size_t j = 0; j + 1 < head_points.size(); ++j) {
+            auto point = head_points[j];
+            point.weight /= n_copies;
+            track.push_back(point, head_types[j], head_hashes[j]);
+        }
+        const auto& points = continuation.GetTrackData();
+        const auto& types = continuation.GetTrackTypesData();
+        const auto& hashes = continuation.GetTargetHashesData();
+        for (size_t j = 0; j < points.size(); ++j)
+            track.push_back(points[j], types[j], hashes[j]);
+        tracks.push_back(std::move(track));
+    }
+    return tracks;
+}
+
+void Propagator::Propagate(const ParticleState& initial_particle,
+    std::function<double()> rnd, EventRecord& record, double max_distance,
+    double min_energy, unsigned int hierarchy_condition)
+{
+    record.clear();
+    PropagateTrack(record, initial_particle, rnd, max_distance, min_energy,
+        hierarchy_condition);
+}
+
+uint64_t Propagator::PropagateToFile(
+    const std::vector<ParticleState>& initial_particles, EventWriter& writer,
+    unsigned int n_threads, unsigned int seed, size_t chunk_size,
+    uint64_t first_event, double max_distance, double min_energy,
+    unsigned int hierarchy_condition)
+{
+    if (n_threads == 0)
+        n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    chunk_size = std::max<size_t>(chunk_size, 1);
+    auto n_chunks = (initial_particles.size() + chunk_size - 1) / chunk_size;
+    n_threads = std::min<size_t>(n_threads, std::max<size_t>(n_chunks, 1));
+
+    std::atomic<size_t> next_chunk(0);
+    std::exception_ptr error = nullptr;
+    std::mutex error_mutex;
+
+    // A chunk is only started if it is less than max_pending chunks ahead
+    // of the written events, so the writer never has to hold back more
+    // chunks than it accepts.
+    auto written_before = writer.EventsWritten();
+    auto max_ahead = std::max<size_t>(writer.GetMaxPending(), 1);
+    auto aborted = false;
+    std::mutex written_mutex;
+    std::condition_variable written_cv;
+    auto wait_for_writer = [&](size_t c) {
+        std::unique_lock<std::mutex> lock(written_mutex);
+        written_cv.wait(lock, [&]() {
+            auto written = writer.EventsWritten() - written_before;
+            return c < written / chunk_size + max_ahead || aborted;
+        });
+        return !aborted;
+    };
+
+    // Every thread fills whole chunks of consecutive events, so the writer
+    // can restore the order of the events.
+    auto worker = [&]() {
+        std::mt19937 rng;
+        std::uniform_real_distribution<double> uniform(0., 1.);
+        std::function<double()> rnd = [&rng, &uniform]() { return uniform(rng); };
+        EventRecord record(writer.WritesTracks());
+        EventChunk chunk;
+        try {
+            for (auto c = next_chunk++; c < n_chunks; c = next_chunk++) {
+                if (!wait_for_writer(c))
+                    break;
+                auto begin = c * chunk_size;
+                auto end = std::min(begin + chunk_size, initial_particles.size());
+                chunk.clear();
+                chunk.first_event = first_event + begin;
+                for (auto i = begin; i < end; ++i) {
+                    SeedEvent(rng, seed, first_event + i);
+                    Propagate(initial_particles[i], rnd, record, max_distance,
+                        min_energy, hierarchy_condition);
+                    chunk.Append(record);
+                }
+                writer.Write(std::move(chunk));
+                {
+                    // the waiting threads must not miss the notification
+                    // between checking the writer and going to sleep
+                    std::lock_guard<std::mutex> lock(written_mutex);
+                }
+                written_cv.notify_all();
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+            next_chunk = n_chunks;
+            {
+                std::lock_guard<std::mutex> lock(written_mutex);
+                aborted = true;
+            }
+            written_cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < n_threads; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    return initial_particles.size();
+}
+
+ParticleState Propagator::PropagateAdjoint(const ParticleState& target_particle,
+    std::function<double()> rnd, double max_distance)
+{
+    if (p_def.charge == 0)
+        throw std::invalid_argument("Adjoint propagation requires a charged "
+                                    "particle with continuous losses.");
+
+    auto state = ParticleState(target_particle);
+    auto direction = -Cartesian3D(target_particle.direction);
+    auto is_inside = [this, &direction](const Vector3D& position) {
+        for (auto& geometry : sector_geometries) {
+            if (geometry.Intersect(position, direction).location
+                == Geometry::ParticleLocation::InsideGeometry)
+                return true;
+        }
+        return false;
+    };
+    if (!is_inside(state.position))
+        throw std::invalid_argument(
+            "No sector defined at the position of the target particle.");
+
+    auto distance_travelled = 0.;
+    auto sector_index = GetCurrentSectorIndex(state.position, direction);
+    while (distance_travelled < max_distance) {
+        auto& utility = get<UTILITY>(sector_list[sector_index]);
+        auto& density = sector_densities[sector_index];
+        auto& geometry = sector_geometries[sector_index];
+
+        auto query = QueryGeometry(state.position, direction, geometry);
+        auto max_step = std::min(
+            query.distance_to_border, max_distance - distance_travelled);
+        auto grammage_max_step
+            = density.Calculate(state.position, direction, max_step);
+
+        auto energy = utility.EnergyAdjointInteraction(state.energy, rnd);
+        auto grammage = INF;
+        if (std::isfinite(energy))
+            grammage = utility.LengthContinuous(energy, state.energy);
+        auto reached_interaction = grammage < grammage_max_step;
+        auto step = max_step;
+        if (reached_interaction) {
+            step = density.Correct(
+                state.position, direction, grammage, max_step);
+        } else {
+            grammage = grammage_max_step;
+            energy = utility.EnergyAdjointDistance(state.energy, grammage);
+        }
+        if (!std::isfinite(energy)) {
+            state.weight = 0.;
+            break;
+        }
+
+        auto local_density = density.Evaluate(state.position);
+        state.weight *= utility.WeightAdjointContinuous(
+                            energy, state.energy, local_density)
+            * utility.WeightContinuous(energy, state.energy);
+        state.time -= utility.TimeElapsed(
+            energy, state.energy, grammage, local_density);
+        state.position = state.position + step * direction;
+        state.propagated_distance -= step;
+        state.energy = energy;
+        distance_travelled += step;
+
+        if (reached_interaction) {
+            auto adjoint = utility.EnergyAdjointStochasticloss(state.energy, rnd);
+            state.weight *= adjoint.weight;
+            if (adjoint.weight == 0.)
+                break;
+            state.energy /= 1. - adjoint.loss.v_loss;
+        } else if (distance_travelled < max_distance) {
+            if (!is_inside(state.position))
+                break;
+            sector_index = GetCurrentSectorIndex(state.position, direction);
+        }
+    }
+    return state;
+}
+
+std::vector<ParticleState> Propagator::PropagateAdjoint(
+    const ParticleState& target_particle, size_t n_samples,
+    double max_distance)
+{
+    auto rnd
+        = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+    std::vector<ParticleState> sources;
+    sources.reserve(n_samples);
+    for (size_t i = 0; i < n_samples; ++i)
+        sources.push_back(PropagateAdjoint(target_particle, rnd, max_distance));
+    return sources;
+}
+
+void Propagator::SeedEvent(std::mt19937& rng, unsigned int seed, uint64_t event)
+{
+    std::seed_seq seq { seed, static_cast<unsigned int>(event),
+        static_cast<unsigned int>(event >> 32) };
+    rng.seed(seq);
+}
+
 Interaction::Loss Propagator::DoStochasticInteraction(ParticleState& p_cond,
     PropagationUtility& utility, std::function<double()> rnd)
 {
-    auto loss = utility.EnergyStochasticloss(p_cond.energy, rnd());
+    auto loss = utility.EnergyStochasticloss(p_cond.energy, rnd);
 
     p_cond.direction = utility.DirectionDeflect(loss.type, p_cond.energy,
         p_cond.energy * (1. - loss.v_loss), p_cond.direction, rnd, loss.comp_hash);
     p_cond.energy = p_cond.energy * (1. - loss.v_loss);
+    p_cond.weight *= utility.WeightStochastic(loss.type);
 
     return loss;
 }
@@ -153,11 +561,11 @@ Interaction::Loss Propagator::DoStochasticInteraction(ParticleState& p_cond,
 int Propagator::AdvanceParticle(ParticleState &state,
     const double energy_next_interaction, const double final_distance,
     std::function<double()> rnd_generator, Sector& current_sector,
-    bool min_energy_step, const double min_energy) {
+    size_t& sector_index, bool min_energy_step, const double min_energy) {
 
     auto& utility = get<UTILITY>(current_sector);
-    auto& density = get<DENSITY_DISTR>(current_sector);
-    auto& geometry = get<GEOMETRY>(current_sector);
+    auto density_variant = &sector_densities[sector_index];
+    auto geometry_variant = &sector_geometries[sector_index];
 
     double energy = energy_next_interaction; // final energy of proposed step
     double grammage = -1; // grammage of proposed step
@@ -190,13 +598,13 @@ int Propagator::AdvanceParticle(ParticleState &state,
             // Calculate grammage and distance from given energy
             grammage = utility.LengthContinuous(state.energy, energy);
             try {
-                distance = density->Correct(state.position, state.direction, grammage, max_distance);
+                distance = density_variant->Correct(state.position, state.direction, grammage, max_distance);
             } catch (const DensityException&) {
                 distance = INF;
             }
         } else if (energy == -1 && distance != -1) {
             // Calculate energy and grammage from given distance
-            auto grammage_step = density->Calculate(state.position, state.direction, distance);
+            auto grammage_step = density_variant->Calculate(state.position, state.direction, distance);
             if (grammage_step < grammage_next_interaction) {
                 grammage = grammage_step;
                 energy = utility.EnergyDistance(state.energy, grammage);
@@ -212,7 +620,7 @@ int Propagator::AdvanceParticle(ParticleState &state,
                 grammage = grammage_next_interaction;
                 energy = energy_next_interaction;
                 try {
-                    distance = density->Correct(state.position, state.direction, grammage, max_distance);
+                    distance = density_variant->Correct(state.position, state.direction, grammage, max_distance);
                 } catch (const DensityException&) {
                     distance = INF;
                 }
@@ -228,16 +636,16 @@ int Propagator::AdvanceParticle(ParticleState &state,
                 grammage, state.energy, energy, state.direction, rnd);
 
         // Check step
-        double distance_to_border = CalculateDistanceToBorder(state.position, mean_direction, *geometry);
-        bool is_inside = geometry->IsInside(state.position, mean_direction);
-        if (!is_inside) {
+        auto query = QueryGeometry(state.position, mean_direction, *geometry_variant);
+        auto distance_to_border = query.distance_to_border;
+        if (query.current.location != Geometry::ParticleLocation::InsideGeometry) {
             // Special case: We are on the sector border, but scattering back outside the current sector!
             // Update sector and recalculate values
             advancement_type = InvalidStep;
-            auto new_sector = GetCurrentSector(state.position, mean_direction);
-            utility = get<UTILITY>(new_sector);
-            density = get<DENSITY_DISTR>(new_sector);
-            geometry = get<GEOMETRY>(new_sector);
+            sector_index = GetCurrentSectorIndex(state.position, mean_direction);
+            current_sector = sector_list[sector_index];
+            density_variant = &sector_densities[sector_index];
+            geometry_variant = &sector_geometries[sector_index];
             grammage_next_interaction = utility.LengthContinuous(state.energy, energy_next_interaction);
             energy = energy_next_interaction;
             distance = -1;
@@ -261,7 +669,8 @@ int Propagator::AdvanceParticle(ParticleState &state,
         }
     } while (advancement_type == InvalidStep);
 
-    state.time = state.time + utility.TimeElapsed(state.energy, energy, grammage, density->Evaluate(state.position)); // TODO: should the energy passed here be the randomized energy or not?
+    state.weight *= utility.WeightContinuous(state.energy, energy);
+    state.time = state.time + utility.TimeElapsed(state.energy, energy, grammage, density_variant->Evaluate(state.position)); // TODO: should the energy passed here be the randomized energy or not?
     state.position = state.position + distance * mean_direction;
     state.direction = new_direction;
     state.propagated_distance = state.propagated_distance + distance;
@@ -273,22 +682,26 @@ int Propagator::AdvanceParticle(ParticleState &state,
     return advancement_type;
 }
 
-double Propagator::CalculateDistanceToBorder(const Vector3D& position,
-    const Vector3D& direction, const Geometry& current_geometry)
+Propagator::GeometryQuery Propagator::QueryGeometry(const Vector3D& position,
+    const Vector3D& direction, const GeometryVariant& current_geometry)
 {
-    auto distance_border
-        = current_geometry.DistanceToBorder(position, direction).first;
+    auto query = GeometryQuery();
+    query.current = current_geometry.Intersect(position, direction);
+    query.distance_to_border = query.current.NextBorder();
+    if (query.current.location != Geometry::ParticleLocation::InsideGeometry)
+        return query;
+
     double tmp_distance;
-    for (auto& sector : sector_list) {
-        auto& geometry = get<GEOMETRY>(sector);
-        if (geometry->GetHierarchy() > current_geometry.GetHierarchy()) {
+    for (auto& geometry : sector_geometries) {
+        if (geometry.GetHierarchy() > current_geometry.GetHierarchy()) {
             tmp_distance
-                = geometry->DistanceToBorder(position, direction).first;
+                = geometry.DistanceToBorder(position, direction).first;
             if (tmp_distance >= 0)
-                distance_border = std::min(distance_border, tmp_distance);
+                query.distance_to_border
+                    = std::min(query.distance_to_border, tmp_distance);
         }
     }
-    return distance_border;
+    return query;
 }
 
 int Propagator::maximize(const std::array<double, 3>& InteractionEnergies)
@@ -305,13 +718,73 @@ int Propagator::minimize(const std::array<double, 3>& AdvanceDistances)
     return std::distance(AdvanceDistances.begin(), min_element_ref);
 }
 
-Sector Propagator::GetCurrentSector(
-    const Vector3D& position, const Vector3D& direction)
+void Propagator::SetTarget(std::shared_ptr<const Geometry> target,
+    double safety_factor, double min_density)
 {
-    auto potential_sec = std::vector<Sector*> {};
+    if (!target) {
+        target_cut = nullptr;
+        return;
+    }
+    if (safety_factor < 1.)
+        throw std::invalid_argument("The safety factor must be at least 1.");
+
+    auto cut = std::make_shared<TargetCut>();
+    cut->target = std::move(target);
+    cut->safety_factor = safety_factor;
+    cut->min_density = min_density > 0 ? min_density : INF;
     for (auto& sector : sector_list) {
-        if (get<GEOMETRY>(sector)->IsInside(position, direction))
-            potential_sec.push_back(&sector);
+        auto& utility = get<UTILITY>(sector);
+        cut->ranges.emplace_back(*utility.collection.displacement_calc);
+
+        auto& density = get<DENSITY_DISTR>(sector);
+        if (dynamic_cast<const Density_homogeneous*>(density.get())) {
+            auto rho = density->Evaluate(get<GEOMETRY>(sector)->GetPosition());
+            cut->min_density = std::min(cut->min_density, rho);
+        } else if (min_density <= 0) {
+            throw std::invalid_argument("A minimal density is required for "
+                                        "inhomogeneous density distributions.");
+        }
+    }
+    target_cut = cut;
+}
+
+void Propagator::SetForcedVolume(std::shared_ptr<const Geometry> volume,
+    bool force_interaction, unsigned int n_copies)
+{
+    if (!volume) {
+        forced_volume = nullptr;
+        return;
+    }
+    if (n_copies == 0)
+        throw std::invalid_argument("The number of copies must be positive.");
+
+    auto forced = std::make_shared<ForcedVolume>();
+    forced->volume = std::move(volume);
+    forced->force_interaction = force_interaction;
+    forced->n_copies = n_copies;
+    forced_volume = forced;
+}
+
+bool Propagator::TargetCut::IsReachable(const ParticleState& state) const
+{
+    auto distance = target->MinimalDistance(state.position);
+    if (distance <= 0.)
+        return true;
+
+    auto grammage = 0.;
+    for (const auto& range : ranges)
+        grammage = std::max(grammage, range.GetGrammage(state.energy));
+    return safety_factor * grammage / min_density >= distance;
+}
+
+size_t Propagator::GetCurrentSectorIndex(
+    const Vector3D& position, const Vector3D& direction)
+{
+    auto potential_sec = std::vector<size_t> {};
+    for (size_t i = 0; i < sector_list.size(); ++i) {
+        auto location = sector_geometries[i].Intersect(position, direction).location;
+        if (location == Geometry::ParticleLocation::InsideGeometry)
+            potential_sec.push_back(i);
     }
 
     if (potential_sec.empty()) {
@@ -322,16 +795,46 @@ Sector Propagator::GetCurrentSector(
                                                       spherical_position.GetZ());
     }
     auto highest_sector_iter = std::max_element(
-        potential_sec.begin(), potential_sec.end(), [](Sector* a, Sector* b) {
-            return get<GEOMETRY>(*a)->GetHierarchy()
-                < get<GEOMETRY>(*b)->GetHierarchy();
+        potential_sec.begin(), potential_sec.end(), [this](size_t a, size_t b) {
+            return get<GEOMETRY>(sector_list[a])->GetHierarchy()
+                < get<GEOMETRY>(sector_list[b])->GetHierarchy();
         });
 
-    return **highest_sector_iter;
+    return *highest_sector_iter;
+}
+
+void Propagator::InitializeSectorVariants()
+{
+    for (const auto& sector : sector_list) {
+        sector_densities.emplace_back(*get<DENSITY_DISTR>(sector));
+        sector_geometries.emplace_back(*get<GEOMETRY>(sector));
+    }
 }
 
 // Init methods
 
+Propagator::TableSettings Propagator::TableSettings::Current()
+{
+    return { InterpolationSettings::TABLES_PATH,
+        InterpolationSettings::UPPER_ENERGY_LIM,
+        InterpolationSettings::NODES_DEDX, InterpolationSettings::NODES_DE2DX,
+        InterpolationSettings::NODES_DNDX_E, InterpolationSettings::NODES_DNDX_V,
+        InterpolationSettings::NODES_UTILITY,
+        InterpolationSettings::NODES_RATE_INTERPOLANT };
+}
+
+void Propagator::TableSettings::Apply() const
+{
+    InterpolationSettings::TABLES_PATH = tables_path;
+    InterpolationSettings::UPPER_ENERGY_LIM = upper_energy_lim;
+    InterpolationSettings::NODES_DEDX = nodes_dedx;
+    InterpolationSettings::NODES_DE2DX = nodes_de2dx;
+    InterpolationSettings::NODES_DNDX_E = nodes_dndx_e;
+    InterpolationSettings::NODES_DNDX_V = nodes_dndx_v;
+    InterpolationSettings::NODES_UTILITY = nodes_utility;
+    InterpolationSettings::NODES_RATE_INTERPOLANT = nodes_rate_interpolant;
+}
+
 nlohmann::json Propagator::ParseConfig(const string& config_file)
 {
     std::ifstream f(config_file.c_str());
@@ -363,6 +866,8 @@ void Propagator::InitializeSectorFromJSON(const ParticleDef& p_def,
     bool do_interpolation
         = json_sector.value("do_interpolation", global.do_interpolation);
     bool do_exact_time = json_sector.value("exact_time", global.do_exact_time);
+    bool do_binned_sampling
+        = json_sector.value("binned_sampling", global.do_binned_sampling);
     auto scattering_config = json_sector.value("scattering", global.scattering);
     std::shared_ptr<Medium> medium = global.medium;
     if (json_sector.contains("medium")) {
@@ -393,12 +898,14 @@ void Propagator::InitializeSectorFromJSON(const ParticleDef& p_def,
         auto crosss = CreateCrossSectionList(p_def, *medium, cuts,
             do_interpolation, density_correction, cross_config);
         collection = CreateUtility(crosss, medium, cuts->GetContRand(),
-            do_interpolation, do_exact_time, scattering_config);
+            do_interpolation, do_exact_time, scattering_config,
+            do_binned_sampling);
     } else {
         auto std_crosss
             = GetStdCrossSections(p_def, *medium, cuts, do_interpolation);
         collection = CreateUtility(std_crosss, medium, cuts->GetContRand(),
-            do_interpolation, do_exact_time, scattering_config);
+            do_interpolation, do_exact_time, scattering_config,
+            do_binned_sampling);
     }
     auto utility = PropagationUtility(collection);
 
@@ -419,12 +926,14 @@ void Propagator::InitializeSectorFromJSON(const ParticleDef& p_def,
 PropagationUtility::Collection Propagator::CreateUtility(
     std::vector<std::shared_ptr<CrossSectionBase>> crosss,
     std::shared_ptr<Medium> medium, bool do_cont_rand, bool do_interpol,
-    bool do_exact_time, nlohmann::json scatter)
+    bool do_exact_time, nlohmann::json scatter, bool do_binned_sampling)
 {
     PropagationUtility::Collection def;
     def.displacement_calc = make_displacement(crosss, do_interpol);
     def.interaction_calc
         = make_interaction(def.displacement_calc, crosss, do_interpol, false);
+    if (do_binned_sampling)
+        def.interaction_calc->BuildBinnedSampling();
     if (!scatter.empty())
         def.scattering
             = make_scattering(scatter, p_def, *medium, crosss, do_interpol);
@@ -437,6 +946,8 @@ PropagationUtility::Collection Propagator::CreateUtility(
     } else {
         def.time_calc = std::make_shared<ApproximateTimeBuilder>();
     }
+    def.bias = make_interaction_bias(
+        def.interaction_calc, def.displacement_calc, crosss, do_interpol);
     return def;
 }
 
@@ -448,47 +959,59 @@ Propagator::CreateCrossSectionList(const ParticleDef& p_def,
     std::vector<std::shared_ptr<CrossSectionBase>> cross;
 
     if (config.contains("annihilation"))
-        cross.emplace_back(make_annihilation(
-            p_def, medium, interpolate, config["annihilation"]));
+        cross.emplace_back(apply_bias(make_annihilation(
+            p_def, medium, interpolate, config["annihilation"]),
+            config["annihilation"]));
     if (config.contains("brems"))
-        cross.emplace_back(make_bremsstrahlung(p_def, medium, cuts, interpolate,
-            config["brems"], density_correction));
+        cross.emplace_back(apply_bias(make_bremsstrahlung(p_def, medium, cuts,
+            interpolate, config["brems"], density_correction),
+            config["brems"]));
     if (config.contains("compton"))
-        cross.emplace_back(
-            make_compton(p_def, medium, cuts, interpolate, config["compton"]));
+        cross.emplace_back(apply_bias(
+            make_compton(p_def, medium, cuts, interpolate, config["compton"]),
+            config["compton"]));
     if (config.contains("epair"))
-        cross.emplace_back(make_epairproduction(p_def, medium, cuts,
-            interpolate, config["epair"], density_correction));
+        cross.emplace_back(apply_bias(make_epairproduction(p_def, medium, cuts,
+            interpolate, config["epair"], density_correction),
+            config["epair"]));
     if (config.contains("ioniz"))
-        cross.emplace_back(
-            make_ionization(p_def, medium, cuts, interpolate, config["ioniz"]));
+        cross.emplace_back(apply_bias(
+            make_ionization(p_def, medium, cuts, interpolate, config["ioniz"]),
+            config["ioniz"]));
     if (config.contains("mupair"))
-        cross.emplace_back(make_mupairproduction(
-            p_def, medium, cuts, interpolate, config["mupair"]));
+        cross.emplace_back(apply_bias(make_mupairproduction(
+            p_def, medium, cuts, interpolate, config["mupair"]),
+            config["mupair"]));
     if (config.contains("photo")) {
         try {
-            cross.emplace_back(make_photonuclearreal(
-                p_def, medium, cuts, interpolate, config["photo"]));
+            cross.emplace_back(apply_bias(make_photonuclearreal(
+                p_def, medium, cuts, interpolate, config["photo"]),
+                config["photo"]));
         } catch (std::invalid_argument& e) {
-            cross.emplace_back(make_photonuclearQ2(
-                p_def, medium, cuts, interpolate, config["photo"]));
+            cross.emplace_back(apply_bias(make_photonuclearQ2(
+                p_def, medium, cuts, interpolate, config["photo"]),
+                config["photo"]));
         }
     }
     if (config.contains("photoeffect"))
-        cross.emplace_back(make_photoeffect(
-            p_def, medium, config["photoeffect"]));
+        cross.emplace_back(apply_bias(make_photoeffect(
+            p_def, medium, config["photoeffect"]), config["photoeffect"]));
     if (config.contains("photomupair"))
-        cross.emplace_back(make_photomupairproduction(
-            p_def, medium, interpolate, config["photomupair"]));
+        cross.emplace_back(apply_bias(make_photomupairproduction(
+            p_def, medium, interpolate, config["photomupair"]),
+            config["photomupair"]));
     if (config.contains("photoproduction"))
-        cross.emplace_back(make_photoproduction(
-            p_def, medium, config["photoproduction"]));
+        cross.emplace_back(apply_bias(make_photoproduction(
+            p_def, medium, config["photoproduction"]),
+            config["photoproduction"]));
     if (config.contains("photopair"))
-        cross.emplace_back(make_photopairproduction(
-            p_def, medium, interpolate, config["photopair"]));
+        cross.emplace_back(apply_bias(make_photopairproduction(
+            p_def, medium, interpolate, config["photopair"]),
+            config["photopair"]));
     if (config.contains("weak"))
-        cross.emplace_back(
-            make_weakinteraction(p_def, medium, interpolate, config["weak"]));
+        cross.emplace_back(apply_bias(
+            make_weakinteraction(p_def, medium, interpolate, config["weak"]),
+            config["weak"]));
     return cross;
 }
 
@@ -504,6 +1027,7 @@ Propagator::GlobalSettings::GlobalSettings(const nlohmann::json& config_global)
         scattering = config_global["scattering"];
     do_exact_time = config_global.value("exact_time", true);
     do_interpolation = config_global.value("do_interpolation", true);
+    do_binned_sampling = config_global.value("binned_sampling", false);
 }
 
 Propagator::GlobalSettings::GlobalSettings()
@@ -512,5 +1036,6 @@ Propagator::GlobalSettings::GlobalSettings()
     cross = {};
     do_exact_time = true;
     do_interpolation = true;
+    do_binned_sampling = false;
     scattering = {};
 }
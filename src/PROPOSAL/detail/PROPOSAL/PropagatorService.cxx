@@ -0,0 +1,81 @@
+#include "PROPOSAL/PropagatorService.h"
+#include "PROPOSAL/math/RandomGenerator.h"
+
+using namespace PROPOSAL;
+
+PropagatorService::PropagatorService(
+    const nlohmann::json& config, std::vector<ParticleType> types)
+{
+    // The propagators are created one after another, the tables written by
+    // the first propagator are read by all following ones.
+    for (auto type : types) {
+        auto p_def = ParticleDef::GetParticleDefForType(static_cast<int>(type));
+        RegisterPropagator(std::make_shared<Propagator>(p_def, config));
+    }
+}
+
+PropagatorService::PropagatorService(
+    const std::string& config_file, std::vector<ParticleType> types)
+    : PropagatorService(Propagator::ParseConfig(config_file), types)
+{
+}
+
+std::vector<ParticleType> PropagatorService::DefaultTypes()
+{
+    return { ParticleType::MuMinus, ParticleType::MuPlus,
+        ParticleType::TauMinus, ParticleType::TauPlus, ParticleType::EMinus,
+        ParticleType::EPlus, ParticleType::Gamma };
+}
+
+void PropagatorService::RegisterPropagator(
+    std::shared_ptr<Propagator> propagator)
+{
+    if (!propagator)
+        throw std::invalid_argument("Propagator must not be null.");
+
+    auto type = static_cast<ParticleType>(
+        propagator->GetParticleDef().particle_type);
+
+    std::unique_lock<std::shared_timed_mutex> lock(propagators_mutex_);
+    propagators_[type] = std::move(propagator);
+}
+
+bool PropagatorService::IsRegistered(ParticleType type) const
+{
+    std::shared_lock<std::shared_timed_mutex> lock(propagators_mutex_);
+    return propagators_.find(type) != propagators_.end();
+}
+
+std::shared_ptr<Propagator> PropagatorService::GetPropagator(
+    ParticleType type) const
+{
+    std::shared_lock<std::shared_timed_mutex> lock(propagators_mutex_);
+    auto it = propagators_.find(type);
+    if (it == propagators_.end())
+        throw std::out_of_range("No propagator registered for particle type "
+            + std::to_string(static_cast<int>(type)));
+    return it->second;
+}
+
+Secondaries PropagatorService::Propagate(const ParticleState& initial_particle,
+    double max_distance, double min_energy, unsigned int hierarchy_condition)
+{
+    auto rnd = [this]() {
+        std::lock_guard<std::mutex> lock(rnd_mutex_);
+        return RandomGenerator::Get().RandomDouble();
+    };
+    return Propagate(initial_particle, rnd, max_distance, min_energy,
+        hierarchy_condition);
+}
+
+Secondaries PropagatorService::Propagate(const ParticleState& initial_particle,
+    std::function<double()> rnd, double max_distance, double min_energy,
+    unsigned int hierarchy_condition)
+{
+    // The propagator is held by a shared_ptr, so it stays alive even if it
+    // gets replaced while the particle is propagated.
+    auto propagator
+        = GetPropagator(static_cast<ParticleType>(initial_particle.type));
+    return propagator->Propagate(initial_particle, rnd, max_distance,
+        min_energy, hierarchy_condition);
+}
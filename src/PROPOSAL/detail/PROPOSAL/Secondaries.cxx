@@ -3,6 +3,7 @@
 #include "PROPOSAL/decay/DecayChannel.h"
 #include "PROPOSAL/geometry/Geometry.h"
 #include "PROPOSAL/math/RandomGenerator.h"
+#include "PROPOSAL/secondaries/Thinning.h"
 #include "PROPOSAL/Propagator.h"
 #include "PROPOSAL/density_distr/density_distr.h"
 #include "PROPOSAL/Logging.h"
@@ -63,6 +64,7 @@ std::vector<ParticleState> Secondaries::GetDecayProducts() const
                 = primary_def_->decay_table.SelectChannel(random_ch).Decay(
                     *primary_def_, decaying_particle);
             for (auto p : products) {
+                p.weight = decaying_particle.weight;
                 decay_products.emplace_back(p);
             }
         }
@@ -70,6 +72,29 @@ std::vector<ParticleState> Secondaries::GetDecayProducts() const
     return decay_products;
 }
 
+std::vector<ParticleState> Secondaries::GetDecayProducts(
+    const Thinning& thinning) const
+{
+    std::vector<ParticleState> decay_products;
+    auto rnd = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+    for (unsigned int i=0; i<track_.size(); i++) {
+        if (types_[i] == InteractionType::Decay) {
+            ParticleState decaying_particle = track_[i];
+            double random_ch = RandomGenerator::Get().RandomDouble();
+            auto products
+                = primary_def_->decay_table.SelectChannel(random_ch).Decay(
+                    *primary_def_, decaying_particle);
+            for (auto& p : products)
+                p.weight = decaying_particle.weight;
+            products = thinning.Apply(
+                std::move(products), rnd, decaying_particle.energy);
+            decay_products.insert(
+                decay_products.end(), products.begin(), products.end());
+        }
+    }
+    return decay_products;
+}
+
 std::vector<ParticleState> Secondaries::GetTrack(const Geometry& geometry) const
 {
     std::vector<ParticleState> vec;
@@ -161,6 +186,14 @@ std::vector<double> Secondaries::GetTrackPropagatedDistances() const
     return vec;
 }
 
+std::vector<double> Secondaries::GetTrackWeights() const
+{
+    std::vector<double> vec;
+    for (auto i : track_)
+        vec.emplace_back(i.weight);
+    return vec;
+}
+
 double Secondaries::GetELost(const Geometry& geometry) const
 {
     auto entry_point = GetEntryPoint(geometry);
@@ -173,10 +206,14 @@ std::shared_ptr<ParticleState> Secondaries::GetEntryPoint(
 {
     auto pos_0 = track_.front().position;
     auto dir_0 = track_.front().direction;
-    if (geometry.IsEntering(pos_0, dir_0))
-        return std::make_unique<ParticleState>(track_.front());
-    if (geometry.IsInside(pos_0, dir_0))
+    auto forward = geometry.Intersect(pos_0, dir_0);
+    if (forward.location == Geometry::ParticleLocation::InsideGeometry) {
+        // on the border and moving inside
+        auto backward = geometry.Intersect(pos_0, -dir_0);
+        if (backward.location == Geometry::ParticleLocation::BehindGeometry)
+            return std::make_unique<ParticleState>(track_.front());
         return nullptr; // track starts in geometry
+    }
 
     for (unsigned int i = 0; i < track_.size() - 1; i++) {
         auto pos_i = track_[i].position;
@@ -204,10 +241,15 @@ std::shared_ptr<ParticleState> Secondaries::GetExitPoint(
 {
     auto pos_end = track_.back().position;
     auto dir_end = track_.back().direction;
-    if (geometry.IsLeaving(pos_end, dir_end))
-        return std::make_unique<ParticleState>(track_.back());
-    if (geometry.IsInside(pos_end, dir_end))
+    auto forward = geometry.Intersect(pos_end, dir_end);
+    if (forward.location == Geometry::ParticleLocation::InsideGeometry)
         return nullptr; // track ends inside geometry
+    if (forward.location == Geometry::ParticleLocation::BehindGeometry) {
+        // on the border and moving outside
+        auto backward = geometry.Intersect(pos_end, -dir_end);
+        if (backward.location == Geometry::ParticleLocation::InsideGeometry)
+            return std::make_unique<ParticleState>(track_.back());
+    }
 
     for (auto i = track_.size() - 1; i > 0; i--) {
         auto pos_i = track_[i-1].position;
@@ -314,8 +356,11 @@ ParticleState Secondaries::RePropagateEnergy(const ParticleState& init,
     auto new_position = init.position + direction * displacement;
     auto new_propagated_distance = init.propagated_distance + displacement;
 
-    return ParticleState((ParticleType)primary_def_->particle_type, new_position,
-                         direction, E_f, new_time, new_propagated_distance);
+    auto state = ParticleState((ParticleType)primary_def_->particle_type,
+                               new_position, direction, E_f, new_time,
+                               new_propagated_distance);
+    state.weight = init.weight * utility.WeightContinuous(init.energy, E_f);
+    return state;
 }
 
 ParticleState Secondaries::RePropagateDistance(const ParticleState& init,
@@ -338,8 +383,11 @@ ParticleState Secondaries::RePropagateDistance(const ParticleState& init,
             init.energy, E_f, displacement, density->Evaluate(init.position));
     auto new_position = init.position + direction * displacement;
     auto new_propagated_distance = init.propagated_distance + displacement;
-    return ParticleState((ParticleType)primary_def_->particle_type, new_position,
-                         direction, E_f, new_time, new_propagated_distance);
+    auto state = ParticleState((ParticleType)primary_def_->particle_type,
+                               new_position, direction, E_f, new_time,
+                               new_propagated_distance);
+    state.weight = init.weight * utility.WeightContinuous(init.energy, E_f);
+    return state;
 }
 
 Sector Secondaries::GetCurrentSector(const Vector3D& position,
@@ -378,7 +426,8 @@ std::vector<StochasticLoss> Secondaries::GetStochasticLosses() const
                                 track_[i-1].energy - track_[i].energy,
                                 track_[i].position, track_[i].direction,
                                 track_[i].time, track_[i].propagated_distance,
-                                track_[i-1].energy, target_hashes_[i]);
+                                track_[i-1].energy, target_hashes_[i],
+                                track_[i].weight);
         }
     }
     return losses;
@@ -398,7 +447,8 @@ std::vector<StochasticLoss> Secondaries::GetStochasticLosses(const Geometry& geo
                                     track_[i-1].energy - track_[i].energy,
                                     track_[i].position, track_[i].direction,
                                     track_[i].time, track_[i].propagated_distance,
-                                    track_[i-1].energy, target_hashes_[i]);
+                                    track_[i-1].energy, target_hashes_[i],
+                                track_[i].weight);
             }
         }
     }
@@ -417,7 +467,8 @@ std::vector<StochasticLoss> Secondaries::GetStochasticLosses(const InteractionTy
                                 track_[i-1].energy - track_[i].energy,
                                 track_[i].position, track_[i].direction,
                                 track_[i].time, track_[i].propagated_distance,
-                                track_[i-1].energy, target_hashes_[i]);
+                                track_[i-1].energy, target_hashes_[i],
+                                track_[i].weight);
         }
     }
     return losses;
@@ -52,6 +52,12 @@ std::string CrossSectionDNDXInterpolant::gen_name() const
         + std::string(".dat");
 }
 
+std::string CrossSectionDNDXInterpolant::gen_inverse_name() const
+{
+    return std::string("dndx_inverse_") + std::to_string(GetHash())
+        + std::string(".dat");
+}
+
 size_t CrossSectionDNDXInterpolant::gen_hash(size_t hash) const {
     hash_combine(hash,
                  InterpolationSettings::NODES_DNDX_E,
@@ -88,18 +94,39 @@ double CrossSectionDNDXInterpolant::Calculate(double energy, double v)
     return evaluate_interpolant(energy, vbar);
 }
 
-double CrossSectionDNDXInterpolant::GetUpperLimit(double energy, double rate)
+cubic_splines::BicubicSplines<double>::Definition
+CrossSectionDNDXInterpolant::build_inverse_def()
 {
-    if (energy < lower_energy_lim)
-        throw std::invalid_argument("no dNdx for this energy defined.");
-    auto lim = GetIntegrationLimits(energy);
+    auto w_lim = AxisBuilderDNDX::v_limits { 0, 1,
+        InterpolationSettings::NODES_DNDX_V };
+    auto energy_lim = AxisBuilderDNDX::energy_limits();
+    energy_lim.low = interpolant.GetDefinition().GetAxis().at(0)->GetLow();
+    energy_lim.up = InterpolationSettings::UPPER_ENERGY_LIM;
+    energy_lim.nodes = InterpolationSettings::NODES_DNDX_E;
+
+    auto def = cubic_splines::BicubicSplines<double>::Definition();
+    def.axis = AxisBuilderDNDX::Create(w_lim, energy_lim);
+    def.f = [this](double energy, double w) {
+        auto total_rate = interpolant.evaluate(std::array<double, 2> { energy, 1. });
+        if (!(total_rate > 0) || w >= 1)
+            return 0.;
+        if (w <= 0)
+            return 1.;
+        return solve_interpolant(energy, (1. - w * w) * total_rate);
+    };
+    def.approx_derivates = true;
+
+    LogTableCreation(gen_path(), gen_inverse_name());
+    return def;
+}
 
+double CrossSectionDNDXInterpolant::solve_interpolant(double energy, double rate)
+{
     auto initial_guess = cubic_splines::ParameterGuess<std::array<double, 2>>();
     initial_guess.x = { energy, NAN };
     initial_guess.n = 1;
-    double v;
     try {
-        v = cubic_splines::find_parameter(interpolant, rate, initial_guess);
+        return cubic_splines::find_parameter(interpolant, rate, initial_guess);
     } catch (std::runtime_error&) {
         Logging::Get("proposal.UtilityInterpolant")->warn(
                 "Newton-Raphson iteration in "
@@ -111,10 +138,25 @@ double CrossSectionDNDXInterpolant::GetUpperLimit(double energy, double rate)
                     std::array<double, 2> { energy, val }) - rate;
         };
         // v is evaluated in transformed space!
-        auto interval = Bisection(f, retransform_v(lim.min, lim.max, lim.min),
-                                  retransform_v(lim.min, lim.max, lim.max),
-                                  1e-6, 100);
-        v = (interval.first + interval.second) / 2.;
+        auto interval = Bisection(f, 0., 1., 1e-6, 100);
+        return (interval.first + interval.second) / 2.;
     }
-    return transform_v(lim.min, lim.max, v);
+}
+
+double CrossSectionDNDXInterpolant::GetUpperLimit(double energy, double rate)
+{
+    if (energy < lower_energy_lim)
+        throw std::invalid_argument("no dNdx for this energy defined.");
+    auto lim = GetIntegrationLimits(energy);
+
+    auto total_rate = evaluate_interpolant(energy, 1.);
+    if (!(total_rate > 0))
+        return transform_v(lim.min, lim.max, solve_interpolant(energy, rate));
+
+    auto r = std::min(std::max(rate / total_rate, 0.), 1.);
+    auto vbar = inverse_interpolant.evaluate(
+            std::array<double, 2> { energy, std::sqrt(1. - r) });
+    vbar = std::min(std::max(vbar, 0.), 1.);
+
+    return transform_v(lim.min, lim.max, vbar);
 }
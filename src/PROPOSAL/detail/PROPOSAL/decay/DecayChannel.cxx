@@ -105,11 +105,23 @@ double DecayChannel::Momentum(double m1, double m2, double m3)
     }
 }
 
+// ------------------------------------------------------------------------- //
+std::vector<ParticleState> DecayChannel::Decay(const ParticleDef& p_def, const ParticleState& p_condition)
+{
+    return Decay(p_def, p_condition, std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get()));
+}
+
 // ------------------------------------------------------------------------- //
 Cartesian3D DecayChannel::GenerateRandomDirection()
 {
-    double phi       = 2.0 * PI * RandomGenerator::Get().RandomDouble();
-    double cos_theta = 2.0 * RandomGenerator::Get().RandomDouble() - 1.0;
+    return GenerateRandomDirection(std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get()));
+}
+
+// ------------------------------------------------------------------------- //
+Cartesian3D DecayChannel::GenerateRandomDirection(const std::function<double()>& rnd)
+{
+    double phi       = 2.0 * PI * rnd();
+    double cos_theta = 2.0 * rnd() - 1.0;
     double sin_theta = std::sqrt((1.0 - cos_theta) * (1.0 + cos_theta));
     Cartesian3D direction(sin_theta * std::cos(phi), sin_theta * std::sin(phi), cos_theta);
     return direction;
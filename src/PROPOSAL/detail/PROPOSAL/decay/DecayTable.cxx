@@ -1,12 +1,15 @@
 
+#include <algorithm>
 #include <sstream>
 
 #include "PROPOSAL/decay/DecayTable.h"
 #include "PROPOSAL/decay/DecayChannel.h"
 #include "PROPOSAL/decay/LeptonicDecayChannel.h"
+#include "PROPOSAL/decay/ManyBodyPhaseSpace.h"
 #include "PROPOSAL/decay/StableChannel.h"
 #include "PROPOSAL/decay/TwoBodyPhaseSpace.h"
 #include "PROPOSAL/Logging.h"
+#include "PROPOSAL/math/RandomGenerator.h"
 #include "PROPOSAL/methods.h"
 
 using namespace PROPOSAL;
@@ -30,6 +33,8 @@ DecayTable::DecayTable(const DecayTable& table)
     {
         channels_[iter->first] = iter->second->clone();
     }
+
+    BuildSelector();
 }
 
 // ------------------------------------------------------------------------- //
@@ -52,6 +57,8 @@ void PROPOSAL::swap(DecayTable& first, DecayTable& second)
 {
     using std::swap;
     swap(first.channels_, second.channels_);
+    swap(first.cumulative_br_, second.cumulative_br_);
+    swap(first.selector_channels_, second.selector_channels_);
 }
 
 bool DecayTable::operator==(const DecayTable& table) const
@@ -107,26 +114,77 @@ std::ostream& operator<<(std::ostream& os, DecayTable const& table)
 // ------------------------------------------------------------------------- //
 DecayChannel& DecayTable::SelectChannel(double rnd) const
 {
-    double sumBranchingRatio = 0.0;
-    for (DecayMap::const_iterator iter = channels_.begin(); iter != channels_.end(); ++iter)
-    {
-        sumBranchingRatio += iter->first;
-    }
-    rnd = sumBranchingRatio * rnd;
-    double partial_br_sum = 0.0;
+    return *selector_channels_[SelectChannelIndex(rnd)];
+}
 
-    for (DecayMap::const_iterator iter = channels_.begin(); iter != channels_.end(); ++iter)
+// ------------------------------------------------------------------------- //
+void DecayTable::Decay(const ParticleDef& p_def,
+                       const std::vector<ParticleState>& p_conditions,
+                       const std::vector<double>& rnd_channel,
+                       std::vector<ParticleState>& products,
+                       std::vector<size_t>& offsets) const
+{
+    Decay(p_def, p_conditions, rnd_channel, products, offsets,
+          std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get()));
+}
+
+// ------------------------------------------------------------------------- //
+void DecayTable::Decay(const ParticleDef& p_def,
+                       const std::vector<ParticleState>& p_conditions,
+                       const std::vector<double>& rnd_channel,
+                       std::vector<ParticleState>& products,
+                       std::vector<size_t>& offsets,
+                       std::function<double()> rnd) const
+{
+    if (rnd_channel.size() != p_conditions.size())
+        throw std::invalid_argument("One random number per parent is required "
+                                    "for the channel selection.");
+
+    // group the parents by their selected channel
+    std::vector<std::vector<size_t>> parents_per_channel(selector_channels_.size());
+    for (size_t i = 0; i < p_conditions.size(); ++i)
+        parents_per_channel[SelectChannelIndex(rnd_channel[i])].push_back(i);
+
+    std::vector<std::vector<ParticleState>> products_per_parent(p_conditions.size());
+
+    std::vector<ParticleState> group;
+    std::vector<ParticleState> group_products;
+    for (size_t c = 0; c < selector_channels_.size(); ++c)
     {
-        partial_br_sum += iter->first;
+        const auto& parents = parents_per_channel[c];
+        if (parents.empty())
+            continue;
 
-        if (rnd < partial_br_sum)
+        auto many_body = dynamic_cast<ManyBodyPhaseSpace*>(selector_channels_[c]);
+        if (many_body)
         {
-            return *iter->second;
+            group.clear();
+            for (auto i : parents)
+                group.push_back(p_conditions[i]);
+
+            many_body->Decay(p_def, group, group_products, rnd);
+
+            auto n = many_body->GetNumberOfDaughters();
+            for (size_t k = 0; k < parents.size(); ++k)
+                products_per_parent[parents[k]].assign(
+                    group_products.begin() + k * n,
+                    group_products.begin() + (k + 1) * n);
+        } else
+        {
+            for (auto i : parents)
+                products_per_parent[i] = selector_channels_[c]->Decay(p_def, p_conditions[i], rnd);
         }
     }
 
-    Logging::Get("proposal.decay")->error("No decay channel found. If your particle is stable, call \"SetStable\"!");
-    return *channels_.begin()->second; // return first channel just to prevent warnings
+    products.clear();
+    offsets.clear();
+    offsets.reserve(p_conditions.size() + 1);
+    offsets.push_back(0);
+    for (const auto& p : products_per_parent)
+    {
+        products.insert(products.end(), p.begin(), p.end());
+        offsets.push_back(products.size());
+    }
 }
 
 // ------------------------------------------------------------------------- //
@@ -137,12 +195,19 @@ void DecayTable::SetStable()
     // TODO(mario): Find better way Wed 2017/08/23
     // A stable channel which alwas will be selected
     channels_[1.1] = new StableChannel();
+
+    BuildSelector();
 }
 
 // ------------------------------------------------------------------------- //
 DecayTable& DecayTable::addChannel(double Br, const DecayChannel& dc)
 {
+    auto iter = channels_.find(Br);
+    if (iter != channels_.end())
+        delete iter->second;
+
     channels_[Br] = dc.clone();
+    BuildSelector();
     return *this;
 }
 
@@ -170,4 +235,39 @@ void DecayTable::clearTable()
     }
 
     channels_.clear();
+    cumulative_br_.clear();
+    selector_channels_.clear();
+}
+
+// ------------------------------------------------------------------------- //
+void DecayTable::BuildSelector()
+{
+    cumulative_br_.clear();
+    selector_channels_.clear();
+
+    double partial_br_sum = 0.0;
+    for (DecayMap::const_iterator iter = channels_.begin(); iter != channels_.end(); ++iter)
+    {
+        partial_br_sum += iter->first;
+        cumulative_br_.push_back(partial_br_sum);
+        selector_channels_.push_back(iter->second);
+    }
+}
+
+// ------------------------------------------------------------------------- //
+size_t DecayTable::SelectChannelIndex(double rnd) const
+{
+    if (cumulative_br_.empty())
+        throw std::logic_error("No decay channel found. If your particle is stable, call \"SetStable\"!");
+
+    rnd = cumulative_br_.back() * rnd;
+    auto it = std::upper_bound(cumulative_br_.begin(), cumulative_br_.end(), rnd);
+
+    if (it == cumulative_br_.end())
+    {
+        Logging::Get("proposal.decay")->error("No decay channel found. If your particle is stable, call \"SetStable\"!");
+        return 0; // return first channel just to prevent warnings
+    }
+
+    return std::distance(cumulative_br_.begin(), it);
 }
@@ -1,10 +1,10 @@
 #include <functional>
 #include <cmath>
 #include <cassert>
+#include <mutex>
 
 #include "PROPOSAL/Constants.h"
 #include "PROPOSAL/decay/LeptonicDecayChannel.h"
-#include "PROPOSAL/math/RandomGenerator.h"
 #include "PROPOSAL/particle/Particle.h"
 #include "PROPOSAL/particle/ParticleDef.h"
 #include "PROPOSAL/math/MathMethods.h"
@@ -32,6 +32,7 @@ LeptonicDecayChannelApprox::LeptonicDecayChannelApprox(const ParticleDef& lepton
     , massive_lepton_(lepton)
     , neutrino_(neutrino)
     , anti_neutrino_(anti_neutrino)
+    , inverse_rate_cache_(std::make_shared<InverseRateCache>())
 {
 }
 
@@ -44,6 +45,7 @@ LeptonicDecayChannelApprox::LeptonicDecayChannelApprox(const LeptonicDecayChanne
     , massive_lepton_(mode.massive_lepton_)
     , neutrino_(mode.neutrino_)
     , anti_neutrino_(mode.anti_neutrino_)
+    , inverse_rate_cache_(mode.inverse_rate_cache_)
 {
 }
 
@@ -83,40 +85,106 @@ double LeptonicDecayChannelApprox::DifferentialDecayRate(double x, double parent
 }
 
 // ------------------------------------------------------------------------- //
-double LeptonicDecayChannelApprox::FindRoot(double min, double parent_mass, double E_max, double right_side)
+std::shared_ptr<const LeptonicDecayChannelApprox::InverseRateTable>
+LeptonicDecayChannelApprox::GetInverseRateTable(double parent_mass)
 {
-    double max        = 1;
-    double x_start    = 0.5;
-
-    return NewtonRaphson(std::bind(&LeptonicDecayChannelApprox::DecayRate, this, std::placeholders::_1, parent_mass, E_max, right_side),
-                         std::bind(&LeptonicDecayChannelApprox::DifferentialDecayRate, this, std::placeholders::_1, parent_mass, E_max),
-                         min, max, x_start, 40, 1e-3);
+    // the table is built lazily, so the rate of the derived channel is used
+    auto& cache = *inverse_rate_cache_;
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(cache.mutex);
+        auto it = cache.tables.find(parent_mass);
+        if (it != cache.tables.end())
+            return it->second;
+    }
+
+    std::lock_guard<std::shared_timed_mutex> lock(cache.mutex);
+    auto& table = cache.tables[parent_mass];
+    if (!table)
+        table = BuildInverseRateTable(parent_mass);
+    return table;
+}
 
+// ------------------------------------------------------------------------- //
+std::shared_ptr<const LeptonicDecayChannelApprox::InverseRateTable>
+LeptonicDecayChannelApprox::BuildInverseRateTable(double parent_mass)
+{
+    double emax  = (parent_mass * parent_mass + massive_lepton_.mass * massive_lepton_.mass) / (2 * parent_mass);
+    double x_min = massive_lepton_.mass / emax;
+
+    double f_min = DecayRate(x_min, parent_mass, emax, 0.0);
+    double f_max = DecayRate(1.0, parent_mass, emax, 0.0);
+
+    auto table = std::make_shared<InverseRateTable>();
+    auto& x    = table->x;
+    x.resize(INVERSE_RATE_NODES + 1);
+    x.front() = x_min;
+    x.back()  = 1.;
+
+    double x_start = 0.5 * (x_min + 1.);
+    for (size_t i = 1; i < INVERSE_RATE_NODES; ++i) {
+        double u          = static_cast<double>(i) / INVERSE_RATE_NODES;
+        double right_side = f_min + (f_max - f_min) * u * u * u;
+
+        x[i] = NewtonRaphson(
+            [this, parent_mass, emax, right_side](double xx) {
+                return DecayRate(xx, parent_mass, emax, right_side);
+            },
+            [this, parent_mass, emax](double xx) {
+                return DifferentialDecayRate(xx, parent_mass, emax);
+            },
+            x_min, 1., x_start, 100, 1e-10);
+        x_start = x[i];
+    }
+
+    // Node slopes dx/du = 3 u^2 (f_max - f_min) / f'(x). At u = 0 this is
+    // 0/0, there a one-sided finite difference of second order is used.
+    auto& slope = table->slope;
+    slope.resize(x.size());
+    double h = 1. / INVERSE_RATE_NODES;
+    slope.front() = (-3 * x[0] + 4 * x[1] - x[2]) / (2 * h);
+    for (size_t i = 1; i <= INVERSE_RATE_NODES; ++i) {
+        double u = static_cast<double>(i) / INVERSE_RATE_NODES;
+        slope[i] = 3 * u * u * (f_max - f_min)
+            / DifferentialDecayRate(x[i], parent_mass, emax);
+    }
+
+    return table;
+}
 
+// ------------------------------------------------------------------------- //
+double LeptonicDecayChannelApprox::SampleEnergyFraction(const InverseRateTable& table, double rnd)
+{
+    double t = std::cbrt(rnd) * INVERSE_RATE_NODES;
+    size_t i = std::min(static_cast<size_t>(t), INVERSE_RATE_NODES - 1);
+    double s = t - i;
+    double h = 1. / INVERSE_RATE_NODES;
+
+    // cubic hermite between node i and i + 1
+    double s2 = s * s;
+    double s3 = s2 * s;
+    double x  = (2 * s3 - 3 * s2 + 1) * table.x[i] + (s3 - 2 * s2 + s) * h * table.slope[i]
+        + (-2 * s3 + 3 * s2) * table.x[i + 1] + (s3 - s2) * h * table.slope[i + 1];
+
+    return std::min(std::max(x, table.x.front()), table.x.back());
 }
 
 // ------------------------------------------------------------------------- //
-std::vector<ParticleState> LeptonicDecayChannelApprox::Decay(const ParticleDef& p_def, const ParticleState& p_condition)
+std::vector<ParticleState> LeptonicDecayChannelApprox::Decay(const ParticleDef& p_def, const ParticleState& p_condition, std::function<double()> rnd)
 {
     assert (p_condition.direction.magnitude() > 0);
     // Sample energy from decay rate
     double emax       = (p_def.mass * p_def.mass + massive_lepton_.mass * massive_lepton_.mass) / (2 * p_def.mass);
-    double x_min      = massive_lepton_.mass / emax;
-
-    double f_min      = DecayRate(x_min, p_def.mass, emax, 0.0);
-    double f_max      = DecayRate(1.0, p_def.mass, emax, 0.0);
-    double right_side = f_min + (f_max - f_min) * RandomGenerator::Get().RandomDouble();
-
-    double find_root = FindRoot(x_min, p_def.mass, emax, right_side);
+    auto table        = GetInverseRateTable(p_def.mass);
+    double x          = SampleEnergyFraction(*table, rnd());
 
-    double lepton_energy   = std::max(find_root * emax, massive_lepton_.mass);
+    double lepton_energy   = std::max(x * emax, massive_lepton_.mass);
     double lepton_momentum = std::sqrt((lepton_energy - massive_lepton_.mass) * (lepton_energy + massive_lepton_.mass));
 
 
     // Sample directions For the massive letpon
     ParticleState massive_lepton((ParticleType)massive_lepton_.particle_type,
                                  p_condition.position,
-                                 GenerateRandomDirection(),
+                                 GenerateRandomDirection(rnd),
                                  lepton_energy,
                                  p_condition.time,
                                  0.);
@@ -127,7 +195,7 @@ std::vector<ParticleState> LeptonicDecayChannelApprox::Decay(const ParticleDef&
     double momentum_neutrinos = 0.5 * virtual_mass;
 
 
-    auto direction = GenerateRandomDirection();
+    auto direction = GenerateRandomDirection(rnd);
 
     ParticleState neutrino((ParticleType)neutrino_.particle_type,
                            p_condition.position,
@@ -3,6 +3,8 @@
 
 #include <algorithm> // std::sort
 #include <cmath>
+#include <mutex>
+#include <random>
 
 #include "PROPOSAL/Constants.h"
 #include "PROPOSAL/decay/ManyBodyPhaseSpace.h"
@@ -103,18 +105,63 @@ bool ManyBodyPhaseSpace::compare(const DecayChannel& channel) const
 }
 
 // ------------------------------------------------------------------------- //
-std::vector<ParticleState> ManyBodyPhaseSpace::Decay(const ParticleDef& p_def, const ParticleState& p_condition)
+std::vector<ParticleState> ManyBodyPhaseSpace::Decay(const ParticleDef& p_def, const ParticleState& p_condition, std::function<double()> rnd)
 {
-    // Create vector for decay products
-    std::vector<ParticleState> products;
+    // prefactor for the phase space density
+    PhaseSpaceParameters params = GetPhaseSpaceParams(p_def);
 
-    for (auto p : daughters_) {
-        products.emplace_back((ParticleType)p->particle_type, p_condition.position, p_condition.direction, p_condition.energy, p_condition.time, 0);
-    }
+    Workspace workspace;
+    DecayEvent(p_def, params, p_condition, workspace, rnd);
 
-    // prefactor for the phase space density
+    return std::move(workspace.products);
+}
+
+// ------------------------------------------------------------------------- //
+void ManyBodyPhaseSpace::Decay(const ParticleDef& p_def,
+                               const std::vector<ParticleState>& p_conditions,
+                               std::vector<ParticleState>& products)
+{
+    Decay(p_def, p_conditions, products, std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get()));
+}
+
+// ------------------------------------------------------------------------- //
+void ManyBodyPhaseSpace::Decay(const ParticleDef& p_def,
+                               const std::vector<ParticleState>& p_conditions,
+                               std::vector<ParticleState>& products,
+                               std::function<double()> rnd)
+{
     PhaseSpaceParameters params = GetPhaseSpaceParams(p_def);
-    PhaseSpaceKinematics kinematics;
+
+    Workspace workspace;
+    workspace.products.reserve(daughters_.size());
+    workspace.randoms.reserve(daughters_.size());
+    workspace.kinematics.virtual_masses.reserve(daughters_.size());
+    workspace.kinematics.momenta.reserve(daughters_.size());
+
+    products.resize(p_conditions.size() * daughters_.size());
+
+    auto out = products.begin();
+    for (const auto& p_condition : p_conditions)
+    {
+        DecayEvent(p_def, params, p_condition, workspace, rnd);
+        out = std::copy(workspace.products.begin(), workspace.products.end(), out);
+    }
+}
+
+// ------------------------------------------------------------------------- //
+void ManyBodyPhaseSpace::DecayEvent(const ParticleDef& p_def,
+                                    const PhaseSpaceParameters& params,
+                                    const ParticleState& p_condition,
+                                    Workspace& workspace,
+                                    const std::function<double()>& rnd)
+{
+    auto& products = workspace.products;
+    auto& kinematics = workspace.kinematics;
+
+    products.clear();
+    for (const auto& p : daughters_) {
+        products.emplace_back((ParticleType)p->particle_type, p_condition.position, p_condition.direction, p_condition.energy, p_condition.time, 0);
+    }
 
     if (uniform_)
     {
@@ -123,10 +170,10 @@ std::vector<ParticleState> ManyBodyPhaseSpace::Decay(const ParticleDef& p_def, c
         do
         {
             // precalculated kinematics
-            kinematics = CalculateKinematics(params.normalization, p_def.mass);
-            GenerateEvent(products, kinematics);
+            CalculateKinematics(kinematics, workspace.randoms, params.normalization, p_def.mass, rnd);
+            GenerateEvent(products, kinematics, rnd);
             // sample product states with rejection sampling
-            weight_ref = params.weight_min + RandomGenerator::Get().RandomDouble() * (params.weight_max - params.weight_min);
+            weight_ref = params.weight_min + rnd() * (params.weight_max - params.weight_min);
             weight_sample = kinematics.weight * matrix_element_(p_condition, products);
 
         } while(weight_ref > weight_sample);
@@ -134,8 +181,8 @@ std::vector<ParticleState> ManyBodyPhaseSpace::Decay(const ParticleDef& p_def, c
     else
     {
         // precalculated kinematics
-        kinematics = CalculateKinematics(params.normalization, p_def.mass);
-        GenerateEvent(products, kinematics);
+        CalculateKinematics(kinematics, workspace.randoms, params.normalization, p_def.mass, rnd);
+        GenerateEvent(products, kinematics, rnd);
     }
 
     // Get Momentum is not defined for pseudo particle decay, so it must be
@@ -143,15 +190,13 @@ std::vector<ParticleState> ManyBodyPhaseSpace::Decay(const ParticleDef& p_def, c
     double primary_momentum = std::sqrt(std::max((p_condition.energy + p_def.mass) * (p_condition.energy - p_def.mass), 0.0));
     // Boost all products in Lab frame (the reason, why the boosting goes in the negative direction of the particle)
     Boost(products, -p_condition.direction, p_condition.energy/p_def.mass, primary_momentum / p_def.mass);
-
-    return products;
 }
 
 // ------------------------------------------------------------------------- //
-void ManyBodyPhaseSpace::GenerateEvent(std::vector<ParticleState>& products, const PhaseSpaceKinematics& kinematics)
+void ManyBodyPhaseSpace::GenerateEvent(std::vector<ParticleState>& products, const PhaseSpaceKinematics& kinematics, const std::function<double()>& rnd)
 {
     // Calculate first momentum in R2
-    Cartesian3D direction = GenerateRandomDirection();
+    Cartesian3D direction = GenerateRandomDirection(rnd);
 
     products[1].direction = direction;
     products[1].SetMomentum(kinematics.momenta[0]);
@@ -165,7 +210,7 @@ void ManyBodyPhaseSpace::GenerateEvent(std::vector<ParticleState>& products, con
     {
         double momentum = kinematics.momenta[i-1];
 
-        products[i].direction = GenerateRandomDirection();
+        products[i].direction = GenerateRandomDirection(rnd);
         products[i].SetMomentum(momentum);
 
         // Boost previous particles to new frame
@@ -201,7 +246,17 @@ double ManyBodyPhaseSpace::Evaluate(const ParticleState& p_condition, const std:
 // ------------------------------------------------------------------------- //
 ManyBodyPhaseSpace::PhaseSpaceParameters ManyBodyPhaseSpace::GetPhaseSpaceParams(const ParticleDef& parent_def)
 {
-    ParameterMap::iterator it = parameter_map_.find(parent_def);
+    ParameterKey key(parent_def.particle_type, parent_def.mass);
+
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(parameter_mutex_);
+        ParameterMap::iterator it = parameter_map_.find(key);
+        if (it != parameter_map_.end())
+            return it->second;
+    }
+
+    std::lock_guard<std::shared_timed_mutex> lock(parameter_mutex_);
+    ParameterMap::iterator it = parameter_map_.find(key);
 
     if (it != parameter_map_.end())
     {
@@ -213,7 +268,7 @@ ManyBodyPhaseSpace::PhaseSpaceParameters ManyBodyPhaseSpace::GetPhaseSpaceParams
         params.normalization = CalculateNormalization(parent_def.mass);
         estimate_(params, parent_def);
 
-        parameter_map_[parent_def] = params;
+        parameter_map_[key] = params;
 
         return params;
     }
@@ -264,17 +319,23 @@ void ManyBodyPhaseSpace::SampleEstimateMaxWeight(PhaseSpaceParameters& params, c
     particle.type = parent_def.particle_type;
     particle.energy = parent_def.mass;
 
+    // The estimate has its own generator, so the parameters do not depend on
+    // the decay that asks for them first
+    std::mt19937 rng;
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::function<double()> rnd = [&rng, &uniform]() { return uniform(rng); };
+
     // initialization of weights
-    PhaseSpaceKinematics kinematics = CalculateKinematics(params.normalization, parent_def.mass);
-    GenerateEvent(products, kinematics);
+    PhaseSpaceKinematics kinematics = CalculateKinematics(params.normalization, parent_def.mass, rnd);
+    GenerateEvent(products, kinematics, rnd);
     double result = kinematics.weight * matrix_element_(particle, products);
     params.weight_min = result;
     params.weight_max = result;
 
     for (int i = 1; i < broad_phase_statistic_; ++i)
     {
-        kinematics = CalculateKinematics(params.normalization, parent_def.mass);
-        GenerateEvent(products, kinematics);
+        kinematics = CalculateKinematics(params.normalization, parent_def.mass, rnd);
+        GenerateEvent(products, kinematics, rnd);
         result = kinematics.weight * matrix_element_(particle, products);
 
         if (result < params.weight_min)
@@ -290,19 +351,33 @@ void ManyBodyPhaseSpace::SampleEstimateMaxWeight(PhaseSpaceParameters& params, c
 }
 
 // ------------------------------------------------------------------------- //
-ManyBodyPhaseSpace::PhaseSpaceKinematics ManyBodyPhaseSpace::CalculateKinematics(double normalization, double parent_mass)
+ManyBodyPhaseSpace::PhaseSpaceKinematics ManyBodyPhaseSpace::CalculateKinematics(double normalization, double parent_mass, const std::function<double()>& rnd)
 {
     PhaseSpaceKinematics kinematics;
-
-    // Create sorted random numbers
     std::vector<double> randoms;
-    randoms.reserve(daughters_.size());
 
+    CalculateKinematics(kinematics, randoms, normalization, parent_mass, rnd);
+
+    return kinematics;
+}
+
+// ------------------------------------------------------------------------- //
+void ManyBodyPhaseSpace::CalculateKinematics(PhaseSpaceKinematics& kinematics,
+                                             std::vector<double>& randoms,
+                                             double normalization,
+                                             double parent_mass,
+                                             const std::function<double()>& rnd)
+{
+    kinematics.virtual_masses.clear();
+    kinematics.momenta.clear();
+
+    // Create sorted random numbers
+    randoms.clear();
     randoms.push_back(0.0);
 
     for (unsigned int i = 0; i < daughter_masses_.size() - 2; ++i)
     {
-        randoms.push_back(RandomGenerator::Get().RandomDouble());
+        randoms.push_back(rnd());
     }
 
     randoms.push_back(1.0);
@@ -329,8 +404,6 @@ ManyBodyPhaseSpace::PhaseSpaceKinematics ManyBodyPhaseSpace::CalculateKinematics
     }
 
     kinematics.weight = normalization * weight;
-
-    return kinematics;
 }
 
 // ------------------------------------------------------------------------- //
@@ -29,7 +29,7 @@ bool StableChannel::compare(const DecayChannel& channel) const
         return true;
 }
 
-std::vector<ParticleState> StableChannel::Decay(const ParticleDef&, const ParticleState&)
+std::vector<ParticleState> StableChannel::Decay(const ParticleDef&, const ParticleState&, std::function<double()>)
 {
     // return empty vector;
     std::vector<ParticleState> vec;
@@ -1,6 +1,5 @@
 
 #include "PROPOSAL/decay/TwoBodyPhaseSpace.h"
-#include "PROPOSAL/math/RandomGenerator.h"
 #include "PROPOSAL/particle/Particle.h"
 #include "PROPOSAL/particle/ParticleDef.h"
 
@@ -38,14 +37,14 @@ bool TwoBodyPhaseSpace::compare(const DecayChannel& channel) const
         return true;
 }
 
-std::vector<ParticleState> TwoBodyPhaseSpace::Decay(const ParticleDef& p_def, const ParticleState& p_condition)
+std::vector<ParticleState> TwoBodyPhaseSpace::Decay(const ParticleDef& p_def, const ParticleState& p_condition, std::function<double()> rnd)
 {
     std::vector<ParticleState> products;
     products.emplace_back((ParticleType)first_daughter_.particle_type, p_condition.position, p_condition.direction, p_condition.energy, p_condition.time, 0);
     products.emplace_back((ParticleType)second_daughter_.particle_type, p_condition.position, p_condition.direction, p_condition.energy, p_condition.time, 0);
 
     double momentum    = Momentum(p_def.mass, first_daughter_.mass, second_daughter_.mass);
-    auto direction = GenerateRandomDirection();
+    auto direction = GenerateRandomDirection(rnd);
 
     products[0].direction = direction;
     products[0].SetMomentum(momentum);
@@ -4,8 +4,10 @@
 #include "PROPOSAL/density_distr/density_distr.h"
 #include "PROPOSAL/density_distr/density_exponential.h"
 #include "PROPOSAL/density_distr/density_homogeneous.h"
+#include "PROPOSAL/density_distr/density_layered.h"
 #include "PROPOSAL/density_distr/density_polynomial.h"
 #include "PROPOSAL/density_distr/density_splines.h"
+#include "PROPOSAL/density_distr/density_voxel.h"
 #include "PROPOSAL/medium/Medium.h"
 #include "PROPOSAL/math/Cartesian3D.h"
 #include <nlohmann/json.hpp>
@@ -153,10 +155,14 @@ std::shared_ptr<Density_distr> PROPOSAL::CreateDensityDistribution(const nlohman
             return std::make_shared<Density_polynomial>(config);
         } else if (density_distr_type == "spline") {
             return std::make_shared<Density_splines>(config);
+        } else if (density_distr_type == "layered" || density_distr_type == "prem") {
+            return std::make_shared<Density_layered>(config);
+        } else if (density_distr_type == "voxel") {
+            return std::make_shared<Density_voxel>(config);
         } else {
             throw std::invalid_argument("Density distribution config file must contain a paremeter called "
                                         "'type' with one of the keywords 'exponential', 'homogeneous',"
-                                        " 'polynomial' or 'spline'.");
+                                        " 'polynomial', 'spline', 'layered', 'prem' or 'voxel'.");
         }
     }
     else{
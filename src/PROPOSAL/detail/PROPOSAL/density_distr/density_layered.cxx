@@ -0,0 +1,250 @@
+
+#include <algorithm>
+#include <cmath>
+#include "PROPOSAL/density_distr/density_layered.h"
+#include "PROPOSAL/math/MathMethods.h"
+#include <nlohmann/json.hpp>
+
+using namespace PROPOSAL;
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// %%%%%%%%%%%%%%%%%%%%% Layered-Density %%%%%%%%%%%%%%%%%%%%%
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+constexpr double Density_layered::EARTH_RADIUS;
+
+namespace {
+std::vector<Density_layered::Layer> layers_from_json(const nlohmann::json& config) {
+    std::string type = config.at("type");
+    if (type == "prem")
+        return Density_layered::PREM();
+    if (!config.contains("layers"))
+        throw std::invalid_argument("Density_layered: layers must be defined in json");
+    std::vector<Density_layered::Layer> layers;
+    for (const auto& layer : config["layers"]) {
+        if (layer.contains("medium"))
+            throw std::invalid_argument("Density_layered: the layers only "
+                                        "define the density, a medium per "
+                                        "layer needs one sector per layer");
+        layers.push_back({layer.at("outer_radius").get<double>(),
+                          layer.at("coefficients").get<std::vector<double>>()});
+    }
+    return layers;
+}
+
+double radius_scale_from_json(const nlohmann::json& config) {
+    if (config.at("type").get<std::string>() == "prem")
+        return config.value("radius_scale", Density_layered::EARTH_RADIUS);
+    return config.value("radius_scale", 1.);
+}
+}  // namespace
+
+Density_layered::Density_layered(const Vector3D& center,
+                                 std::vector<Layer> layers,
+                                 double radius_scale,
+                                 double density_scale)
+    : Density_distr(RadialAxis(center), density_scale),
+      layers_(std::move(layers)),
+      radius_scale_(radius_scale) {
+    if (layers_.empty())
+        throw std::invalid_argument("Density_layered: at least one layer is required.");
+    if (radius_scale_ <= 0)
+        throw std::invalid_argument("Density_layered: radius_scale must be positive.");
+    auto inner_radius = 0.;
+    for (const auto& layer : layers_) {
+        if (layer.outer_radius <= inner_radius)
+            throw std::invalid_argument("Density_layered: the outer radii of "
+                                        "the layers must be increasing.");
+        if (layer.coefficients.empty())
+            throw std::invalid_argument("Density_layered: every layer needs "
+                                        "at least one coefficient.");
+        inner_radius = layer.outer_radius;
+        outer_x_.push_back(layer.outer_radius / radius_scale_);
+    }
+}
+
+Density_layered::Density_layered(const nlohmann::json& config)
+    : Density_layered(Cartesian3D(config.value("fp0", std::array<double, 3>{0., 0., 0.})),
+                      layers_from_json(config),
+                      radius_scale_from_json(config),
+                      config.value("density_scale", 1.)) {}
+
+std::vector<Density_layered::Layer> Density_layered::PREM() {
+    // radii in km, density in g/cm^3 as polynomial in r / 6371 km
+    std::vector<Layer> layers = {
+        {1221.5, {13.0885, 0., -8.8381}},                 // inner core
+        {3480.0, {12.5815, -1.2638, -3.6426, -5.5281}},   // outer core
+        {5701.0, {7.9565, -6.4761, 5.5283, -3.0807}},     // lower mantle
+        {5771.0, {5.3197, -1.4836}},                      // transition zone
+        {5971.0, {11.2494, -8.0298}},
+        {6151.0, {7.1089, -3.8045}},
+        {6346.6, {2.6910, 0.6924}},                       // LVZ and LID
+        {6356.0, {2.900}},                                // lower crust
+        {6368.0, {2.600}},                                // upper crust
+        {6371.0, {1.020}},                                // ocean
+    };
+    for (auto& layer : layers)
+        layer.outer_radius *= 1e5;
+    return layers;
+}
+
+bool Density_layered::compare(const Density_distr& dens_distr) const {
+    auto dens_layered = dynamic_cast<const Density_layered*>(&dens_distr);
+    if (!dens_layered)
+        return false;
+    if (radius_scale_ != dens_layered->radius_scale_)
+        return false;
+    if (layers_.size() != dens_layered->layers_.size())
+        return false;
+    for (size_t i = 0; i < layers_.size(); ++i) {
+        if (layers_[i].outer_radius != dens_layered->layers_[i].outer_radius)
+            return false;
+        if (layers_[i].coefficients != dens_layered->layers_[i].coefficients)
+            return false;
+    }
+    return true;
+}
+
+Density_layered::Chord Density_layered::GetChord(const Vector3D& xi,
+                                                 const Vector3D& direction) const {
+    auto q = (Cartesian3D(xi) - axis_->GetFp0()) * (1. / radius_scale_);
+    auto s0 = q * Cartesian3D(direction);
+    return {s0, std::max(q * q - s0 * s0, 0.)};
+}
+
+int Density_layered::GetLayer(double x) const {
+    auto it = std::upper_bound(outer_x_.begin(), outer_x_.end(), x);
+    if (it == outer_x_.end())
+        return -1;
+    return std::distance(outer_x_.begin(), it);
+}
+
+double Density_layered::EvaluateLayer(int layer, double x) const {
+    if (layer < 0)
+        return 0.;
+    const auto& c = layers_[layer].coefficients;
+    auto rho = 0.;
+    for (auto it = c.rbegin(); it != c.rend(); ++it)
+        rho = rho * x + *it;
+    return massDensity_ * rho;
+}
+
+double Density_layered::IntegrateLayer(int layer, const Chord& chord, double s) const {
+    // Antiderivative of r^k along the chord, r = sqrt(b^2 + s^2):
+    // I_k = s r^k / (k + 1) + k b^2 / (k + 1) I_{k-2},
+    // starting with I_0 = s and b^2 I_{-1} = b^2 asinh(s / b).
+    if (layer < 0)
+        return 0.;
+    const auto& c = layers_[layer].coefficients;
+    auto r = std::sqrt(chord.b2 + s * s);
+    auto I_even = s;
+    auto I_odd = chord.b2 > 0 ? std::asinh(s / std::sqrt(chord.b2)) : 0.;
+    auto r_k = 1.;
+    auto sum = 0.;
+    for (size_t k = 0; k < c.size(); ++k) {
+        auto& I = (k % 2 == 0) ? I_even : I_odd;
+        if (k > 0)
+            I = (s * r_k + k * chord.b2 * I) / (k + 1);
+        sum += c[k] * I;
+        r_k *= r;
+    }
+    return massDensity_ * sum;
+}
+
+template <typename Function>
+void Density_layered::ForEachPiece(const Chord& chord, double s_begin,
+                                   double s_end, Function&& f) const {
+    std::vector<double> borders = {0.};
+    for (auto x : outer_x_) {
+        if (x * x > chord.b2) {
+            auto h = std::sqrt(x * x - chord.b2);
+            borders.push_back(-h);
+            borders.push_back(h);
+        }
+    }
+    std::sort(borders.begin(), borders.end());
+
+    auto low = s_begin;
+    auto piece = [&](double high) {
+        auto mid = 0.5 * (low + high);
+        auto layer = GetLayer(std::sqrt(chord.b2 + mid * mid));
+        auto proceed = f(layer, low, high);
+        low = high;
+        return proceed;
+    };
+    for (auto border : borders) {
+        if (border <= s_begin)
+            continue;
+        if (border >= s_end)
+            break;
+        if (!piece(border))
+            return;
+    }
+    if (low < s_end)
+        piece(s_end);
+}
+
+double Density_layered::Correct(const Vector3D& xi,
+                                const Vector3D& direction,
+                                double res,
+                                double distance_to_border) const {
+    if (res <= 0.)
+        return 0.;
+    auto chord = GetChord(xi, direction);
+    auto target = res / radius_scale_;
+    auto s_end = chord.s0 + distance_to_border / radius_scale_;
+
+    auto grammage = 0.;
+    auto distance = -1.;
+    ForEachPiece(chord, chord.s0, s_end, [&](int layer, double low, double high) {
+        if (layer < 0)
+            return true;
+        auto F_low = IntegrateLayer(layer, chord, low);
+        auto piece = IntegrateLayer(layer, chord, high) - F_low;
+        if (grammage + piece < target) {
+            grammage += piece;
+            return true;
+        }
+        auto rest = target - grammage;
+        auto s = low;
+        if (rest > 0) {
+            auto F = [&](double x) { return IntegrateLayer(layer, chord, x) - F_low - rest; };
+            auto dF = [&](double x) {
+                return EvaluateLayer(layer, std::sqrt(chord.b2 + x * x));
+            };
+            s = NewtonRaphson(F, dF, low, high, low + (high - low) * rest / piece,
+                              100, 1e-6 / radius_scale_);
+        }
+        distance = (s - chord.s0) * radius_scale_;
+        return false;
+    });
+
+    if (distance < 0)
+        throw DensityException("Next interaction point lies in infinite.");
+    return distance;
+}
+
+double Density_layered::Integrate(const Vector3D& xi,
+                                  const Vector3D& direction,
+                                  double l) const {
+    auto chord = GetChord(xi, direction);
+    auto grammage = 0.;
+    ForEachPiece(chord, chord.s0, chord.s0 + l / radius_scale_,
+                 [&](int layer, double low, double high) {
+                     grammage += IntegrateLayer(layer, chord, high)
+                                 - IntegrateLayer(layer, chord, low);
+                     return true;
+                 });
+    return grammage * radius_scale_;
+}
+
+double Density_layered::Calculate(const Vector3D& xi,
+                                  const Vector3D& direction,
+                                  double distance) const {
+    return Integrate(xi, direction, distance);
+}
+
+double Density_layered::Evaluate(const Vector3D& xi) const {
+    auto x = axis_->GetDepth(xi) / radius_scale_;
+    return EvaluateLayer(GetLayer(x), x);
+}
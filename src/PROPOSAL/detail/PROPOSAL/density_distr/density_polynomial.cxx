@@ -16,7 +16,8 @@ Density_polynomial::Density_polynomial(const Axis& axis, const Polynom& polynom,
       polynom_(polynom),
       Polynom_(polynom_.GetAntiderivative(0)),
       density_distribution(polynom_.GetFunction()),
-      antiderived_density_distribution(Polynom_.GetFunction()) {}
+      antiderived_density_distribution(Polynom_.GetFunction()),
+      antiderivative_coefficients_(Polynom_.GetCoefficient()) {}
 
 Density_polynomial::Density_polynomial(const Axis& axis, const Polynom& polynom, const Medium& medium)
     : Density_polynomial(axis, polynom, medium.GetMassDensity()) {}
@@ -26,13 +27,15 @@ Density_polynomial::Density_polynomial(const Density_polynomial& dens)
       polynom_(dens.polynom_),
       Polynom_(dens.Polynom_),
       density_distribution(polynom_.GetFunction()),
-      antiderived_density_distribution(Polynom_.GetFunction()) {}
+      antiderived_density_distribution(Polynom_.GetFunction()),
+      antiderivative_coefficients_(dens.antiderivative_coefficients_) {}
 
 Density_polynomial::Density_polynomial(const nlohmann::json& config) : Density_distr(config),
     polynom_(config),
     Polynom_(polynom_.GetAntiderivative(0)),
     density_distribution(polynom_.GetFunction()),
-    antiderived_density_distribution(Polynom_.GetFunction()) {}
+    antiderived_density_distribution(Polynom_.GetFunction()),
+    antiderivative_coefficients_(Polynom_.GetCoefficient()) {}
 
 
 Density_polynomial::~Density_polynomial() {}
@@ -46,40 +49,31 @@ bool Density_polynomial::compare(const Density_distr& dens_distr) const {
     return true;
 }
 
-double Density_polynomial::Helper_function(const Vector3D& xi,
-                                           const Vector3D& direction,
-                                           double res,
-                                           double l) const {
-    return Integrate(xi, direction, 0) - Integrate(xi, direction, l) + res;
-}
-
-double Density_polynomial::helper_function(const Vector3D& xi,
-                                           const Vector3D& direction,
-                                           double res,
-                                           double l) const {
-    (void)res;
-    Cartesian3D dir_cartesian(direction);
-    return Evaluate(xi) - Evaluate(xi + l * dir_cartesian);
-}
-
 double Density_polynomial::Correct(const Vector3D& xi,
                                    const Vector3D& direction,
                                    double res,
                                    double distance_to_border) const {
-    auto F = [&](double l) {return Helper_function(xi, direction, res, l);};
-    auto dF = [&](double l) {return helper_function(xi, direction, res, l);};
+    double delta = axis_->GetEffectiveDistance(xi, direction);
 
-    // check if direction * axis larger or less than zero
-    // direction * fAxis_
+    if (delta == 0.) {
+        // the density is constant along the track
+        auto density = Evaluate(xi);
+        if (density <= 0. || res > density * distance_to_border)
+            throw DensityException("Next interaction point lies in infinite.");
+        return res / density;
+    }
 
+    // Calculate is a polynomial in the depth d + l * delta, so the
+    // displacement follows from the roots of the antiderivative
+    double depth = axis_->GetDepth(xi);
+    double target = antiderived_density_distribution(depth) + res * delta * delta / massDensity_;
     try {
-        res =
-            NewtonRaphson(F, dF, 0, distance_to_border, distance_to_border / 2);
+        auto depth_end = SolvePolynomial(antiderivative_coefficients_, target, depth,
+                                         depth + distance_to_border * delta);
+        return (depth_end - depth) / delta;
     } catch (MathException& e) {
         throw DensityException("Next interaction point lies in infinite.");
     }
-
-    return res;
 }
 
 double Density_polynomial::Integrate(const Vector3D& xi,
@@ -94,6 +88,8 @@ double Density_polynomial::Integrate(const Vector3D& xi,
 double Density_polynomial::Calculate(const Vector3D& xi,
                                      const Vector3D& direction,
                                      double distance) const {
+    if (axis_->GetEffectiveDistance(xi, direction) == 0.)
+        return Evaluate(xi) * distance;
     return Integrate(xi, direction, distance) - Integrate(xi, direction, 0);
 }
 
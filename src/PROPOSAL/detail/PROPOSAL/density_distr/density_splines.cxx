@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <functional>
 #include "PROPOSAL/density_distr/density_splines.h"
 #include "PROPOSAL/medium/Medium.h"
@@ -12,6 +13,7 @@ Density_splines::Density_splines(const Axis& axis, const Spline& splines, double
       spline_(splines.clone()),
       integrated_spline_(splines.clone()) {
     integrated_spline_->Antiderivative(0);
+    InitSegments();
 }
 
 Density_splines::Density_splines(const PROPOSAL::Axis& axis, const PROPOSAL::Spline& splines, const Medium& medium)
@@ -19,8 +21,10 @@ Density_splines::Density_splines(const PROPOSAL::Axis& axis, const PROPOSAL::Spl
 
 Density_splines::Density_splines(const Density_splines& dens_splines)
     : Density_distr(dens_splines),
-      spline_(dens_splines.spline_),
-      integrated_spline_(dens_splines.integrated_spline_) {}
+      spline_(dens_splines.spline_->clone()),
+      integrated_spline_(dens_splines.integrated_spline_->clone()),
+      segment_borders_(dens_splines.segment_borders_),
+      segment_antiderivatives_(dens_splines.segment_antiderivatives_) {}
 
 Density_splines::Density_splines(const nlohmann::json& config) : Density_distr(config) {
     if(!config.contains("spline_type"))
@@ -36,6 +40,29 @@ Density_splines::Density_splines(const nlohmann::json& config) : Density_distr(c
         throw std::invalid_argument("Density_splines: Type of spline must be linear or cubic");
     }
     integrated_spline_->Antiderivative(0);
+    InitSegments();
+}
+
+void Density_splines::InitSegments() {
+    segment_borders_ = integrated_spline_->GetSubintervalls();
+    for (const auto& polynom : integrated_spline_->GetFunctions())
+        segment_antiderivatives_.push_back(polynom.GetCoefficient());
+}
+
+size_t Density_splines::GetSegment(double depth) const {
+    // the first and the last segment are extrapolated, so only the inner
+    // borders are searched
+    auto it = std::upper_bound(segment_borders_.begin() + 1,
+                               segment_borders_.end() - 1, depth);
+    return std::distance(segment_borders_.begin() + 1, it);
+}
+
+double Density_splines::EvaluateAntiderivative(size_t segment, double depth) const {
+    const auto& coefficients = segment_antiderivatives_[segment];
+    auto aux = 0.;
+    for (auto it = coefficients.rbegin(); it != coefficients.rend(); ++it)
+        aux = aux * depth + *it;
+    return aux;
 }
 
 
@@ -70,31 +97,61 @@ double Density_splines::Correct(const Vector3D& xi,
                                 const Vector3D& direction,
                                 double res,
                                 double distance_to_border) const {
-    auto F = [&](double l) {return Helper_function(xi, direction, res, l);};
-    auto dF = [&](double l) {return helper_function(xi, direction, res, l);};
-
-    try {
-        res =
-            NewtonRaphson(F, dF, 0, distance_to_border, distance_to_border / 2);
-    } catch (MathException& e) {
-        throw DensityException("Next interaction point lies in infinite.");
+    double delta = axis_->GetEffectiveDistance(xi, direction);
+
+    if (delta == 0.) {
+        // the density is constant along the track
+        auto density = Evaluate(xi);
+        if (density <= 0. || res > density * distance_to_border)
+            throw DensityException("Next interaction point lies in infinite.");
+        return res / density;
     }
 
-    return res;
+    // Walk along the segments in the direction of the track until the
+    // antiderivative passes the target, then solve the polynomial of this
+    // segment for the depth.
+    double depth = axis_->GetDepth(xi);
+    double depth_end = depth + distance_to_border * delta;
+    auto segment = GetSegment(depth);
+    double target = EvaluateAntiderivative(segment, depth) + res * delta * delta / massDensity_;
+    auto last_segment = segment_antiderivatives_.size() - 1;
+
+    double low = depth;
+    while (true) {
+        double high;
+        if (delta > 0)
+            high = (segment == last_segment) ? depth_end : std::min(depth_end, segment_borders_[segment + 1]);
+        else
+            high = (segment == 0) ? depth_end : std::max(depth_end, segment_borders_[segment]);
+
+        try {
+            auto depth_target = SolvePolynomial(segment_antiderivatives_[segment], target, low, high);
+            return (depth_target - depth) / delta;
+        } catch (MathException& e) {
+            // target is not reached in this segment
+        }
+        if (high == depth_end)
+            break;
+        low = high;
+        segment = (delta > 0) ? segment + 1 : segment - 1;
+    }
+    throw DensityException("Next interaction point lies in infinite.");
 }
 
 double Density_splines::Integrate(const Vector3D& xi,
                                   const Vector3D& direction,
                                   double l) const {
     double delta = axis_->GetEffectiveDistance(xi, direction);
+    double depth = axis_->GetDepth(xi) + l * delta;
 
-    return massDensity_ / (delta * delta) *
-           integrated_spline_->evaluate(axis_->GetDepth(xi) + l * delta);
+    return massDensity_ / (delta * delta) * EvaluateAntiderivative(GetSegment(depth), depth);
 }
 
 double Density_splines::Calculate(const Vector3D& xi,
                                   const Vector3D& direction,
                                   double distance) const {
+    if (axis_->GetEffectiveDistance(xi, direction) == 0.)
+        return Evaluate(xi) * distance;
     return Integrate(xi, direction, distance) - Integrate(xi, direction, 0);
 }
 
@@ -0,0 +1,28 @@
+#include <typeinfo>
+
+#include "PROPOSAL/density_distr/density_variant.h"
+
+using namespace PROPOSAL;
+
+DensityVariant::DensityVariant(const Density_distr& density)
+    : density_(&density)
+    , type_(Type::Other)
+    , mass_density_(0.)
+{
+    // the type has to match exactly, derived classes might override the
+    // methods of the built-in distributions
+    const auto& type = typeid(density);
+    if (type == typeid(Density_homogeneous)) {
+        type_ = Type::Homogeneous;
+        mass_density_ = density.Evaluate(Cartesian3D());
+    } else if (type == typeid(Density_exponential))
+        type_ = Type::Exponential;
+    else if (type == typeid(Density_polynomial))
+        type_ = Type::Polynomial;
+    else if (type == typeid(Density_splines))
+        type_ = Type::Splines;
+    else if (type == typeid(Density_layered))
+        type_ = Type::Layered;
+    else if (type == typeid(Density_voxel))
+        type_ = Type::Voxel;
+}
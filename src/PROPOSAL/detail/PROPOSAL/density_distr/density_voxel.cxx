@@ -0,0 +1,271 @@
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include "PROPOSAL/Constants.h"
+#include "PROPOSAL/density_distr/density_voxel.h"
+#include <nlohmann/json.hpp>
+
+using namespace PROPOSAL;
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// %%%%%%%%%%%%%%%%%%%%%%   Voxel-Grid   %%%%%%%%%%%%%%%%%%%%%
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+constexpr uint32_t VoxelGrid::MAGIC;
+constexpr uint32_t VoxelGrid::VERSION;
+
+namespace {
+template <typename T> void write_values(std::ostream& os, const T* values, size_t n) {
+    os.write(reinterpret_cast<const char*>(values), n * sizeof(T));
+}
+
+template <typename T> void read_values(std::istream& is, T* values, size_t n) {
+    is.read(reinterpret_cast<char*>(values), n * sizeof(T));
+}
+}  // namespace
+
+VoxelGrid VoxelGrid::Read(const std::string& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.good())
+        throw std::invalid_argument("VoxelGrid: could not open " + path);
+
+    uint32_t magic, version;
+    read_values(file, &magic, 1);
+    read_values(file, &version, 1);
+    if (!file || magic != MAGIC)
+        throw std::invalid_argument("VoxelGrid: " + path + " is not a voxel grid file.");
+    if (version != VERSION)
+        throw std::invalid_argument("VoxelGrid: unsupported version " + std::to_string(version));
+
+    VoxelGrid grid;
+    uint64_t n[3];
+    double origin[3];
+    uint8_t has_media;
+    read_values(file, n, 3);
+    read_values(file, origin, 3);
+    read_values(file, grid.spacing.data(), 3);
+    read_values(file, &has_media, 1);
+    if (!file)
+        throw std::invalid_argument("VoxelGrid: header of " + path + " is truncated.");
+    for (size_t k = 0; k < 3; ++k) {
+        if (n[k] == 0 || !(grid.spacing[k] > 0))
+            throw std::invalid_argument("VoxelGrid: the grid in " + path + " is empty.");
+        grid.n[k] = n[k];
+    }
+    grid.origin = Cartesian3D(origin[0], origin[1], origin[2]);
+
+    grid.values.resize(grid.size());
+    read_values(file, grid.values.data(), grid.size());
+    if (has_media) {
+        grid.media.resize(grid.size());
+        read_values(file, grid.media.data(), grid.size());
+    }
+    if (!file)
+        throw std::invalid_argument("VoxelGrid: " + path + " is truncated.");
+    return grid;
+}
+
+void VoxelGrid::Write(const std::string& path) const {
+    if (values.size() != size() || (!media.empty() && media.size() != size()))
+        throw std::invalid_argument("VoxelGrid: number of values does not match the grid size.");
+
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.good())
+        throw std::invalid_argument("VoxelGrid: could not open " + path);
+
+    uint64_t n_out[3] = {n[0], n[1], n[2]};
+    double origin_out[3] = {origin.GetX(), origin.GetY(), origin.GetZ()};
+    uint8_t has_media = !media.empty();
+    write_values(file, &MAGIC, 1);
+    write_values(file, &VERSION, 1);
+    write_values(file, n_out, 3);
+    write_values(file, origin_out, 3);
+    write_values(file, spacing.data(), 3);
+    write_values(file, &has_media, 1);
+    write_values(file, values.data(), values.size());
+    write_values(file, media.data(), media.size());
+    if (!file.good())
+        throw std::runtime_error("VoxelGrid: writing " + path + " failed.");
+}
+
+bool VoxelGrid::GetVoxel(const Vector3D& position, std::array<size_t, 3>& voxel) const {
+    auto p = Cartesian3D(position) - origin;
+    double x[3] = {p.GetX(), p.GetY(), p.GetZ()};
+    for (size_t k = 0; k < 3; ++k) {
+        auto i = std::floor(x[k] / spacing[k]);
+        if (i < 0 || i >= n[k])
+            return false;
+        voxel[k] = static_cast<size_t>(i);
+    }
+    return true;
+}
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// %%%%%%%%%%%%%%%%%%%%% Voxel-Density %%%%%%%%%%%%%%%%%%%%%%%
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Density_voxel::Density_voxel(std::shared_ptr<const VoxelGrid> grid,
+                             double massDensity,
+                             double outside_scale)
+    : Density_distr(massDensity), grid_(std::move(grid)), outside_scale_(outside_scale) {
+    if (!grid_ || grid_->values.size() != grid_->size())
+        throw std::invalid_argument("Density_voxel: number of values does not match the grid size.");
+}
+
+Density_voxel::Density_voxel(const std::string& path,
+                             double massDensity,
+                             double outside_scale)
+    : Density_voxel(std::make_shared<const VoxelGrid>(VoxelGrid::Read(path)),
+                    massDensity, outside_scale) {}
+
+Density_voxel::Density_voxel(const nlohmann::json& config)
+    : Density_voxel(config.at("path").get<std::string>(),
+                    config.at("mass_density").get<double>(),
+                    config.value("outside_scale", 1.)) {}
+
+bool Density_voxel::compare(const Density_distr& dens_distr) const {
+    auto dens_voxel = dynamic_cast<const Density_voxel*>(&dens_distr);
+    if (!dens_voxel)
+        return false;
+    if (outside_scale_ != dens_voxel->outside_scale_)
+        return false;
+    if (grid_ == dens_voxel->grid_)
+        return true;
+    const auto& a = *grid_;
+    const auto& b = *dens_voxel->grid_;
+    return a.n == b.n && a.origin == b.origin && a.spacing == b.spacing
+        && a.values == b.values && a.media == b.media;
+}
+
+template <typename Function>
+void Density_voxel::ForEachVoxel(const Vector3D& xi, const Vector3D& direction,
+                                 double t_max, Function&& f) const {
+    const auto& grid = *grid_;
+    auto p_rel = Cartesian3D(xi) - grid.origin;
+    auto dir = Cartesian3D(direction);
+    double p[3] = {p_rel.GetX(), p_rel.GetY(), p_rel.GetZ()};
+    double d[3] = {dir.GetX(), dir.GetY(), dir.GetZ()};
+
+    // entry and exit of the grid (slab method)
+    auto t_enter = 0.;
+    auto t_exit = t_max;
+    for (size_t k = 0; k < 3; ++k) {
+        auto size = grid.n[k] * grid.spacing[k];
+        if (d[k] == 0.) {
+            if (p[k] < 0. || p[k] >= size)
+                t_enter = INF;
+            continue;
+        }
+        auto t1 = -p[k] / d[k];
+        auto t2 = (size - p[k]) / d[k];
+        t_enter = std::max(t_enter, std::min(t1, t2));
+        t_exit = std::min(t_exit, std::max(t1, t2));
+    }
+    if (t_enter >= t_exit) {
+        f(0., t_max, outside_scale_);
+        return;
+    }
+    if (t_enter > 0. && !f(0., t_enter, outside_scale_))
+        return;
+
+    // traverse the voxels, starting with the one at the entry point
+    long voxel[3];
+    long step[3];
+    double t_next[3];
+    double t_delta[3];
+    for (size_t k = 0; k < 3; ++k) {
+        auto x = p[k] + t_enter * d[k];
+        voxel[k] = std::min(std::max(static_cast<long>(std::floor(x / grid.spacing[k])), 0l),
+                            static_cast<long>(grid.n[k]) - 1);
+        if (d[k] > 0.) {
+            step[k] = 1;
+            t_next[k] = ((voxel[k] + 1) * grid.spacing[k] - p[k]) / d[k];
+            t_delta[k] = grid.spacing[k] / d[k];
+        } else if (d[k] < 0.) {
+            step[k] = -1;
+            t_next[k] = (voxel[k] * grid.spacing[k] - p[k]) / d[k];
+            t_delta[k] = -grid.spacing[k] / d[k];
+        } else {
+            step[k] = 0;
+            t_next[k] = INF;
+            t_delta[k] = INF;
+        }
+    }
+
+    auto t = t_enter;
+    while (t < t_exit) {
+        auto k = std::distance(t_next, std::min_element(t_next, t_next + 3));
+        auto t_end = std::min(t_next[k], t_exit);
+        auto index = grid.GetIndex(voxel[0], voxel[1], voxel[2]);
+        if (t_end > t && !f(t, t_end, grid.values[index]))
+            return;
+        t = t_end;
+        voxel[k] += step[k];
+        if (voxel[k] < 0 || voxel[k] >= static_cast<long>(grid.n[k]))
+            break;
+        t_next[k] += t_delta[k];
+    }
+
+    if (t_exit < t_max)
+        f(t_exit, t_max, outside_scale_);
+}
+
+double Density_voxel::Correct(const Vector3D& xi,
+                              const Vector3D& direction,
+                              double res,
+                              double distance_to_border) const {
+    if (res <= 0.)
+        return 0.;
+
+    auto grammage = 0.;
+    auto distance = -1.;
+    ForEachVoxel(xi, direction, distance_to_border, [&](double low, double high, double scale) {
+        auto density = massDensity_ * scale;
+        if (density <= 0.)
+            return true;
+        auto piece = density * (high - low);
+        if (grammage + piece < res) {
+            grammage += piece;
+            return true;
+        }
+        distance = low + (res - grammage) / density;
+        return false;
+    });
+
+    if (distance < 0)
+        throw DensityException("Next interaction point lies in infinite.");
+    return distance;
+}
+
+double Density_voxel::Integrate(const Vector3D& xi,
+                                const Vector3D& direction,
+                                double l) const {
+    auto grammage = 0.;
+    ForEachVoxel(xi, direction, l, [&](double low, double high, double scale) {
+        if (scale != 0.)
+            grammage += massDensity_ * scale * (high - low);
+        return true;
+    });
+    return grammage;
+}
+
+double Density_voxel::Calculate(const Vector3D& xi,
+                                const Vector3D& direction,
+                                double distance) const {
+    return Integrate(xi, direction, distance);
+}
+
+double Density_voxel::Evaluate(const Vector3D& xi) const {
+    std::array<size_t, 3> voxel;
+    if (!grid_->GetVoxel(xi, voxel))
+        return massDensity_ * outside_scale_;
+    return massDensity_ * grid_->values[grid_->GetIndex(voxel[0], voxel[1], voxel[2])];
+}
+
+int Density_voxel::GetMediumIndex(const Vector3D& xi) const {
+    std::array<size_t, 3> voxel;
+    if (grid_->media.empty() || !grid_->GetVoxel(xi, voxel))
+        return -1;
+    return grid_->media[grid_->GetIndex(voxel[0], voxel[1], voxel[2])];
+}
@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -280,3 +281,13 @@ std::pair<double, double> Box::DistanceToBorder(const Vector3D& position, const
 
     return distance;
 }
+
+// ------------------------------------------------------------------------- //
+double Box::MinimalDistance(const Vector3D& position) const
+{
+    auto d = Cartesian3D(position) - position_;
+    auto dx = std::max(std::abs(d.GetX()) - 0.5 * x_, 0.);
+    auto dy = std::max(std::abs(d.GetY()) - 0.5 * y_, 0.);
+    auto dz = std::max(std::abs(d.GetZ()) - 0.5 * z_, 0.);
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -518,3 +519,14 @@ std::pair<double, double> Cylinder::DistanceToBorder(const Vector3D& position, c
 
     return distance;
 }
+
+// ------------------------------------------------------------------------- //
+double Cylinder::MinimalDistance(const Vector3D& position) const
+{
+    // the inner radius is ignored, a point in the hole gets 0 as lower bound
+    auto d = Cartesian3D(position) - position_;
+    auto rho = std::sqrt(d.GetX() * d.GetX() + d.GetY() * d.GetY());
+    auto d_rho = std::max(rho - radius_, 0.);
+    auto d_z = std::max(std::abs(d.GetZ()) - 0.5 * z_, 0.);
+    return std::sqrt(d_rho * d_rho + d_z * d_z);
+}
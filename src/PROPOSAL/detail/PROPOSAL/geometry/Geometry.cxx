@@ -87,43 +87,19 @@ bool Geometry::operator!=(const Geometry& geometry) const
 
 bool Geometry::IsInside(const Vector3D& position, const Vector3D& direction) const
 {
-    bool is_inside = false;
-
-    std::pair<double, double> dist = DistanceToBorder(position, direction);
-
-    if (dist.first > 0 && dist.second < 0)
-    {
-        is_inside = true;
-    }
-    return is_inside;
+    return Intersect(position, direction).location == ParticleLocation::InsideGeometry;
 }
 
 // ------------------------------------------------------------------------- //
 bool Geometry::IsInfront(const Vector3D& position, const Vector3D& direction) const
 {
-    bool is_infront = false;
-
-    std::pair<double, double> dist = DistanceToBorder(position, direction);
-
-    if (dist.first > 0 && dist.second > 0)
-    {
-        is_infront = true;
-    }
-    return is_infront;
+    return Intersect(position, direction).location == ParticleLocation::InfrontGeometry;
 }
 
 // ------------------------------------------------------------------------- //
 bool Geometry::IsBehind(const Vector3D& position, const Vector3D& direction) const
 {
-    bool is_behind = false;
-
-    std::pair<double, double> dist = DistanceToBorder(position, direction);
-
-    if (dist.first < 0 && dist.second < 0)
-    {
-        is_behind = true;
-    }
-    return is_behind;
+    return Intersect(position, direction).location == ParticleLocation::BehindGeometry;
 }
 
 // ------------------------------------------------------------------------- //
@@ -151,12 +127,23 @@ bool Geometry::IsLeaving(const Vector3D &position, const Vector3D &direction) co
 }
 
 Geometry::ParticleLocation::Enum Geometry::GetLocation(const Vector3D& position, const Vector3D& direction) const {
-    if(IsInfront(position, direction))
-        return Geometry::ParticleLocation::InfrontGeometry;
-    if(IsInside(position, direction))
-        return Geometry::ParticleLocation::InsideGeometry;
-    else
-        return Geometry::ParticleLocation::BehindGeometry;
+    return Intersect(position, direction).location;
+}
+
+// ------------------------------------------------------------------------- //
+Geometry::Intersection Geometry::Intersect(const Vector3D& position, const Vector3D& direction) const
+{
+    return Intersect(DistanceToBorder(position, direction));
+}
+
+// ------------------------------------------------------------------------- //
+Geometry::Intersection Geometry::Intersect(const std::pair<double, double>& distance)
+{
+    if (distance.first > 0 && distance.second > 0)
+        return { ParticleLocation::InfrontGeometry, distance.first, distance.second };
+    if (distance.first > 0 && distance.second < 0)
+        return { ParticleLocation::InsideGeometry, -1., distance.first };
+    return { ParticleLocation::BehindGeometry, -1., -1. };
 }
 
 // ------------------------------------------------------------------------- //
@@ -164,3 +151,8 @@ double Geometry::DistanceToClosestApproach(const Vector3D& position, const Vecto
 {
     return (position_ - position) * direction;
 }
+
+double Geometry::MinimalDistance(const Vector3D&) const
+{
+    return 0.;
+}
@@ -0,0 +1,22 @@
+#include <typeinfo>
+
+#include "PROPOSAL/geometry/GeometryVariant.h"
+
+using namespace PROPOSAL;
+
+GeometryVariant::GeometryVariant(const Geometry& geometry)
+    : geometry_(&geometry)
+    , type_(Type::Other)
+{
+    // the type has to match exactly, derived classes might override
+    // DistanceToBorder
+    const auto& type = typeid(geometry);
+    if (type == typeid(Sphere))
+        type_ = Type::Sphere;
+    else if (type == typeid(Box))
+        type_ = Type::Box;
+    else if (type == typeid(Cylinder))
+        type_ = Type::Cylinder;
+    else if (type == typeid(Mesh))
+        type_ = Type::Mesh;
+}
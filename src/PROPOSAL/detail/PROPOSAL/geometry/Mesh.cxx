@@ -0,0 +1,547 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "PROPOSAL/Constants.h"
+#include "PROPOSAL/geometry/Mesh.h"
+#include <nlohmann/json.hpp>
+
+using namespace PROPOSAL;
+
+namespace {
+using Vertex = Mesh::Vertex;
+using Face = Mesh::Face;
+
+constexpr size_t MAX_LEAF_SIZE = 4;
+constexpr size_t SAH_BINS = 12;
+constexpr size_t MAX_DEPTH = 64;
+
+Vertex subtract(const Vertex& a, const Vertex& b) { return { a[0] - b[0], a[1] - b[1], a[2] - b[2] }; }
+
+Vertex cross(const Vertex& a, const Vertex& b)
+{
+    return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+}
+
+double dot(const Vertex& a, const Vertex& b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+
+struct Bounds {
+    Vertex lower = { INF, INF, INF };
+    Vertex upper = { -INF, -INF, -INF };
+
+    void Extend(const Vertex& v)
+    {
+        for (size_t k = 0; k < 3; ++k) {
+            lower[k] = std::min(lower[k], v[k]);
+            upper[k] = std::max(upper[k], v[k]);
+        }
+    }
+    void Extend(const Bounds& b)
+    {
+        Extend(b.lower);
+        Extend(b.upper);
+    }
+    double Area() const
+    {
+        if (lower[0] > upper[0])
+            return 0.;
+        auto d = subtract(upper, lower);
+        return 2. * (d[0] * d[1] + d[1] * d[2] + d[2] * d[0]);
+    }
+};
+
+// ------------------------------------------------------------------------- //
+// Mesh file readers
+// ------------------------------------------------------------------------- //
+
+void add_polygon(std::vector<Face>& faces, const std::vector<size_t>& polygon)
+{
+    // polygons are triangulated as fan
+    for (size_t i = 2; i < polygon.size(); ++i)
+        faces.push_back({ polygon[0], polygon[i - 1], polygon[i] });
+}
+
+void read_obj(std::istream& file, std::vector<Vertex>& vertices, std::vector<Face>& faces)
+{
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream ss(line);
+        std::string key;
+        ss >> key;
+        if (key == "v") {
+            Vertex v;
+            ss >> v[0] >> v[1] >> v[2];
+            vertices.push_back(v);
+        } else if (key == "f") {
+            std::vector<size_t> polygon;
+            std::string item;
+            while (ss >> item) {
+                // items are v, v/vt, v//vn or v/vt/vn, indices start at 1
+                // and negative indices count from the end
+                auto index = std::stol(item.substr(0, item.find('/')));
+                polygon.push_back(index > 0 ? index - 1 : vertices.size() + index);
+            }
+            add_polygon(faces, polygon);
+        }
+    }
+}
+
+void read_stl(std::istream& file, size_t file_size, std::vector<Vertex>& vertices, std::vector<Face>& faces)
+{
+    char header[80];
+    uint32_t n_triangles = 0;
+    file.read(header, 80);
+    file.read(reinterpret_cast<char*>(&n_triangles), sizeof(n_triangles));
+    if (file && file_size == 84 + 50 * static_cast<size_t>(n_triangles)) {
+        for (uint32_t i = 0; i < n_triangles; ++i) {
+            float data[12];
+            uint16_t attribute;
+            file.read(reinterpret_cast<char*>(data), sizeof(data));
+            file.read(reinterpret_cast<char*>(&attribute), sizeof(attribute));
+            for (size_t j = 1; j < 4; ++j)
+                vertices.push_back({ data[3 * j], data[3 * j + 1], data[3 * j + 2] });
+            faces.push_back({ vertices.size() - 3, vertices.size() - 2, vertices.size() - 1 });
+        }
+        return;
+    }
+
+    // ascii stl
+    file.clear();
+    file.seekg(0);
+    std::string key;
+    while (file >> key) {
+        if (key == "vertex") {
+            Vertex v;
+            file >> v[0] >> v[1] >> v[2];
+            vertices.push_back(v);
+        } else if (key == "endfacet") {
+            if (vertices.size() % 3 != 0)
+                throw std::invalid_argument("Mesh: every facet of a stl file needs three vertices.");
+            faces.push_back({ vertices.size() - 3, vertices.size() - 2, vertices.size() - 1 });
+        }
+    }
+}
+
+struct PlyProperty {
+    std::string name;
+    std::string type;
+    std::string count_type; //!< empty if the property is no list
+};
+
+struct PlyElement {
+    std::string name;
+    size_t count;
+    std::vector<PlyProperty> properties;
+};
+
+double read_ply_value(std::istream& file, const std::string& type, bool binary)
+{
+    if (!binary) {
+        double value;
+        file >> value;
+        return value;
+    }
+    auto read = [&file](auto value) {
+        file.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return static_cast<double>(value);
+    };
+    if (type == "char" || type == "int8")
+        return read(int8_t());
+    if (type == "uchar" || type == "uint8")
+        return read(uint8_t());
+    if (type == "short" || type == "int16")
+        return read(int16_t());
+    if (type == "ushort" || type == "uint16")
+        return read(uint16_t());
+    if (type == "int" || type == "int32")
+        return read(int32_t());
+    if (type == "uint" || type == "uint32")
+        return read(uint32_t());
+    if (type == "float" || type == "float32")
+        return read(float());
+    if (type == "double" || type == "float64")
+        return read(double());
+    throw std::invalid_argument("Mesh: unknown ply property type " + type);
+}
+
+void read_ply(std::istream& file, std::vector<Vertex>& vertices, std::vector<Face>& faces)
+{
+    std::string line, format;
+    std::vector<PlyElement> elements;
+    while (std::getline(file, line)) {
+        std::istringstream ss(line);
+        std::string key;
+        ss >> key;
+        if (key == "format") {
+            ss >> format;
+        } else if (key == "element") {
+            elements.emplace_back();
+            ss >> elements.back().name >> elements.back().count;
+        } else if (key == "property" && !elements.empty()) {
+            PlyProperty property;
+            ss >> property.type;
+            if (property.type == "list")
+                ss >> property.count_type >> property.type;
+            ss >> property.name;
+            elements.back().properties.push_back(property);
+        } else if (key == "end_header") {
+            break;
+        }
+    }
+    if (format != "ascii" && format != "binary_little_endian")
+        throw std::invalid_argument("Mesh: ply format " + format + " is not supported.");
+    auto binary = format != "ascii";
+
+    for (const auto& element : elements) {
+        for (size_t i = 0; i < element.count; ++i) {
+            Vertex v = { 0., 0., 0. };
+            for (const auto& property : element.properties) {
+                if (property.count_type.empty()) {
+                    auto value = read_ply_value(file, property.type, binary);
+                    if (element.name == "vertex" && property.name.size() == 1
+                        && property.name[0] >= 'x' && property.name[0] <= 'z')
+                        v[property.name[0] - 'x'] = value;
+                    continue;
+                }
+                auto n = static_cast<size_t>(read_ply_value(file, property.count_type, binary));
+                std::vector<size_t> polygon(n);
+                for (auto& index : polygon)
+                    index = static_cast<size_t>(read_ply_value(file, property.type, binary));
+                if (element.name == "face"
+                    && (property.name == "vertex_indices" || property.name == "vertex_index"))
+                    add_polygon(faces, polygon);
+            }
+            if (element.name == "vertex")
+                vertices.push_back(v);
+        }
+    }
+}
+
+void read_mesh(const std::string& path, std::vector<Vertex>& vertices, std::vector<Face>& faces)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.good())
+        throw std::invalid_argument("Mesh: could not open " + path);
+    auto file_size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    auto extension = path.substr(path.find_last_of('.') + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == "obj")
+        read_obj(file, vertices, faces);
+    else if (extension == "stl")
+        read_stl(file, file_size, vertices, faces);
+    else if (extension == "ply")
+        read_ply(file, vertices, faces);
+    else
+        throw std::invalid_argument("Mesh: unknown file type of " + path + ", use obj, stl or ply.");
+
+    if (file.bad())
+        throw std::invalid_argument("Mesh: reading " + path + " failed.");
+}
+} // namespace
+
+/******************************************************************************
+ *                                   Mesh                                      *
+ ******************************************************************************/
+
+Mesh::Mesh(const Vector3D& position, const std::vector<Vertex>& vertices, const std::vector<Face>& faces)
+    : Geometry("Mesh", position)
+{
+    Init(vertices, faces);
+}
+
+Mesh::Mesh(const Vector3D& position, const std::string& path, double scale)
+    : Geometry("Mesh", position)
+{
+    std::vector<Vertex> vertices;
+    std::vector<Face> faces;
+    read_mesh(path, vertices, faces);
+    for (auto& v : vertices)
+        for (auto& x : v)
+            x *= scale;
+    Init(std::move(vertices), faces);
+}
+
+Mesh::Mesh(const nlohmann::json& config)
+    : Geometry(config)
+{
+    if (!config.contains("path"))
+        throw std::invalid_argument("Mesh: no path to the mesh file found.");
+    auto scale = config.value("scale", 1.);
+    if (scale <= 0)
+        throw std::logic_error("scale must be > 0");
+
+    std::vector<Vertex> vertices;
+    std::vector<Face> faces;
+    read_mesh(config["path"].get<std::string>(), vertices, faces);
+    for (auto& v : vertices)
+        for (auto& x : v)
+            x *= scale;
+    Init(std::move(vertices), faces);
+}
+
+void Mesh::Init(std::vector<Vertex> vertices, const std::vector<Face>& faces)
+{
+    if (faces.empty())
+        throw std::invalid_argument("Mesh: the mesh has no triangles.");
+    if (faces.size() > std::numeric_limits<uint32_t>::max())
+        throw std::invalid_argument("Mesh: too many triangles.");
+
+    // the signed volume is negative if the normals point inwards
+    auto volume = 0.;
+    for (const auto& f : faces) {
+        for (auto index : f)
+            if (index >= vertices.size())
+                throw std::invalid_argument("Mesh: face refers to a vertex which does not exist.");
+        volume += dot(vertices[f[0]], cross(vertices[f[1]], vertices[f[2]]));
+    }
+    auto flip = volume < 0;
+
+    std::vector<Triangle> triangles;
+    std::vector<Vertex> centroids;
+    for (const auto& f : faces) {
+        const auto& v0 = vertices[f[0]];
+        const auto& v1 = vertices[flip ? f[2] : f[1]];
+        const auto& v2 = vertices[flip ? f[1] : f[2]];
+        triangles.push_back({ v0, subtract(v1, v0), subtract(v2, v0) });
+        centroids.push_back({ (v0[0] + v1[0] + v2[0]) / 3., (v0[1] + v1[1] + v2[1]) / 3.,
+            (v0[2] + v1[2] + v2[2]) / 3. });
+    }
+
+    std::vector<size_t> indices(triangles.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+        indices[i] = i;
+    nodes_.reserve(2 * triangles.size());
+    Build(triangles, indices, centroids, 0, triangles.size(), 0);
+
+    triangles_.reserve(triangles.size());
+    for (auto i : indices)
+        triangles_.push_back(triangles[i]);
+}
+
+uint32_t Mesh::Build(std::vector<Triangle>& triangles, std::vector<size_t>& indices,
+    const std::vector<Vertex>& centroids, size_t first, size_t count, size_t depth)
+{
+    auto triangle_bounds = [&triangles](size_t i) {
+        Bounds b;
+        const auto& t = triangles[i];
+        b.Extend(t.v0);
+        b.Extend(Vertex{ t.v0[0] + t.e1[0], t.v0[1] + t.e1[1], t.v0[2] + t.e1[2] });
+        b.Extend(Vertex{ t.v0[0] + t.e2[0], t.v0[1] + t.e2[1], t.v0[2] + t.e2[2] });
+        return b;
+    };
+
+    Bounds bounds, centroid_bounds;
+    for (size_t i = first; i < first + count; ++i) {
+        bounds.Extend(triangle_bounds(indices[i]));
+        centroid_bounds.Extend(centroids[indices[i]]);
+    }
+
+    auto node_index = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back({ bounds.lower, bounds.upper, static_cast<uint32_t>(first), static_cast<uint32_t>(count) });
+    // the depth is limited by the traversal stack
+    if (count <= MAX_LEAF_SIZE || depth + 1 >= MAX_DEPTH)
+        return node_index;
+
+    // binned surface area heuristic
+    auto best_cost = INF;
+    size_t best_axis = 0, best_split = 0;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        auto extent = centroid_bounds.upper[axis] - centroid_bounds.lower[axis];
+        if (extent <= 0)
+            continue;
+        std::array<Bounds, SAH_BINS> bins;
+        std::array<size_t, SAH_BINS> counts = {};
+        for (size_t i = first; i < first + count; ++i) {
+            auto bin = std::min(SAH_BINS - 1,
+                static_cast<size_t>(SAH_BINS * (centroids[indices[i]][axis] - centroid_bounds.lower[axis]) / extent));
+            bins[bin].Extend(triangle_bounds(indices[i]));
+            ++counts[bin];
+        }
+        std::array<double, SAH_BINS> right_cost;
+        Bounds right;
+        size_t n_right = 0;
+        for (size_t bin = SAH_BINS - 1; bin > 0; --bin) {
+            right.Extend(bins[bin]);
+            n_right += counts[bin];
+            right_cost[bin] = right.Area() * n_right;
+        }
+        Bounds left;
+        size_t n_left = 0;
+        for (size_t split = 1; split < SAH_BINS; ++split) {
+            left.Extend(bins[split - 1]);
+            n_left += counts[split - 1];
+            auto cost = left.Area() * n_left + right_cost[split];
+            if (n_left > 0 && n_left < count && cost < best_cost) {
+                best_cost = cost;
+                best_axis = axis;
+                best_split = split;
+            }
+        }
+    }
+
+    if (best_cost == INF)
+        return node_index; // all centroids coincide
+
+    auto extent = centroid_bounds.upper[best_axis] - centroid_bounds.lower[best_axis];
+    auto middle = std::partition(indices.begin() + first, indices.begin() + first + count, [&](size_t i) {
+        auto bin = std::min(SAH_BINS - 1,
+            static_cast<size_t>(SAH_BINS * (centroids[i][best_axis] - centroid_bounds.lower[best_axis]) / extent));
+        return bin < best_split;
+    });
+    auto n_left = static_cast<size_t>(std::distance(indices.begin() + first, middle));
+
+    Build(triangles, indices, centroids, first, n_left, depth + 1);
+    auto right_child = Build(triangles, indices, centroids, first + n_left, count - n_left, depth + 1);
+    nodes_[node_index].offset = right_child;
+    nodes_[node_index].count = 0;
+    return node_index;
+}
+
+bool Mesh::IntersectBVH(const Vertex& origin, const Vertex& direction, double min_distance, Hit& hit) const
+{
+    Vertex inv_direction;
+    for (size_t k = 0; k < 3; ++k)
+        inv_direction[k] = direction[k] != 0 ? 1. / direction[k] : std::copysign(1e300, direction[k]);
+
+    // slab test, returns the entry distance or INF if the box is missed
+    auto entry = [&](const Node& node) {
+        auto t_near = min_distance;
+        auto t_far = hit.distance;
+        for (size_t k = 0; k < 3; ++k) {
+            auto t1 = (node.lower[k] - origin[k]) * inv_direction[k];
+            auto t2 = (node.upper[k] - origin[k]) * inv_direction[k];
+            t_near = std::max(t_near, std::min(t1, t2));
+            t_far = std::min(t_far, std::max(t1, t2));
+        }
+        return t_near <= t_far ? t_near : INF;
+    };
+
+    hit.distance = INF;
+    std::array<uint32_t, MAX_DEPTH> stack;
+    size_t stack_size = 0;
+    uint32_t current = 0;
+    if (entry(nodes_[0]) == INF)
+        return false;
+
+    while (true) {
+        const auto& node = nodes_[current];
+        if (node.count > 0) {
+            // Moeller-Trumbore intersection with the triangles of the leaf
+            for (auto i = node.offset; i < node.offset + node.count; ++i) {
+                const auto& t = triangles_[i];
+                auto p = cross(direction, t.e2);
+                auto det = dot(t.e1, p);
+                if (det == 0)
+                    continue;
+                auto inv_det = 1. / det;
+                auto s = subtract(origin, t.v0);
+                auto u = dot(s, p) * inv_det;
+                if (u < 0 || u > 1)
+                    continue;
+                auto q = cross(s, t.e1);
+                auto v = dot(direction, q) * inv_det;
+                if (v < 0 || u + v > 1)
+                    continue;
+                auto distance = dot(t.e2, q) * inv_det;
+                if (distance > min_distance && distance < hit.distance) {
+                    // det = -direction * normal, so the trajectory leaves the
+                    // mesh through the triangle if det < 0
+                    hit.distance = distance;
+                    hit.leaving = det < 0;
+                }
+            }
+        } else {
+            // visit the nearer child first
+            auto left = current + 1;
+            auto right = node.offset;
+            auto t_left = entry(nodes_[left]);
+            auto t_right = entry(nodes_[right]);
+            if (t_left > t_right) {
+                std::swap(left, right);
+                std::swap(t_left, t_right);
+            }
+            if (t_left != INF) {
+                if (t_right != INF)
+                    stack[stack_size++] = right;
+                current = left;
+                continue;
+            }
+        }
+        if (stack_size == 0)
+            break;
+        current = stack[--stack_size];
+        if (entry(nodes_[current]) == INF)
+            continue;
+    }
+    return hit.distance != INF;
+}
+
+bool Mesh::compare(const Geometry& geometry) const
+{
+    const Mesh* mesh = dynamic_cast<const Mesh*>(&geometry);
+    if (!mesh)
+        return false;
+    if (triangles_.size() != mesh->triangles_.size())
+        return false;
+    for (size_t i = 0; i < triangles_.size(); ++i) {
+        const auto& a = triangles_[i];
+        const auto& b = mesh->triangles_[i];
+        if (a.v0 != b.v0 || a.e1 != b.e1 || a.e2 != b.e2)
+            return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------- //
+void Mesh::print(std::ostream& os) const
+{
+    os << "Triangles: " << triangles_.size() << "\tBVH nodes: " << nodes_.size() << '\n';
+}
+
+// ------------------------------------------------------------------------- //
+std::pair<double, double> Mesh::DistanceToBorder(const Vector3D& position, const Vector3D& direction) const
+{
+    // The first intersection in direction of the trajectory decides whether
+    // the particle is inside. If it enters the mesh, the second distance is
+    // the next intersection, where it leaves the mesh again.
+    // Intersections closer than GEOMETRY_PRECISION are ignored, so a
+    // particle on the border is treated like for the other geometries.
+    auto pos = Cartesian3D(position) - position_;
+    auto dir = Cartesian3D(direction);
+    Vertex origin = { pos.GetX(), pos.GetY(), pos.GetZ() };
+    Vertex d = { dir.GetX(), dir.GetY(), dir.GetZ() };
+
+    std::pair<double, double> distance(-1, -1);
+    Hit first, second;
+    if (!IntersectBVH(origin, d, GEOMETRY_PRECISION, first))
+        return distance;
+
+    distance.first = first.distance;
+    if (first.leaving)
+        return distance;
+
+    if (IntersectBVH(origin, d, first.distance + GEOMETRY_PRECISION, second))
+        distance.second = second.distance;
+    return distance;
+}
+
+// ------------------------------------------------------------------------- //
+double Mesh::MinimalDistance(const Vector3D& position) const
+{
+    // distance to the bounding box of the mesh
+    auto pos = Cartesian3D(position) - position_;
+    Vertex p = { pos.GetX(), pos.GetY(), pos.GetZ() };
+    const auto& root = nodes_.front();
+    auto sum = 0.;
+    for (size_t k = 0; k < 3; ++k) {
+        auto d = std::max({ root.lower[k] - p[k], p[k] - root.upper[k], 0. });
+        sum += d * d;
+    }
+    return std::sqrt(sum);
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 
 #include "PROPOSAL/Constants.h"
@@ -239,3 +240,11 @@ std::pair<double, double> Sphere::DistanceToBorder(const Vector3D& position, con
 
     return distance;
 }
+
+// ------------------------------------------------------------------------- //
+double Sphere::MinimalDistance(const Vector3D& position) const
+{
+    // the inner radius is ignored, a point in the hole gets 0 as lower bound
+    auto d = (Cartesian3D(position) - position_).magnitude();
+    return std::max(d - radius_, 0.);
+}
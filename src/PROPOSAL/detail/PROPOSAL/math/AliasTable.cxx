@@ -0,0 +1,71 @@
+#include "PROPOSAL/math/AliasTable.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+using namespace PROPOSAL;
+
+AliasTable::AliasTable(std::vector<double> const& weights)
+    : probability_(weights.size(), 1.)
+    , alias_(weights.size())
+{
+    auto sum = std::accumulate(weights.begin(), weights.end(), 0.);
+    if (!(sum > 0)) {
+        probability_.clear();
+        alias_.clear();
+        return;
+    }
+
+    // Vose's method: scaled probabilities are split into entries with less
+    // and more than the mean probability, which are then paired up.
+    auto n = weights.size();
+    auto scaled = std::vector<double>(n);
+    auto small = std::vector<size_t>();
+    auto large = std::vector<size_t>();
+    for (size_t i = 0; i < n; ++i) {
+        if (weights[i] < 0)
+            throw std::invalid_argument("Weights of an alias table must be "
+                                        "non-negative.");
+        scaled[i] = weights[i] * n / sum;
+        alias_[i] = i;
+        if (scaled[i] < 1.)
+            small.push_back(i);
+        else
+            large.push_back(i);
+    }
+
+    while (!small.empty() && !large.empty()) {
+        auto s = small.back();
+        small.pop_back();
+        auto l = large.back();
+
+        probability_[s] = scaled[s];
+        alias_[s] = l;
+
+        scaled[l] -= 1. - scaled[s];
+        if (scaled[l] < 1.) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+
+    // remaining entries are equal to one up to rounding errors
+    for (auto i : small)
+        probability_[i] = 1.;
+    for (auto i : large)
+        probability_[i] = 1.;
+}
+
+std::pair<size_t, double> AliasTable::Sample(double rnd) const
+{
+    auto n = probability_.size();
+    auto x = rnd * n;
+    auto i = std::min(static_cast<size_t>(x), n - 1);
+    auto f = x - i;
+
+    if (f < probability_[i])
+        return std::make_pair(i, f / probability_[i]);
+    return std::make_pair(
+        alias_[i], (f - probability_[i]) / (1. - probability_[i]));
+}
@@ -24,87 +24,6 @@ void Cartesian3D::print(std::ostream& os) const {
     os << "z: " << GetZ() << "\n";
 }
 
-double Cartesian3D::magnitude() const {
-    auto sum = 0.;
-    for (auto& c : coordinates) {
-        sum += c * c;
-    }
-    return std::sqrt(sum);
-}
-
-void Cartesian3D::normalize() {
-    auto length = magnitude();
-    for (size_t i = 0; i<3; i++) {
-        coordinates[i] /= length;
-    }
-}
-
-namespace PROPOSAL {
-
-    Cartesian3D operator+(const Cartesian3D &lhs, const Cartesian3D &rhs) {
-        Cartesian3D sum;
-        for (size_t i = 0; i < 3; i++) {
-            sum[i] = lhs[i] + rhs[i];
-        }
-        return sum;
-    }
-
-    Cartesian3D operator-(const Cartesian3D &lhs, const Cartesian3D &rhs) {
-        Cartesian3D diff;
-        for (size_t i = 0; i < 3; i++) {
-            diff[i] = lhs[i] - rhs[i];
-        }
-        return diff;
-    }
-
-    double operator*(const Cartesian3D &lhs, const Cartesian3D &rhs) {
-        auto sum = 0.;
-        for (size_t i = 0; i < 3; i++) {
-            sum += lhs[i] * rhs[i];
-        }
-        return sum;
-    }
-
-    Cartesian3D operator*(const Cartesian3D &lhs, double val) {
-        Cartesian3D product;
-        for (size_t i = 0; i < 3; i++) {
-            product[i] = lhs[i] * val;
-        }
-        return product;
-    }
-
-    Cartesian3D operator*(double val, const Cartesian3D &rhs) {
-        Cartesian3D product;
-        for (size_t i = 0; i < 3; i++) {
-            product[i] = rhs[i] * val;
-        }
-        return product;
-    }
-
-    Cartesian3D Cartesian3D::operator-() const {
-        Cartesian3D negative;
-        for (size_t i = 0; i < 3; i++) {
-            negative[i] = -coordinates[i];
-        }
-        return negative;
-    }
-
-    Cartesian3D &Cartesian3D::operator+=(const Cartesian3D &rhs) {
-        for (size_t i = 0; i < 3; i++) {
-            coordinates[i] += rhs[i];
-        }
-        return *this;
-    }
-
-    Cartesian3D vector_product(const Cartesian3D& lhs, const Cartesian3D& rhs) {
-        Cartesian3D product;
-        product.SetX(lhs.GetY() * rhs.GetZ() - lhs.GetZ() * rhs.GetY());
-        product.SetY(lhs.GetZ() * rhs.GetX() - lhs.GetX() * rhs.GetZ());
-        product.SetZ(lhs.GetX() * rhs.GetY() - lhs.GetY() * rhs.GetX());
-        return product;
-    }
-}
-
 void Cartesian3D::deflect(double cosphi_deflect, double theta_deflect) {
     if(cosphi_deflect != 1 || theta_deflect != 0)
     {
@@ -133,10 +52,6 @@ void Cartesian3D::deflect(double cosphi_deflect, double theta_deflect) {
     }
 }
 
-std::array<double, 3> Cartesian3D::GetCartesianCoordinates() const {
-    return coordinates;
-}
-
 std::array<double, 3> Cartesian3D::GetSphericalCoordinates() const {
     auto r = magnitude();
 
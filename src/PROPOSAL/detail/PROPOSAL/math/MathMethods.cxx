@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <cmath>
 #include <utility>
 #include <fstream>
@@ -272,6 +273,114 @@ double NewtonRaphson(std::function<double(double)> func,
     return rts;
 }
 
+namespace {
+double evaluate_polynomial(const std::vector<double>& coefficients, double x) {
+    auto aux = 0.;
+    for (auto it = coefficients.rbegin(); it != coefficients.rend(); ++it)
+        aux = aux * x + *it;
+    return aux;
+}
+
+double evaluate_derivative(const std::vector<double>& coefficients, double x) {
+    auto aux = 0.;
+    for (size_t i = coefficients.size() - 1; i > 0; --i)
+        aux = aux * x + i * coefficients[i];
+    return aux;
+}
+}  // namespace
+
+std::vector<double> PolynomialRoots(std::vector<double> coefficients) {
+    while (!coefficients.empty() && coefficients.back() == 0.)
+        coefficients.pop_back();
+
+    std::vector<double> roots;
+    switch (coefficients.size()) {
+        case 0:
+        case 1:
+            return roots;
+        case 2:
+            roots.push_back(-coefficients[0] / coefficients[1]);
+            return roots;
+        case 3: {
+            // numerically stable form, see Numerical Recipes 5.6
+            auto a = coefficients[2];
+            auto b = coefficients[1];
+            auto c = coefficients[0];
+            auto discriminant = b * b - 4. * a * c;
+            if (discriminant < 0.)
+                return roots;
+            auto q = -0.5 * (b + std::copysign(std::sqrt(discriminant), b));
+            if (q == 0.) {
+                roots.push_back(0.);
+                return roots;
+            }
+            roots.push_back(q / a);
+            roots.push_back(c / q);
+            break;
+        }
+        case 4: {
+            // Cardano's method, see Numerical Recipes 5.6
+            auto a = coefficients[2] / coefficients[3];
+            auto b = coefficients[1] / coefficients[3];
+            auto c = coefficients[0] / coefficients[3];
+            auto Q = (a * a - 3. * b) / 9.;
+            auto R = (2. * a * a * a - 9. * a * b + 27. * c) / 54.;
+            if (R * R < Q * Q * Q) {
+                auto theta = std::acos(R / std::sqrt(Q * Q * Q));
+                for (auto shift : {0., 2. * PI, -2. * PI})
+                    roots.push_back(-2. * std::sqrt(Q) * std::cos((theta + shift) / 3.) - a / 3.);
+            } else {
+                auto A = -std::copysign(std::cbrt(std::abs(R) + std::sqrt(R * R - Q * Q * Q)), R);
+                auto B = (A == 0.) ? 0. : Q / A;
+                roots.push_back(A + B - a / 3.);
+            }
+            // the closed form suffers from cancellation, polish the roots
+            for (auto& root : roots) {
+                for (int i = 0; i < 2; ++i) {
+                    auto df = evaluate_derivative(coefficients, root);
+                    if (df == 0.)
+                        break;
+                    root -= evaluate_polynomial(coefficients, root) / df;
+                }
+            }
+            break;
+        }
+        default:
+            throw MathException("Roots can only be calculated in closed form up to degree three.");
+    }
+    std::sort(roots.begin(), roots.end());
+    return roots;
+}
+
+double SolvePolynomial(const std::vector<double>& coefficients, double y, double x1, double x2) {
+    auto shifted = coefficients;
+    if (shifted.empty())
+        shifted.push_back(0.);
+    shifted[0] -= y;
+
+    if (shifted.size() > 4) {
+        auto f = [&shifted](double x) { return evaluate_polynomial(shifted, x); };
+        auto df = [&shifted](double x) { return evaluate_derivative(shifted, x); };
+        return NewtonRaphson(f, df, x1, x2, 0.5 * (x1 + x2));
+    }
+
+    // roots are accepted slightly outside of the interval to be robust
+    // against rounding if the solution is at one of the limits
+    auto low = std::min(x1, x2);
+    auto high = std::max(x1, x2);
+    auto tolerance = 1e-12 * std::max({std::abs(low), std::abs(high), 1.});
+    auto solution = std::numeric_limits<double>::quiet_NaN();
+    for (auto root : PolynomialRoots(shifted)) {
+        if (root < low - tolerance || root > high + tolerance)
+            continue;
+        if (std::isnan(solution) || std::abs(root - x1) < std::abs(solution - x1))
+            solution = root;
+    }
+    if (std::isnan(solution))
+        throw MathException("Polynomial has no root inside the given interval.");
+    return std::min(std::max(solution, low), high);
+}
+
 std::pair<double, double> Bisection(std::function<double(double)> f, double x1,
                                     double x2, double xacc, double MAX_ITER) {
     if (f(x1) * f(x2) > 0.)
@@ -23,18 +23,6 @@ void Spherical3D::print(std::ostream& os) const {
     os << "zenith: " << GetZenith() << "\n";
 }
 
-double Spherical3D::magnitude() const {
-    return GetRadius();
-}
-
-void Spherical3D::normalize() {
-    SetRadius(1.);
-}
-
-std::array<double, 3> Spherical3D::GetSphericalCoordinates() const {
-    return coordinates;
-}
-
 std::array<double, 3> Spherical3D::GetCartesianCoordinates() const {
     auto cos_a = cos(GetAzimuth());
     auto sin_a = sin(GetAzimuth());
@@ -0,0 +1,449 @@
+#include "PROPOSAL/output/EventFile.h"
+#include "PROPOSAL/Logging.h"
+#include "PROPOSAL/Secondaries.h"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+using namespace PROPOSAL;
+
+namespace {
+constexpr uint32_t CHUNK_MAGIC = 0x4b4e4843; // "CHNK"
+
+template <typename T> const char* dtype_name();
+template <> const char* dtype_name<double>() { return "<f8"; }
+template <> const char* dtype_name<int32_t>() { return "<i4"; }
+template <> const char* dtype_name<uint8_t>() { return "|u1"; }
+template <> const char* dtype_name<uint64_t>() { return "<u8"; }
+
+// Calls f(table, name, column) for every column of a chunk in the order they
+// are stored in the file. The track columns are skipped if with_tracks is
+// false.
+template <typename Chunk, typename Function>
+void for_each_column(Chunk& c, bool with_tracks, Function&& f)
+{
+    f("event", "initial_energy", c.initial_energy);
+    f("event", "final_energy", c.final_energy);
+    f("event", "final_x", c.final_x);
+    f("event", "final_y", c.final_y);
+    f("event", "final_z", c.final_z);
+    f("event", "final_time", c.final_time);
+    f("event", "propagated_distance", c.propagated_distance);
+    f("event", "decayed", c.decayed);
+    f("event", "final_weight", c.final_weight);
+    f("offset", "loss_offsets", c.loss_offsets);
+    f("offset", "track_offsets", c.track_offsets);
+    f("loss", "loss_type", c.loss_type);
+    f("loss", "loss_energy", c.loss_energy);
+    f("loss", "loss_parent_energy", c.loss_parent_energy);
+    f("loss", "loss_x", c.loss_x);
+    f("loss", "loss_y", c.loss_y);
+    f("loss", "loss_z", c.loss_z);
+    f("loss", "loss_time", c.loss_time);
+    f("loss", "loss_distance", c.loss_distance);
+    f("loss", "loss_target_hash", c.loss_target_hash);
+    f("loss", "loss_weight", c.loss_weight);
+    if (!with_tracks)
+        return;
+    f("track", "track_type", c.track_type);
+    f("track", "track_energy", c.track_energy);
+    f("track", "track_x", c.track_x);
+    f("track", "track_y", c.track_y);
+    f("track", "track_z", c.track_z);
+    f("track", "track_dx", c.track_dx);
+    f("track", "track_dy", c.track_dy);
+    f("track", "track_dz", c.track_dz);
+    f("track", "track_time", c.track_time);
+    f("track", "track_distance", c.track_distance);
+    f("track", "track_weight", c.track_weight);
+}
+
+// The files are little-endian, values are swapped on big-endian hosts.
+bool host_is_little_endian()
+{
+    const uint16_t one = 1;
+    return *reinterpret_cast<const uint8_t*>(&one) == 1;
+}
+
+template <typename T> void swap_bytes(T& value)
+{
+    auto bytes = reinterpret_cast<char*>(&value);
+    std::reverse(bytes, bytes + sizeof(T));
+}
+
+template <typename T> void write_value(std::ostream& os, T value)
+{
+    if (!host_is_little_endian())
+        swap_bytes(value);
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T> bool read_value(std::istream& is, T& value)
+{
+    is.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!host_is_little_endian())
+        swap_bytes(value);
+    return static_cast<bool>(is);
+}
+
+template <typename T>
+void write_column(std::ostream& os, const std::vector<T>& column)
+{
+    if (!host_is_little_endian()) {
+        for (auto value : column)
+            write_value(os, value);
+        return;
+    }
+    os.write(reinterpret_cast<const char*>(column.data()),
+        column.size() * sizeof(T));
+}
+
+template <typename T>
+void read_column(std::istream& is, std::vector<T>& column, size_t n)
+{
+    column.resize(n);
+    is.read(reinterpret_cast<char*>(column.data()), n * sizeof(T));
+    if (!host_is_little_endian())
+        for (auto& value : column)
+            swap_bytes(value);
+}
+
+// The weight columns have been added in version 2. They are missing in
+// files of version 1 and read as weight 1.
+bool is_weight_column(const std::string& name)
+{
+    return name == "final_weight" || name == "loss_weight"
+        || name == "track_weight";
+}
+
+std::string create_schema(bool with_tracks)
+{
+    auto schema = nlohmann::json::array();
+    EventChunk chunk;
+    for_each_column(chunk, with_tracks,
+        [&schema](const char* table, const char* name, const auto& column) {
+            using T = typename std::decay_t<decltype(column)>::value_type;
+            schema.push_back({ { "table", table }, { "name", name },
+                { "dtype", dtype_name<T>() } });
+        });
+    return schema.dump();
+}
+} // namespace
+
+constexpr uint32_t EventFileHeader::MAGIC;
+constexpr uint32_t EventFileHeader::VERSION;
+
+void EventRecord::push_back(const ParticleState& point,
+    const InteractionType& type, const size_t& target_hash)
+{
+    if (n_points == 0) {
+        initial_state = point;
+    } else if (type != InteractionType::ContinuousEnergyLoss
+        && type != InteractionType::Decay) {
+        losses.emplace_back(static_cast<int>(type),
+            final_state.energy - point.energy, point.position,
+            point.direction, point.time, point.propagated_distance,
+            final_state.energy, target_hash, point.weight);
+    }
+    if (type == InteractionType::Decay)
+        decayed = true;
+
+    final_state = point;
+    ++n_points;
+
+    if (store_track) {
+        track.push_back(point);
+        track_types.push_back(type);
+    }
+}
+
+void EventRecord::clear()
+{
+    n_points = 0;
+    decayed = false;
+    losses.clear();
+    track.clear();
+    track_types.clear();
+}
+
+void EventChunk::Append(const EventRecord& record)
+{
+    if (record.n_points == 0)
+        throw std::invalid_argument("Can not append an empty event.");
+
+    const auto& state = record.final_state;
+    initial_energy.push_back(record.initial_state.energy);
+    final_energy.push_back(state.energy);
+    final_x.push_back(state.position.GetX());
+    final_y.push_back(state.position.GetY());
+    final_z.push_back(state.position.GetZ());
+    final_time.push_back(state.time);
+    propagated_distance.push_back(state.propagated_distance);
+    decayed.push_back(record.decayed);
+    final_weight.push_back(state.weight);
+
+    for (const auto& loss : record.losses) {
+        loss_type.push_back(loss.type);
+        loss_energy.push_back(loss.energy);
+        loss_parent_energy.push_back(loss.parent_particle_energy);
+        loss_x.push_back(loss.position.GetX());
+        loss_y.push_back(loss.position.GetY());
+        loss_z.push_back(loss.position.GetZ());
+        loss_time.push_back(loss.time);
+        loss_distance.push_back(loss.propagated_distance);
+        loss_target_hash.push_back(loss.target_hash);
+        loss_weight.push_back(loss.weight);
+    }
+    loss_offsets.push_back(loss_type.size());
+
+    for (size_t i = 0; i < record.track.size(); ++i) {
+        const auto& point = record.track[i];
+        track_type.push_back(static_cast<int32_t>(record.track_types[i]));
+        track_energy.push_back(point.energy);
+        track_x.push_back(point.position.GetX());
+        track_y.push_back(point.position.GetY());
+        track_z.push_back(point.position.GetZ());
+        track_dx.push_back(point.direction.GetX());
+        track_dy.push_back(point.direction.GetY());
+        track_dz.push_back(point.direction.GetZ());
+        track_time.push_back(point.time);
+        track_distance.push_back(point.propagated_distance);
+        track_weight.push_back(point.weight);
+    }
+    track_offsets.push_back(track_type.size());
+}
+
+void EventChunk::Append(const Secondaries& secondaries, bool store_track)
+{
+    EventRecord record(store_track);
+    const auto& track = secondaries.GetTrackData();
+    const auto& types = secondaries.GetTrackTypesData();
+    const auto& hashes = secondaries.GetTargetHashesData();
+    for (size_t i = 0; i < track.size(); ++i)
+        record.push_back(track[i], types[i], hashes[i]);
+    Append(record);
+}
+
+void EventChunk::clear()
+{
+    first_event = 0;
+    for_each_column(*this, true,
+        [](const char*, const char*, auto& column) { column.clear(); });
+    loss_offsets.push_back(0);
+    track_offsets.push_back(0);
+}
+
+EventWriter::EventWriter(const std::string& path, uint64_t config_hash,
+    int32_t particle_type, bool write_tracks, bool ordered,
+    uint64_t first_event, size_t max_pending)
+    : file_(path, std::ios::out | std::ios::binary | std::ios::trunc)
+    , ordered_(ordered)
+    , max_pending_(max_pending)
+    , next_event_(first_event)
+{
+    if (!file_.good())
+        throw std::invalid_argument("Could not open event file " + path);
+
+    header_.config_hash = config_hash;
+    header_.particle_type = particle_type;
+    header_.has_tracks = write_tracks;
+    header_.schema = create_schema(write_tracks);
+
+    write_value(file_, EventFileHeader::MAGIC);
+    write_value(file_, header_.version);
+    write_value(file_, header_.config_hash);
+    write_value(file_, header_.particle_type);
+    write_value(file_, static_cast<uint8_t>(header_.has_tracks));
+    write_value(file_, static_cast<uint64_t>(header_.schema.size()));
+    file_.write(header_.schema.data(), header_.schema.size());
+}
+
+EventWriter::EventWriter(const std::string& path, bool ordered,
+    uint64_t first_event, size_t max_pending)
+    : ordered_(ordered)
+    , max_pending_(max_pending)
+    , next_event_(first_event)
+{
+    header_ = EventReader(path).GetHeader();
+    if (header_.version != EventFileHeader::VERSION)
+        throw std::invalid_argument("Can not append to " + path
+            + ", it has the event file version "
+            + std::to_string(header_.version) + ".");
+    file_.open(path,
+        std::ios::out | std::ios::binary | std::ios::app | std::ios::ate);
+    if (!file_.good())
+        throw std::invalid_argument("Could not open event file " + path);
+}
+
+std::unique_ptr<EventWriter> EventWriter::Append(const std::string& path,
+    uint64_t first_event, bool ordered, size_t max_pending)
+{
+    return std::unique_ptr<EventWriter>(
+        new EventWriter(path, ordered, first_event, max_pending));
+}
+
+EventWriter::~EventWriter()
+{
+    try {
+        Close();
+    } catch (const std::exception& e) {
+        Logging::Get("proposal.output")->error(e.what());
+    }
+}
+
+void EventWriter::Write(EventChunk chunk)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open())
+        throw std::logic_error("Event file has already been closed.");
+
+    if (!ordered_) {
+        WriteChunk(chunk);
+        return;
+    }
+
+    auto first_event = chunk.first_event;
+    auto last_event = first_event + chunk.size();
+    if (first_event < next_event_)
+        throw std::invalid_argument("Events from "
+            + std::to_string(first_event) + " on have already been written.");
+    auto next = pending_.lower_bound(first_event);
+    if ((next != pending_.end()
+            && (next->first == first_event || next->first < last_event))
+        || (next != pending_.begin()
+            && std::prev(next)->first + std::prev(next)->second.size()
+                > first_event))
+        throw std::invalid_argument("The events "
+            + std::to_string(first_event) + " to "
+            + std::to_string(last_event) + " overlap a chunk waiting to be "
+            "written.");
+    if (first_event != next_event_ && pending_.size() >= max_pending_)
+        throw std::runtime_error("More than " + std::to_string(max_pending_)
+            + " chunks are waiting for event " + std::to_string(next_event_)
+            + ".");
+    pending_.emplace(first_event, std::move(chunk));
+    for (auto it = pending_.begin();
+         it != pending_.end() && it->first == next_event_;
+         it = pending_.erase(it)) {
+        WriteChunk(it->second);
+        next_event_ += it->second.size();
+    }
+}
+
+uint64_t EventWriter::Flush()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open())
+        throw std::logic_error("Event file has already been closed.");
+    file_.flush();
+    if (!file_.good())
+        throw std::runtime_error("Writing to the event file failed.");
+    return static_cast<uint64_t>(file_.tellp());
+}
+
+void EventWriter::Close()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open())
+        return;
+    file_.close();
+
+    if (!pending_.empty()) {
+        auto n_chunks = pending_.size();
+        auto first_pending = pending_.begin()->first;
+        pending_.clear();
+        throw std::runtime_error("Events " + std::to_string(next_event_)
+            + " to " + std::to_string(first_pending - 1)
+            + " are missing, " + std::to_string(n_chunks)
+            + " chunks behind them have not been written.");
+    }
+}
+
+uint64_t EventWriter::EventsWritten() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_written_;
+}
+
+void EventWriter::WriteChunk(const EventChunk& chunk)
+{
+    write_value(file_, CHUNK_MAGIC);
+    write_value(file_, chunk.first_event);
+    write_value(file_, static_cast<uint64_t>(chunk.size()));
+    write_value(file_, static_cast<uint64_t>(chunk.loss_type.size()));
+    write_value(file_,
+        static_cast<uint64_t>(header_.has_tracks ? chunk.track_type.size() : 0));
+
+    for_each_column(chunk, header_.has_tracks,
+        [this](const char*, const char*, const auto& column) {
+            write_column(file_, column);
+        });
+
+    if (!file_.good())
+        throw std::runtime_error("Writing to the event file failed.");
+    events_written_ += chunk.size();
+}
+
+EventReader::EventReader(const std::string& path)
+    : file_(path, std::ios::in | std::ios::binary)
+{
+    if (!file_.good())
+        throw std::invalid_argument("Could not open event file " + path);
+
+    uint32_t magic;
+    uint8_t has_tracks;
+    uint64_t schema_size;
+    if (!read_value(file_, magic) || magic != EventFileHeader::MAGIC)
+        throw std::invalid_argument(path + " is not a PROPOSAL event file.");
+    read_value(file_, header_.version);
+    if (header_.version < 1 || header_.version > EventFileHeader::VERSION)
+        throw std::invalid_argument("Unsupported event file version "
+            + std::to_string(header_.version));
+    read_value(file_, header_.config_hash);
+    read_value(file_, header_.particle_type);
+    read_value(file_, has_tracks);
+    read_value(file_, schema_size);
+    header_.has_tracks = has_tracks;
+    header_.schema.resize(schema_size);
+    file_.read(&header_.schema[0], schema_size);
+    if (!file_)
+        throw std::invalid_argument("Event file header of " + path
+            + " is truncated.");
+}
+
+bool EventReader::ReadChunk(EventChunk& chunk)
+{
+    uint32_t magic;
+    if (!read_value(file_, magic))
+        return false;
+    if (magic != CHUNK_MAGIC)
+        throw std::runtime_error("Corrupted chunk in event file.");
+
+    uint64_t n_events, n_losses, n_points;
+    read_value(file_, chunk.first_event);
+    read_value(file_, n_events);
+    read_value(file_, n_losses);
+    read_value(file_, n_points);
+
+    for_each_column(chunk, true,
+        [&](const char* table, const char* name, auto& column) {
+            std::string t(table);
+            size_t n = n_events;
+            if (t == "offset")
+                n = n_events + 1;
+            else if (t == "loss")
+                n = n_losses;
+            else if (t == "track")
+                n = header_.has_tracks ? n_points : 0;
+            if (header_.version < 2 && is_weight_column(name))
+                column.assign(n, 1.);
+            else
+                read_column(file_, column, n);
+        });
+
+    if (!file_)
+        throw std::runtime_error("Event file ends within a chunk.");
+    return true;
+}
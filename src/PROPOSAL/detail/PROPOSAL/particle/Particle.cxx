@@ -34,6 +34,7 @@ std::ostream& operator<<(std::ostream& os, ParticleState const& data)
     os << "energy: " << data.energy << '\n';
     os << "time: " << data.time << '\n';
     os << "propagated distance: " << data.propagated_distance << '\n';
+    os << "weight: " << data.weight << '\n';
 
     data.print(os);
 
@@ -91,6 +92,8 @@ bool ParticleState::operator==(const ParticleState& dynamic_data) const
         return false;
     if (propagated_distance != dynamic_data.propagated_distance)
         return false;
+    if (weight != dynamic_data.weight)
+        return false;
 
     return true;
 }
@@ -120,11 +123,12 @@ double ParticleState::GetMomentum() const
 StochasticLoss::StochasticLoss(int type, double loss_energy, const Vector3D& position,
                                const Vector3D& direction, double time,
                                double propagated_distance,
-                               double parent_particle_energy, size_t target_hash)
+                               double parent_particle_energy, size_t target_hash,
+                               double weight)
                                : Loss(type, loss_energy, parent_particle_energy),
                                position(position), direction(direction), time(time),
                                propagated_distance(propagated_distance),
-                               target_hash(target_hash) {}
+                               target_hash(target_hash), weight(weight) {}
 
 ContinuousLoss::ContinuousLoss(double energy, double parent_particle_energy,
                                const Vector3D& start_position,
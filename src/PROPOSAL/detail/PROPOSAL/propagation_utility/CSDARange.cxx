@@ -0,0 +1,36 @@
+#include "PROPOSAL/propagation_utility/CSDARange.h"
+#include "PROPOSAL/propagation_utility/Displacement.h"
+
+#include <cmath>
+#include <stdexcept>
+
+using namespace PROPOSAL;
+
+CSDARange::CSDARange(Displacement& disp, double upper_lim, size_t nodes)
+    : lower_lim(disp.GetLowerLim())
+    , log_lower(std::log(lower_lim))
+{
+    if (nodes < 2)
+        throw std::invalid_argument("At least two nodes are required.");
+    if (upper_lim <= lower_lim)
+        throw std::invalid_argument("The upper energy limit of the range "
+                                    "table must be above the lower limit.");
+
+    log_step = (std::log(upper_lim) - log_lower) / (nodes - 1);
+    grammage.reserve(nodes);
+    grammage.push_back(0.);
+    for (size_t i = 1; i < nodes; ++i) {
+        auto energy = std::exp(log_lower + i * log_step);
+        grammage.push_back(disp.SolveTrackIntegral(energy, lower_lim));
+    }
+}
+
+double CSDARange::GetGrammage(double energy) const
+{
+    if (energy <= lower_lim)
+        return 0.;
+    auto node = std::ceil((std::log(energy) - log_lower) / log_step);
+    if (node >= grammage.size())
+        return INF;
+    return grammage[static_cast<size_t>(node)];
+}
@@ -34,6 +34,12 @@ double DecayBuilder::EnergyDecay(double energy, double rnd, double density)
     return decay_integral->GetUpperLimit(energy, rndd * lifetime);
 }
 
+double DecayBuilder::SurvivalProbability(
+    double E_i, double E_f, double density)
+{
+    return std::exp(-decay_integral->Calculate(E_i, E_f) / lifetime / density);
+}
+
 namespace PROPOSAL {
 std::unique_ptr<Decay> make_decay(
     std::shared_ptr<Displacement> disp, const ParticleDef& p, bool interpol)
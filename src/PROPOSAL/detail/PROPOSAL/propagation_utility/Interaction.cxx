@@ -1,7 +1,9 @@
 #include "PROPOSAL/propagation_utility/Interaction.h"
+#include "PROPOSAL/Constants.h"
 #include "PROPOSAL/crosssection/CrossSection.h"
 #include "PROPOSAL/propagation_utility/Displacement.h"
 
+#include <cmath>
 #include <sstream>
 #include <numeric>
 
@@ -12,6 +14,8 @@ Interaction::Interaction(
     : disp(_disp)
     , cross_list(_cross)
     , hash(CrossSectionVector::GetHash(cross_list))
+    , binned_log_energy_low(0.)
+    , binned_log_energy_step(0.)
 {
     if (cross_list.size() < 1)
         throw std::invalid_argument("At least one crosssection is required.");
@@ -75,3 +79,121 @@ std::vector<Interaction::Rate> Interaction::Rates(double energy)
     }
     return rates;
 }
+
+void Interaction::BuildBinnedSampling(size_t bins_per_decade, size_t loss_bins)
+{
+    if (bins_per_decade < 1 || loss_bins < 1)
+        throw std::invalid_argument("At least one energy bin per decade and "
+                                    "one loss bin are required.");
+
+    auto log_low = std::log(disp->GetLowerLim());
+    auto log_up = std::log(InterpolationSettings::UPPER_ENERGY_LIM);
+    auto n_nodes = static_cast<size_t>(
+                       std::ceil((log_up - log_low) / std::log(10.)
+                           * bins_per_decade))
+        + 1;
+    n_nodes = std::max(n_nodes, size_t(2));
+
+    binned_log_energy_low = log_low;
+    binned_log_energy_step = (log_up - log_low) / (n_nodes - 1);
+    binned_channels.clear();
+    binned_nodes.clear();
+
+    for (size_t k = 0; k < n_nodes; ++k) {
+        auto energy = std::exp(log_low + k * binned_log_energy_step);
+        auto rates = Rates(energy);
+        if (binned_channels.empty())
+            for (auto& r : rates)
+                binned_channels.push_back({ r.crosssection, r.comp_hash });
+
+        auto node = BinnedNode();
+        auto weights = std::vector<double>();
+        for (auto& r : rates) {
+            auto rate = std::max(r.rate, 0.);
+            weights.push_back(rate);
+
+            auto loss_table = AliasTable();
+            auto log_v_low = NAN;
+            auto log_v_up = NAN;
+            if (rate > 0) {
+                auto v_low = r.crosssection->CalculateStochasticLoss(
+                    r.comp_hash, energy, 0.);
+                auto v_up = r.crosssection->CalculateStochasticLoss(
+                    r.comp_hash, energy, rate);
+                log_v_up = std::log(v_up);
+                log_v_low = log_v_up;
+                if (v_low > 0 && v_up > v_low) {
+                    log_v_low = std::log(v_low);
+                    auto loss_weights = std::vector<double>(loss_bins);
+                    auto cum_low = 0.;
+                    for (size_t j = 0; j < loss_bins; ++j) {
+                        auto v = std::exp(log_v_low
+                            + (j + 1.) / loss_bins * (log_v_up - log_v_low));
+                        auto cum_up = r.crosssection
+                            ->CalculateCumulativeCrosssection(
+                                energy, r.comp_hash, v);
+                        loss_weights[j] = std::max(cum_up - cum_low, 0.);
+                        cum_low = std::max(cum_up, cum_low);
+                    }
+                    loss_table = AliasTable(loss_weights);
+                }
+            }
+            node.loss_tables.push_back(loss_table);
+            node.log_v_low.push_back(log_v_low);
+            node.log_v_up.push_back(log_v_up);
+        }
+        node.channel_table = AliasTable(weights);
+        binned_nodes.push_back(std::move(node));
+    }
+}
+
+Interaction::Loss Interaction::SampleLossBinned(
+    double energy, double rnd1, double rnd2)
+{
+    auto x = (std::log(energy) - binned_log_energy_low) / binned_log_energy_step;
+    if (binned_nodes.empty() || !(x >= 0)
+        || x > static_cast<double>(binned_nodes.size() - 1))
+        return SampleLoss(energy, Rates(energy), rnd1);
+
+    auto k = std::min(static_cast<size_t>(x), binned_nodes.size() - 2);
+    auto w = x - k;
+
+    // choose one of the neighbouring nodes and rescale the random number
+    auto rnd = rnd1;
+    auto node_idx = k;
+    if (rnd < w) {
+        node_idx = k + 1;
+        rnd = rnd / w;
+    } else {
+        rnd = (rnd - w) / (1. - w);
+    }
+
+    auto& node = binned_nodes[node_idx];
+    if (node.channel_table.Empty())
+        return SampleLoss(energy, Rates(energy), rnd1);
+
+    auto c = node.channel_table.Sample(rnd).first;
+    auto& channel = binned_channels[c];
+
+    // the range of the loss is interpolated between the nodes, which
+    // reproduces e.g. v_cut = e_cut / E exactly
+    auto log_v_low = node.log_v_low[c];
+    auto log_v_up = node.log_v_up[c];
+    auto& low = binned_nodes[k];
+    auto& up = binned_nodes[k + 1];
+    if (std::isfinite(low.log_v_low[c]) && std::isfinite(up.log_v_low[c])) {
+        log_v_low = (1. - w) * low.log_v_low[c] + w * up.log_v_low[c];
+        log_v_up = (1. - w) * low.log_v_up[c] + w * up.log_v_up[c];
+    }
+
+    auto v = std::exp(log_v_up);
+    auto& loss_table = node.loss_tables[c];
+    if (!loss_table.Empty()) {
+        auto sample = loss_table.Sample(rnd2);
+        auto t = (sample.first + sample.second) / loss_table.GetSize();
+        v = std::exp(log_v_low + t * (log_v_up - log_v_low));
+    }
+
+    return { channel.crosssection->GetInteractionType(), channel.comp_hash,
+        v };
+}
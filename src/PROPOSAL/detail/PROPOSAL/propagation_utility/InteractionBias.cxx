@@ -0,0 +1,63 @@
+#include "PROPOSAL/propagation_utility/InteractionBias.h"
+#include "PROPOSAL/crosssection/CrossSectionBias.h"
+#include "PROPOSAL/propagation_utility/InteractionBuilder.h"
+
+#include <cmath>
+
+using namespace PROPOSAL;
+
+InteractionBias::InteractionBias(std::shared_ptr<Interaction> _biased,
+    std::shared_ptr<Interaction> _unbiased,
+    std::map<InteractionType, double> _bias)
+    : biased(_biased)
+    , unbiased(_unbiased)
+    , bias(_bias)
+{
+    if (!biased || !unbiased)
+        throw std::invalid_argument("Biased and unbiased interaction "
+                                    "calculator need to be defined.");
+}
+
+double InteractionBias::WeightContinuous(double E_i, double E_f) const
+{
+    if (E_i <= E_f)
+        return 1.;
+    return std::exp(
+        biased->EnergyIntegral(E_i, E_f) - unbiased->EnergyIntegral(E_i, E_f));
+}
+
+double InteractionBias::WeightStochastic(InteractionType type) const
+{
+    return 1. / GetBias(type);
+}
+
+double InteractionBias::GetBias(InteractionType type) const
+{
+    auto it = bias.find(type);
+    if (it == bias.end())
+        return 1.;
+    return it->second;
+}
+
+namespace PROPOSAL {
+std::unique_ptr<InteractionBias> make_interaction_bias(
+    std::shared_ptr<Interaction> biased, std::shared_ptr<Displacement> disp,
+    std::vector<std::shared_ptr<CrossSectionBase>> const& cross,
+    bool interpolate)
+{
+    auto unbiased_cross = cross;
+    auto bias = std::map<InteractionType, double>();
+    for (auto& c : unbiased_cross) {
+        auto c_bias = std::dynamic_pointer_cast<CrossSectionBias>(c);
+        if (c_bias) {
+            bias[c_bias->GetInteractionType()] = c_bias->GetBias();
+            c = c_bias->GetCrossSection();
+        }
+    }
+    if (bias.empty())
+        return nullptr;
+    auto unbiased = std::shared_ptr<Interaction>(
+        make_interaction(disp, unbiased_cross, interpolate));
+    return std::make_unique<InteractionBias>(biased, unbiased, bias);
+}
+} // namespace PROPOSAL
@@ -4,13 +4,63 @@
 #include "PROPOSAL/propagation_utility/Decay.h"
 #include "PROPOSAL/propagation_utility/Displacement.h"
 #include "PROPOSAL/propagation_utility/Interaction.h"
+#include "PROPOSAL/propagation_utility/InteractionBias.h"
 #include "PROPOSAL/propagation_utility/Time.h"
 #include "PROPOSAL/scattering/Scattering.h"
 #include "PROPOSAL/crosssection/CrossSection.h"
+#include "PROPOSAL/EnergyCutSettings.h"
+#include "PROPOSAL/math/MathMethods.h"
 #include "PROPOSAL/math/Spherical3D.h"
 
+#include <algorithm>
+
 using namespace PROPOSAL;
 
+namespace {
+// Solves f(E) = 0 for an increasing function f between energy and the upper
+// limit of the interpolation tables. Returns INF if there is no root.
+double solve_energy_above(std::function<double(double)> f, double energy)
+{
+    auto upper_energy = InterpolationSettings::UPPER_ENERGY_LIM;
+    if (energy >= upper_energy || f(upper_energy) < 0)
+        return INF;
+    auto root = Bisection([&f](double log_energy) { return f(std::exp(log_energy)); },
+        std::log(energy), std::log(upper_energy), 1e-10, 100);
+    return std::exp(0.5 * (root.first + root.second));
+}
+
+double total_rate(const std::vector<Interaction::Rate>& rates)
+{
+    auto total = 0.;
+    for (auto& r : rates)
+        total += r.rate;
+    return total;
+}
+
+// relative width of the interval in v used to compare differential
+// crosssections
+constexpr double ADJOINT_DELTA_V = 1e-3;
+
+// Smallest loss which ends at the energy E_f, if the cut
+// min(e_cut, v_cut * E_i) is applied at the energy E_i = E_f + loss before
+// the loss.
+double minimal_adjoint_loss(const EnergyCutSettings* cuts, double energy)
+{
+    if (!cuts)
+        return 0.;
+    auto loss = cuts->GetEcut();
+    if (cuts->GetVcut() < 1.)
+        loss = std::min(
+            loss, cuts->GetVcut() * energy / (1. - cuts->GetVcut()));
+    return std::isfinite(loss) ? loss : 0.;
+}
+
+struct AdjointProposal {
+    Interaction::Rate rate;
+    double energy;
+};
+} // namespace
+
 /*
 PropagationUtility::Definition::Definition(CrossSectionList cross,
     const ParticleDef& p_def, std::shared_ptr<Scattering> scattering = nullptr,
@@ -74,6 +124,8 @@ bool PropagationUtility::Collection::operator==(const Collection& lhs)
         return false;
     if (cont_rand != lhs.cont_rand)
         return false;
+    if (bias != lhs.bias)
+        return false;
     return true;
 }
 
@@ -98,6 +150,18 @@ Interaction::Loss PropagationUtility::EnergyStochasticloss(double energy,
     return loss;
 }
 
+Interaction::Loss PropagationUtility::EnergyStochasticloss(
+    double energy, std::function<double()> rnd)
+{
+    if (collection.interaction_calc->HasBinnedSampling()) {
+        auto rnd1 = rnd();
+        auto rnd2 = rnd();
+        return collection.interaction_calc->SampleLossBinned(
+            energy, rnd1, rnd2);
+    }
+    return EnergyStochasticloss(energy, rnd());
+}
+
 double PropagationUtility::EnergyDecay(
     double energy, std::function<double()> rnd, double density)
 {
@@ -138,6 +202,144 @@ double PropagationUtility::TimeElapsed(
         initial_energy, final_energy, distance, density);
 }
 
+double PropagationUtility::WeightContinuous(
+    double initial_energy, double final_energy) const
+{
+    if (collection.bias)
+        return collection.bias->WeightContinuous(initial_energy, final_energy);
+    return 1.; // no biasing
+}
+
+double PropagationUtility::WeightStochastic(InteractionType type) const
+{
+    if (collection.bias)
+        return collection.bias->WeightStochastic(type);
+    return 1.; // no biasing
+}
+
+std::pair<double, double> PropagationUtility::EnergyForcedInteraction(
+    double initial_energy, double final_energy, std::function<double()> rnd)
+{
+    auto& interaction = collection.interaction_calc;
+    auto probability = -std::expm1(
+        -interaction->EnergyIntegral(initial_energy, final_energy));
+    if (probability <= 0.)
+        return std::make_pair(final_energy, 0.);
+    auto energy = interaction->EnergyInteraction(
+        initial_energy, 1. - rnd() * probability);
+    return std::make_pair(std::max(energy, final_energy), probability);
+}
+
+double PropagationUtility::EnergyAdjointInteraction(
+    double energy, std::function<double()> rnd)
+{
+    auto rndi = -std::log(rnd());
+    auto& interaction = collection.interaction_calc;
+    return solve_energy_above(
+        [&interaction, energy, rndi](double E) {
+            return interaction->EnergyIntegral(E, energy) - rndi;
+        },
+        energy);
+}
+
+double PropagationUtility::EnergyAdjointDistance(
+    double final_energy, double grammage)
+{
+    auto& displacement = collection.displacement_calc;
+    return solve_energy_above(
+        [&displacement, final_energy, grammage](double E) {
+            return displacement->SolveTrackIntegral(E, final_energy) - grammage;
+        },
+        final_energy);
+}
+
+PropagationUtility::AdjointLoss PropagationUtility::EnergyAdjointStochasticloss(
+    double energy, std::function<double()> rnd)
+{
+    // Every crosssection proposes the loss at energy + its smallest loss
+    // which ends at energy. There, the smallest relative loss equals the
+    // smallest one of all energies before the loss which can lead to energy.
+    auto& interaction = collection.interaction_calc;
+    auto rates_final = interaction->Rates(energy);
+    auto rate_final = total_rate(rates_final);
+
+    std::vector<AdjointProposal> proposals;
+    std::vector<CrossSectionBase*> proposed;
+    for (auto& r : rates_final) {
+        auto cross = r.crosssection.get();
+        if (std::find(proposed.begin(), proposed.end(), cross) != proposed.end())
+            continue;
+        proposed.push_back(cross);
+        auto proposal_energy = energy
+            + minimal_adjoint_loss(cross->GetEnergyCutSettings().get(), energy);
+        for (auto& dndx : cross->CalculatedNdx_PerTarget(proposal_energy))
+            proposals.push_back(AdjointProposal { Interaction::Rate {
+                r.crosssection, dndx.first, dndx.second }, proposal_energy });
+    }
+    auto rate = 0.;
+    for (auto& p : proposals)
+        rate += p.rate.rate;
+
+    auto adjoint = AdjointLoss { Interaction::Loss(), 0. };
+    adjoint.loss.type = InteractionType::Undefined;
+    if (!(rate > 0) || !(rate_final > 0))
+        return adjoint;
+
+    auto sampled_rate = rnd() * rate;
+    auto proposal = proposals.end();
+    for (auto it = proposals.begin(); it != proposals.end(); ++it) {
+        if (!(it->rate.rate > 0))
+            continue;
+        proposal = it;
+        if (sampled_rate < it->rate.rate)
+            break;
+        sampled_rate -= it->rate.rate;
+    }
+    auto& cross = proposal->rate.crosssection;
+    auto comp_hash = proposal->rate.comp_hash;
+    sampled_rate = std::min(sampled_rate, proposal->rate.rate);
+    adjoint.loss = Interaction::Loss { cross->GetInteractionType(), comp_hash,
+        cross->CalculateStochasticLoss(comp_hash, proposal->energy,
+            proposal->rate.rate - sampled_rate) };
+
+    // weight: ratio of the differential crosssection before the loss and
+    // the proposed one, the ratio of the total rates used to sample the
+    // interaction point and the jacobian of E_i = E_f / (1 - v). With biased
+    // crosssections, the true differential crosssection is the biased one
+    // divided by the bias.
+    auto v = adjoint.loss.v_loss;
+    if (!(v > 0 && v < 1)
+        || energy / (1. - v) > InterpolationSettings::UPPER_ENERGY_LIM)
+        return adjoint;
+    auto initial_energy = energy / (1. - v);
+    auto v_low = v * (1. - ADJOINT_DELTA_V);
+    auto v_up = std::min(v * (1. + ADJOINT_DELTA_V), 1.);
+    auto dndv_initial
+        = cross->CalculateCumulativeCrosssection(initial_energy, comp_hash, v_up)
+        - cross->CalculateCumulativeCrosssection(initial_energy, comp_hash, v_low);
+    auto dndv
+        = cross->CalculateCumulativeCrosssection(proposal->energy, comp_hash, v_up)
+        - cross->CalculateCumulativeCrosssection(proposal->energy, comp_hash, v_low);
+    if (dndv > 0 && dndv_initial > 0)
+        adjoint.weight = dndv_initial / dndv * rate / rate_final / (1. - v)
+            * WeightStochastic(adjoint.loss.type);
+    return adjoint;
+}
+
+double PropagationUtility::WeightAdjointContinuous(
+    double initial_energy, double final_energy, double density)
+{
+    if (initial_energy == final_energy)
+        return 1.;
+    // jacobian dE_i / dE_f of the continuous losses over a fixed grammage
+    auto weight = collection.displacement_calc->FunctionToIntegral(final_energy)
+        / collection.displacement_calc->FunctionToIntegral(initial_energy);
+    if (collection.decay_calc)
+        weight *= collection.decay_calc->SurvivalProbability(
+            initial_energy, final_energy, density);
+    return weight;
+}
+
 std::tuple<Cartesian3D, Cartesian3D> PropagationUtility::DirectionsScatter(
     double displacement, double initial_energy, double final_energy,
     const Vector3D& direction, std::function<double()> rnd)
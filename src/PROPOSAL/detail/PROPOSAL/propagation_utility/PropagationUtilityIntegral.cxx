@@ -8,8 +8,7 @@ using namespace PROPOSAL;
 
 UtilityIntegral::UtilityIntegral(
     std::function<double(double)> _func, double _lower_lim, size_t _hash)
-    : integral(IROMB, IMAXS, IPREC2)
-    , lower_lim(_lower_lim)
+    : lower_lim(_lower_lim)
     , FunctionToIntegral(_func)
     , hash(_hash)
 {
@@ -17,12 +16,14 @@ UtilityIntegral::UtilityIntegral(
 
 double UtilityIntegral::Calculate(double energy_initial, double energy_final)
 {
+    Integral integral(IROMB, IMAXS, IPREC2);
     return integral.Integrate(
         energy_initial, energy_final, FunctionToIntegral, 4);
 }
 
 double UtilityIntegral::GetUpperLimit(double energy_initial, double rnd)
 {
+    Integral integral(IROMB, IMAXS, IPREC2);
     auto sum = integral.IntegrateWithRandomRatio(
         energy_initial, lower_lim, FunctionToIntegral, 4, -rnd);
 
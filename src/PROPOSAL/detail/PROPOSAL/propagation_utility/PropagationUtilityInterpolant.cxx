@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <functional>
@@ -58,6 +59,73 @@ void UtilityInterpolant::BuildTables(const std::string prefix, size_t nodes,
 
     interpolant_ = std::make_shared<interpolant_t>(
             std::move(def), gen_path(), gen_name(prefix));
+
+    BuildInverse(nodes);
+}
+
+void UtilityInterpolant::BuildInverse(size_t nodes)
+{
+    inverse_integral_.clear();
+    inverse_log_energy_.clear();
+    inverse_derivative_.clear();
+
+    auto axis = cubic_splines::ExpAxis<double>(
+            lower_lim, InterpolationSettings::UPPER_ENERGY_LIM, nodes);
+    auto sign = reverse_ ? -1. : 1.;
+
+    for (size_t i = 0; i < nodes; ++i) {
+        auto energy = axis.back_transform(i);
+        auto integral = sign * interpolant_->evaluate(energy);
+
+        // d(integral)/dE, the integral is calculated from E to the
+        // reference energy
+        auto derivative = -FunctionToIntegral(energy);
+
+        if (!inverse_integral_.empty() && !(integral > inverse_integral_.back())) {
+            Logging::Get("proposal.UtilityInterpolant")->debug(
+                    "Integral is not strictly monotonic. No inverse "
+                    "interpolant is used.");
+            inverse_integral_.clear();
+            inverse_log_energy_.clear();
+            inverse_derivative_.clear();
+            return;
+        }
+
+        inverse_integral_.push_back(integral);
+        inverse_log_energy_.push_back(std::log(energy));
+        inverse_derivative_.push_back(1. / (energy * derivative));
+    }
+}
+
+double UtilityInterpolant::EvaluateInverse(double integral) const
+{
+    auto it = std::upper_bound(
+            inverse_integral_.begin(), inverse_integral_.end(), integral);
+    if (it == inverse_integral_.begin() || it == inverse_integral_.end())
+        return NAN;
+    auto i = std::distance(inverse_integral_.begin(), it) - 1;
+
+    // cubic hermite interpolation of ln(E) between the nodes i and i + 1
+    auto h = inverse_integral_[i + 1] - inverse_integral_[i];
+    auto t = (integral - inverse_integral_[i]) / h;
+    auto t2 = t * t;
+    auto t3 = t2 * t;
+
+    auto y0 = inverse_log_energy_[i];
+    auto y1 = inverse_log_energy_[i + 1];
+    auto m0 = std::isfinite(inverse_derivative_[i]) ? inverse_derivative_[i]
+                                                    : (y1 - y0) / h;
+    auto m1 = std::isfinite(inverse_derivative_[i + 1])
+            ? inverse_derivative_[i + 1]
+            : (y1 - y0) / h;
+
+    auto log_energy = (2 * t3 - 3 * t2 + 1) * y0 + (t3 - 2 * t2 + t) * h * m0
+            + (-2 * t3 + 3 * t2) * y1 + (t3 - t2) * h * m1;
+
+    // the hermite polynomial may overshoot for steep inverse functions
+    log_energy = std::min(std::max(log_energy, y0), y1);
+
+    return std::exp(log_energy);
 }
 
 
@@ -96,6 +164,21 @@ double UtilityInterpolant::GetUpperLimit(double upper_limit, double rnd)
         rnd = -rnd;
 
     auto integrated_to_upper = interpolant_->evaluate(upper_limit);
+
+    // evaluate the inverse interpolant and polish the result with one
+    // Newton-Raphson step on the forward interpolant
+    if (!inverse_integral_.empty()) {
+        auto target = integrated_to_upper - rnd;
+        auto energy = EvaluateInverse(reverse_ ? -target : target);
+        if (std::isfinite(energy)) {
+            auto derivative = reverse_ ? FunctionToIntegral(energy)
+                                       : -FunctionToIntegral(energy);
+            if (derivative != 0.)
+                energy -= (interpolant_->evaluate(energy) - target) / derivative;
+            return std::min(std::max(energy, lower_lim), upper_limit);
+        }
+    }
+
     auto initial_guess = cubic_splines::ParameterGuess<double>();
 
     // find initial parameters for newton raphson method by using bisection
@@ -37,12 +37,13 @@ ScatteringOffset Moliere::CalculateRandomAngle(
     }
 
     // Calculate Chi_c^2
-    chiCSq_ = ((4. * PI * NA * ALPHA * ALPHA * HBAR * HBAR * SPEED * SPEED)
+    StepParameters params;
+    params.chiCSq = ((4. * PI * NA * ALPHA * ALPHA * HBAR * HBAR * SPEED * SPEED)
                   * (grammage) / beta_p_Sq)
         * ZSq_A_average_;
 
     // Calculate B
-
+    params.B.resize(numComp_);
     for (int i = 0; i < numComp_; i++) {
         // calculate B-ln(B) = ln(chi_c^2/chi_a^2)+1-2*EULER_MASCHERONI via
         // Newton-Raphson method
@@ -52,7 +53,7 @@ ScatteringOffset Moliere::CalculateRandomAngle(
             if (xn < 0)
                 return offsets; // xn would become nan for further iterations
             xn = xn
-                * ((1. - std::log(xn) - std::log(chiCSq_ / chi_A_Sq[i]) - 1.
+                * ((1. - std::log(xn) - std::log(params.chiCSq / chi_A_Sq[i]) - 1.
                        + 2. * EULER_MASCHERONI)
                     / (1. - xn));
         }
@@ -63,19 +64,19 @@ ScatteringOffset Moliere::CalculateRandomAngle(
             return offsets;
         }
 
-        B_[i] = xn;
+        params.B[i] = xn;
     }
 
-    double pre_factor = std::sqrt(chiCSq_ * B_[max_weight_index_]);
+    double pre_factor = std::sqrt(params.chiCSq * params.B[max_weight_index_]);
 
-    auto rnd1 = GetRandom(pre_factor, rnd[0]);
-    auto rnd2 = GetRandom(pre_factor, rnd[1]);
+    auto rnd1 = GetRandom(params, pre_factor, rnd[0]);
+    auto rnd2 = GetRandom(params, pre_factor, rnd[1]);
 
     offsets.sx = 0.5 * (rnd1 / SQRT3 + rnd2);
     offsets.tx = rnd2;
 
-    rnd1 = GetRandom(pre_factor, rnd[2]);
-    rnd2 = GetRandom(pre_factor, rnd[3]);
+    rnd1 = GetRandom(params, pre_factor, rnd[2]);
+    rnd2 = GetRandom(params, pre_factor, rnd[3]);
 
     offsets.sy = 0.5 * (rnd1 / SQRT3 + rnd2);
     offsets.ty = rnd2;
@@ -97,8 +98,6 @@ Moliere::Moliere(const ParticleDef& particle_def, Medium const& medium)
     , weight_ZZ_(numComp_)
     , weight_ZZ_sum_(0.)
     , max_weight_index_(0)
-    , chiCSq_(0.0)
-    , B_(numComp_)
 {
     std::vector<double> Ai(numComp_,
         0); // atomic number of different components
@@ -167,10 +166,6 @@ bool Moliere::compare(const Parametrization& scattering) const
         return false;
     else if (max_weight_index_ != sc->max_weight_index_)
         return false;
-    else if (chiCSq_ != sc->chiCSq_)
-        return false;
-    else if (B_ != sc->B_)
-        return false;
     else
         return true;
 }
@@ -187,7 +182,7 @@ void Moliere::print(std::ostream& os) const { os << "work in progress\n"; }
 //--------------------------calculate distribution----------------------------//
 //----------------------------------------------------------------------------//
 
-double Moliere::f1M(double x)
+double Moliere::f1M(double x) const
 {
     // approximation for large numbers to avoid numerical errors
     if (x > 12.)
@@ -226,7 +221,7 @@ double f2Mlarge(double x)
     return sum;
 }
 
-double Moliere::f2M(double x)
+double Moliere::f2M(double x) const
 {
     // approximation for larger x to avoid numerical errors
     if (x > 4.25 * 4.25)
@@ -242,15 +237,16 @@ double Moliere::f2M(double x)
 
 //----------------------------------------------------------------------------//
 
-double Moliere::f(double theta)
+double Moliere::f(double theta, const StepParameters& params) const
 {
     double y1 = 0;
 
     for (int i = 0; i < numComp_; i++) {
-        double x = theta * theta / (chiCSq_ * B_[i]);
+        double x = theta * theta / (params.chiCSq * params.B[i]);
 
-        y1 += weight_ZZ_[i] / std::sqrt(chiCSq_ * B_[i] * PI)
-            * (std::exp(-x) + f1M(x) / B_[i] + f2M(x) / (B_[i] * B_[i]));
+        y1 += weight_ZZ_[i] / std::sqrt(params.chiCSq * params.B[i] * PI)
+            * (std::exp(-x) + f1M(x) / params.B[i]
+                + f2M(x) / (params.B[i] * params.B[i]));
     }
 
     return y1 * weight_ZZ_sum_;
@@ -271,7 +267,7 @@ double F1Mlarge(double x)
     return sum;
 }
 
-double Moliere::F1M(double x)
+double Moliere::F1M(double x) const
 {
     if (x > 12.)
         return F1Mlarge(x);
@@ -309,7 +305,7 @@ double F2Mlarge(double x)
     return sum;
 }
 
-double Moliere::F2M(double x)
+double Moliere::F2M(double x) const
 {
     if (x > 4.25 * 4.25)
         return F2Mlarge(x);
@@ -324,17 +320,18 @@ double Moliere::F2M(double x)
 
 //----------------------------------------------------------------------------//
 
-double Moliere::F(double theta)
+double Moliere::F(double theta, const StepParameters& params) const
 {
     double y1 = 0;
 
     for (int i = 0; i < numComp_; i++) {
-        double x = theta * theta / (chiCSq_ * B_[i]);
+        double x = theta * theta / (params.chiCSq * params.B[i]);
 
         y1 += weight_ZZ_[i]
             * (0.5 * std::erf(std::sqrt(x))
                 + std::sqrt(1. / PI)
-                    * (F1M(x) / B_[i] + F2M(x) / (B_[i] * B_[i])));
+                    * (F1M(x) / params.B[i]
+                        + F2M(x) / (params.B[i] * params.B[i])));
     }
 
     return (theta < 0.) ? (-1.) * y1 * weight_ZZ_sum_ : y1 * weight_ZZ_sum_;
@@ -344,7 +341,8 @@ double Moliere::F(double theta)
 //-------------------------generate random angle------------------------------//
 //----------------------------------------------------------------------------//
 
-double Moliere::GetRandom(double pre_factor, double rnd)
+double Moliere::GetRandom(
+    const StepParameters& params, double pre_factor, double rnd) const
 {
     //  Generate random angles following Moliere's distribution by comparing a
     //  uniformly distributed random number with the integral of the
@@ -364,7 +362,7 @@ double Moliere::GetRandom(double pre_factor, double rnd)
     // iterating until the number of correct digits is greater than 4
     do {
         theta_n = theta_np1;
-        theta_np1 = theta_n - (F(theta_n) - rnd) / f(theta_n);
+        theta_np1 = theta_n - (F(theta_n, params) - rnd) / f(theta_n, params);
 
     } while (std::abs((theta_n - theta_np1) / theta_np1) > 1e-4);
 
@@ -0,0 +1,132 @@
+
+#include <cmath>
+
+#include "PROPOSAL/Constants.h"
+#include "PROPOSAL/methods.h"
+#include "PROPOSAL/particle/ParticleDef.h"
+#include "PROPOSAL/scattering/multiple_scattering/MoliereInterpol.h"
+
+#include "CubicInterpolation/Axis.h"
+
+using namespace PROPOSAL::multiple_scattering;
+
+constexpr double MoliereInterpol::B_MAX;
+constexpr double MoliereInterpol::S_MAX;
+constexpr size_t MoliereInterpol::NODES_B;
+constexpr size_t MoliereInterpol::NODES_RND;
+
+namespace {
+// Solve B - ln(B) = c for the branch B > 1 via Newton-Raphson method.
+double SolveB(double c)
+{
+    auto xn = c + std::log(c);
+    for (int n = 0; n < 20; n++) {
+        auto dx = (xn - std::log(xn) - c) / (1. - 1. / xn);
+        xn -= dx;
+        if (std::abs(dx) < 1e-12 * xn)
+            break;
+    }
+    return xn;
+}
+} // namespace
+
+MoliereInterpol::MoliereInterpol(
+    const ParticleDef& particle_def, Medium const& medium)
+    : Moliere(particle_def, medium)
+    , inverse_cdf_(nullptr)
+    , offsets_(numComp_)
+    , B_min_(4.5)
+{
+    // screening angle chi_a^2 up to a common factor for beta -> 1
+    auto chi_A_Sq = [](double Z) {
+        return std::pow(Z, 2. / 3.) * (1.13 + 3.76 * ALPHA * ALPHA * Z * Z);
+    };
+    auto min_offset = 0.;
+    for (int i = 0; i < numComp_; i++) {
+        offsets_[i] = std::log(
+            chi_A_Sq(Zi_[max_weight_index_]) / chi_A_Sq(Zi_[i]));
+        min_offset = std::min(min_offset, offsets_[i]);
+    }
+
+    // smallest B of the reference component for which all B_i >= 4.5
+    B_min_ = SolveB(4.5 - std::log(4.5) - min_offset);
+
+    BuildTables(medium);
+}
+
+double MoliereInterpol::CalculateB(double B_ref, double offset) const
+{
+    return SolveB(B_ref - std::log(B_ref) + offset);
+}
+
+double MoliereInterpol::CalculateReducedAngle(double B_ref, double s) const
+{
+    if (s <= 0.)
+        return 0.;
+
+    // chi_c^2 is set to one, the angle is then given in units of
+    // sqrt(B_ref)
+    StepParameters params;
+    params.chiCSq = 1.;
+    params.B.resize(numComp_);
+    for (int i = 0; i < numComp_; i++)
+        params.B[i] = CalculateB(B_ref, offsets_[i]);
+    params.B[max_weight_index_] = B_ref;
+
+    auto pre_factor = std::sqrt(B_ref);
+    auto rnd = 0.5 + 0.5 * (-std::expm1(-s));
+    auto theta = Moliere::GetRandom(params, pre_factor, rnd);
+
+    return std::log1p(std::max(theta / pre_factor, 0.));
+}
+
+void MoliereInterpol::BuildTables(Medium const& medium)
+{
+    // The first axis is B of the reference component, the second one
+    // s = -ln(1 - 2|rnd - 0.5|), which resolves the single scattering tail.
+    // The tabulated value ln(1 + theta / sqrt(chi_c^2 B)) is nearly linear
+    // in s for large angles.
+    auto def = cubic_splines::BicubicSplines<double>::Definition();
+    def.axis[0] = std::make_unique<cubic_splines::LinAxis<double>>(
+        B_min_, B_MAX, NODES_B);
+    def.axis[1]
+        = std::make_unique<cubic_splines::LinAxis<double>>(0., S_MAX, NODES_RND);
+    def.f = [this](double B_ref, double s) {
+        return CalculateReducedAngle(B_ref, s);
+    };
+    def.approx_derivates = true;
+
+    auto hash = size_t(0);
+    hash_combine(hash, medium.GetHash(), NODES_B, NODES_RND, B_MAX, S_MAX);
+    auto path = std::string(InterpolationSettings::TABLES_PATH);
+    auto name = std::string("moliere_") + std::to_string(hash)
+        + std::string(".dat");
+
+    LogTableCreation(path, name);
+    inverse_cdf_ = std::make_shared<interpolant_t>(std::move(def), path, name);
+}
+
+double MoliereInterpol::GetRandom(
+    const StepParameters& params, double pre_factor, double rnd) const
+{
+    auto q = rnd - 0.5;
+    auto s = -std::log1p(-2. * std::abs(q));
+    const auto& B = params.B;
+    auto B_ref = B[max_weight_index_];
+
+    if (B_ref < B_min_ || B_ref > B_MAX || !(s <= S_MAX))
+        return Moliere::GetRandom(params, pre_factor, rnd);
+
+    // the relative B of the components have to match the tabulated ones,
+    // which is the case for relativistic particles
+    auto c_ref = B_ref - std::log(B_ref);
+    for (int i = 0; i < numComp_; i++) {
+        if (std::abs(B[i] - std::log(B[i]) - c_ref - offsets_[i]) > 1e-3)
+            return Moliere::GetRandom(params, pre_factor, rnd);
+    }
+
+    auto u = std::expm1(inverse_cdf_->evaluate(std::array<double, 2> { B_ref, s }));
+    auto theta = pre_factor * std::max(u, 0.);
+
+    return (q < 0.) ? -theta : theta;
+}
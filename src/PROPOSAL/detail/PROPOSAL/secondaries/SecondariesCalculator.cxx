@@ -1,14 +1,36 @@
 #include "PROPOSAL/secondaries/SecondariesCalculator.h"
+#include "PROPOSAL/math/RandomGenerator.h"
 
 using namespace PROPOSAL;
 
 std::vector<ParticleState> SecondariesCalculator::CalculateSecondaries(
         StochasticLoss loss, const Component& comp, std::vector<double> &rnd)
+{
+    return CalculateSecondaries(loss, comp, rnd,
+        std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get()));
+}
+
+std::vector<ParticleState> SecondariesCalculator::CalculateSecondaries(
+        StochasticLoss loss, const Component& comp, std::vector<double> &rnd,
+        std::function<double()> rnd_thinning)
 {
     auto type = static_cast<InteractionType>(loss.type);
     auto it = secondary_generator.find(type);
-    if (it != secondary_generator.end())
-        return it->second->CalculateSecondaries(loss, comp, rnd);
+    if (it != secondary_generator.end()) {
+        auto secondaries = it->second->CalculateSecondaries(loss, comp, rnd);
+        for (auto& p : secondaries)
+            p.weight = loss.weight;
+        if (!thinning || secondaries.size() < 2)
+            return secondaries;
+
+        // the first particle is the outgoing primary, it is never thinned
+        auto thinned = thinning->Apply(
+            std::vector<ParticleState>(secondaries.begin() + 1, secondaries.end()),
+            rnd_thinning, loss.parent_particle_energy);
+        secondaries.resize(1);
+        secondaries.insert(secondaries.end(), thinned.begin(), thinned.end());
+        return secondaries;
+    }
     std::ostringstream s;
     s << "No secondary calculator for interaction type ("
         << Type_Interaction_Name_Map.find(type)->second << ") available.";
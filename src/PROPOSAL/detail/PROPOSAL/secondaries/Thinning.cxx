@@ -0,0 +1,143 @@
+#include "PROPOSAL/secondaries/Thinning.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace PROPOSAL;
+
+Thinning::Thinning(std::vector<ParticleType> thinned_types)
+    : thinned_types(std::move(thinned_types))
+{
+}
+
+void Thinning::SetRoulette(
+    ParticleType type, double threshold, double survival_probability)
+{
+    if (survival_probability <= 0. || survival_probability > 1.)
+        throw std::invalid_argument(
+            "The survival probability must be in (0, 1].");
+    roulette[type] = Roulette { threshold, survival_probability };
+}
+
+void Thinning::SetHillasThinning(double energy)
+{
+    if (energy < 0.)
+        throw std::invalid_argument("The thinning energy must not be negative.");
+    thinning_energy = energy;
+}
+
+void Thinning::SetWeightWindow(double lower, double upper, double survival)
+{
+    if (lower <= 0. || survival < lower || upper < survival)
+        throw std::invalid_argument("The weight window requires "
+                                    "0 < lower <= survival <= upper.");
+    window_lower = lower;
+    window_upper = upper;
+    window_survival = survival;
+}
+
+bool Thinning::IsThinned(const ParticleState& particle) const
+{
+    return std::find(thinned_types.begin(), thinned_types.end(),
+               static_cast<ParticleType>(particle.type))
+        != thinned_types.end();
+}
+
+std::vector<ParticleState> Thinning::Apply(std::vector<ParticleState> particles,
+    std::function<double()> rnd, double parent_energy) const
+{
+    std::vector<ParticleState> survivors;
+    survivors.reserve(particles.size());
+    for (auto& particle : particles) {
+        auto it = roulette.find(static_cast<ParticleType>(particle.type));
+        if (it != roulette.end() && particle.energy < it->second.threshold) {
+            if (rnd() >= it->second.survival_probability)
+                continue;
+            particle.weight /= it->second.survival_probability;
+        }
+        survivors.push_back(particle);
+    }
+
+    if (thinning_energy > 0.)
+        HillasThinning(survivors, rnd, parent_energy);
+    if (window_lower > 0.)
+        WeightWindow(survivors, rnd);
+    return survivors;
+}
+
+void Thinning::HillasThinning(std::vector<ParticleState>& particles,
+    std::function<double()>& rnd, double parent_energy) const
+{
+    std::vector<ParticleState> survivors;
+    survivors.reserve(particles.size());
+    if (parent_energy >= thinning_energy) {
+        for (auto& particle : particles) {
+            if (IsThinned(particle) && particle.energy < thinning_energy) {
+                auto probability = particle.energy / thinning_energy;
+                if (rnd() >= probability)
+                    continue;
+                particle.weight /= probability;
+            }
+            survivors.push_back(particle);
+        }
+        particles = std::move(survivors);
+        return;
+    }
+
+    // the parent has been below the thinning energy, keep only one of the
+    // thinned particles
+    auto energy_sum = 0.;
+    auto last = particles.size();
+    for (size_t i = 0; i < particles.size(); ++i) {
+        if (IsThinned(particles[i]) && particles[i].energy > 0.) {
+            energy_sum += particles[i].energy;
+            last = i;
+        }
+    }
+    if (last == particles.size())
+        return;
+
+    auto rndi = rnd() * energy_sum;
+    auto selected = last;
+    for (size_t i = 0; i < last; ++i) {
+        if (IsThinned(particles[i]) && particles[i].energy > 0.) {
+            rndi -= particles[i].energy;
+            if (rndi < 0.) {
+                selected = i;
+                break;
+            }
+        }
+    }
+    particles[selected].weight *= energy_sum / particles[selected].energy;
+    for (size_t i = 0; i < particles.size(); ++i) {
+        if (i == selected || !IsThinned(particles[i]))
+            survivors.push_back(particles[i]);
+    }
+    particles = std::move(survivors);
+}
+
+void Thinning::WeightWindow(
+    std::vector<ParticleState>& particles, std::function<double()>& rnd) const
+{
+    std::vector<ParticleState> survivors;
+    survivors.reserve(particles.size());
+    for (auto& particle : particles) {
+        if (!IsThinned(particle)) {
+            survivors.push_back(particle);
+        } else if (particle.weight < window_lower) {
+            if (rnd() * window_survival < particle.weight) {
+                particle.weight = window_survival;
+                survivors.push_back(particle);
+            }
+        } else if (particle.weight > window_upper) {
+            auto n_copies = std::ceil(particle.weight / window_upper);
+            particle.weight /= n_copies;
+            survivors.insert(survivors.end(), static_cast<size_t>(n_copies),
+                particle);
+        } else {
+            survivors.push_back(particle);
+        }
+    }
+    particles = std::move(survivors);
+}
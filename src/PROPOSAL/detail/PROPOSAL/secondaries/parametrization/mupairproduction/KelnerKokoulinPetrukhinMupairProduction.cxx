@@ -1,10 +1,14 @@
 
 #include "PROPOSAL/secondaries/parametrization/mupairproduction/KelnerKokoulinPetrukhinMupairProduction.h"
 #include "PROPOSAL/Constants.h"
+#include "PROPOSAL/crosssection/CrossSectionDNDX/CrossSectionDNDXInterpolant.h"
+#include "PROPOSAL/methods.h"
 #include "PROPOSAL/particle/Particle.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 
 using std::fmod;
@@ -17,18 +21,115 @@ using std::sqrt;
 using namespace PROPOSAL;
 
 
-double secondaries::KelnerKokoulinPetrukhinMupairProduction::CalculateRho(
-    double energy, double v, const Component& comp, double rnd1, double rnd2)
+double secondaries::KelnerKokoulinPetrukhinMupairProduction::GetRhoMax(
+    double energy, double v) const
+{
+    return 1 - 2 * MMU / (v * energy);
+}
+
+double secondaries::KelnerKokoulinPetrukhinMupairProduction::IntegrateRho(
+    double energy, double v, const Component& comp, double rnd)
 {
-    auto rho_max = 1 - 2 * MMU / (v * energy);
+    auto rho_max = GetRhoMax(energy, v);
     if (rho_max < 0)
         return 0;
     integral.IntegrateWithRandomRatio(0, rho_max,
         [&](double rho) {
             return param.FunctionToIntegral(p_def, comp, energy, v, rho);
         },
-        3, rnd1);
-    auto rho_tmp = integral.GetUpperLimit();
+        3, rnd);
+    return integral.GetUpperLimit();
+}
+
+void secondaries::KelnerKokoulinPetrukhinMupairProduction::BuildRhoTables(
+    const Medium& medium)
+{
+    energy_axis = std::make_unique<cubic_splines::ExpAxis<double>>(
+        param.GetLowerEnergyLim(p_def), InterpolationSettings::UPPER_ENERGY_LIM,
+        NODES_RHO_E);
+
+    for (auto& comp : medium.GetComponents()) {
+        auto slices = rho_slices_t();
+        for (size_t i = 0; i < NODES_RHO_E; ++i) {
+            auto energy = energy_axis->back_transform(i);
+
+            // rho is tabulated relative to rho_max, vbar is the relative loss
+            // in the same transformed space used for the dNdx tables.
+            auto def = cubic_splines::BicubicSplines<double>::Definition();
+            def.axis[0] = std::make_unique<cubic_splines::LinAxis<double>>(
+                0., 1., NODES_RHO_V);
+            def.axis[1] = std::make_unique<cubic_splines::LinAxis<double>>(
+                0., 1., NODES_RHO_RND);
+            def.f = [this, comp, energy](double vbar, double rnd) {
+                auto lim = param.GetKinematicLimits(p_def, comp, energy);
+                auto v = transform_relative_loss(lim.v_min, lim.v_max, vbar);
+                auto rho_max = GetRhoMax(energy, v);
+                if (!(rho_max > 0) || rnd <= 0)
+                    return 0.;
+                if (rnd >= 1)
+                    return 1.;
+                auto rho = IntegrateRho(energy, v, comp, rnd) / rho_max;
+                return std::min(std::max(rho, 0.), 1.);
+            };
+            def.approx_derivates = true;
+
+            auto hash = size_t(0);
+            hash_combine(hash, p_def.GetHash(), comp.GetHash(),
+                param.GetHash(), i, NODES_RHO_E, NODES_RHO_V, NODES_RHO_RND,
+                InterpolationSettings::UPPER_ENERGY_LIM);
+            auto path = std::string(InterpolationSettings::TABLES_PATH);
+            auto name = std::string("mupair_rho_") + std::to_string(hash)
+                + std::string(".dat");
+
+            LogTableCreation(path, name);
+            slices.emplace_back(
+                std::make_unique<interpolant_t>(std::move(def), path, name));
+        }
+        rho_tables[comp.GetHash()] = std::move(slices);
+    }
+}
+
+double secondaries::KelnerKokoulinPetrukhinMupairProduction::InterpolateRho(
+    double energy, double v, const Component& comp, double rnd)
+{
+    auto it = rho_tables.find(comp.GetHash());
+    if (it == rho_tables.end()) {
+        std::ostringstream s;
+        s << "Component (" << comp.GetName()
+          << ") can not be found in the precalculated mupairproduction rho "
+             "tables.";
+        throw std::out_of_range(s.str());
+    }
+
+    auto rho_max = GetRhoMax(energy, v);
+    if (rho_max < 0)
+        return 0;
+
+    auto lim = param.GetKinematicLimits(p_def, comp, energy);
+    auto vbar = retransform_relative_loss(lim.v_min, lim.v_max, v);
+
+    // linear interpolation in log(E) between the neighbouring energy slices
+    auto x = energy_axis->transform(energy);
+    x = std::min(std::max(x, 0.), static_cast<double>(NODES_RHO_E - 1));
+    auto i = std::min(static_cast<size_t>(x), NODES_RHO_E - 2);
+    auto w = x - i;
+
+    auto& slices = it->second;
+    auto rho_low = slices[i]->evaluate(std::array<double, 2> { vbar, rnd });
+    auto rho_up = slices[i + 1]->evaluate(std::array<double, 2> { vbar, rnd });
+    auto rho = (1 - w) * rho_low + w * rho_up;
+
+    return std::min(std::max(rho, 0.), 1.) * rho_max;
+}
+
+double secondaries::KelnerKokoulinPetrukhinMupairProduction::CalculateRho(
+    double energy, double v, const Component& comp, double rnd1, double rnd2)
+{
+    auto rho_tmp = 0.;
+    if (rho_tables.empty())
+        rho_tmp = IntegrateRho(energy, v, comp, rnd1);
+    else
+        rho_tmp = InterpolateRho(energy, v, comp, rnd1);
     if (rnd2 < 0.5) {
         return -rho_tmp;
     } else {
@@ -0,0 +1,231 @@
+/**
+ * proposal-bench: timings of the geometry and density dispatch in the
+ * propagation loop.
+ *
+ * The built-in geometries and density distributions are called through the
+ * virtual interface and through GeometryVariant / DensityVariant, the time
+ * per call is printed for both. Afterwards electrons are propagated with a
+ * json config and the time per propagation step is printed. Without a
+ * config, low-energy electrons are propagated in a homogeneous ice sphere.
+ */
+
+#include "PROPOSAL/Propagator.h"
+#include "PROPOSAL/density_distr/density_variant.h"
+#include "PROPOSAL/geometry/GeometryVariant.h"
+#include "PROPOSAL/particle/Particle.h"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace PROPOSAL;
+
+namespace {
+
+constexpr const char* usage = R"(usage: proposal-bench [options]
+
+  --config FILE            json config of the electron propagator
+  --energy X               energy of the electrons in MeV (default 1e3)
+  --events N               number of propagated electrons (default 1000)
+  --calls N                calls per dispatch benchmark (default 1000000)
+)";
+
+constexpr const char* default_config = R"({
+    "global": { "cuts": { "e_cut": 1, "v_cut": 1, "cont_rand": false } },
+    "sectors": [ { "medium": "ice", "geometries": [ { "hierarchy": 0,
+        "shape": "sphere", "origin": [0, 0, 0], "outer_radius": 1e20 }
+    ] } ] })";
+
+struct Options {
+    std::string config;
+    double energy = 1e3;
+    size_t events = 1000;
+    size_t calls = 1000000;
+};
+
+Options ParseArguments(int argc, char** argv)
+{
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            std::cout << usage;
+            std::exit(0);
+        }
+        if (i + 1 == argc)
+            throw std::invalid_argument("Missing value for " + arg);
+        std::string value = argv[++i];
+        if (arg == "--config")
+            opt.config = value;
+        else if (arg == "--energy")
+            opt.energy = std::stod(value);
+        else if (arg == "--events")
+            opt.events = std::stoul(value);
+        else if (arg == "--calls")
+            opt.calls = std::stoul(value);
+        else
+            throw std::invalid_argument("Unknown option " + arg);
+    }
+    return opt;
+}
+
+//! Positions and directions of the dispatch benchmarks, inside a sphere of
+//! radius 100 around the origin.
+struct Rays {
+    std::vector<Cartesian3D> positions;
+    std::vector<Cartesian3D> directions;
+
+    explicit Rays(size_t n)
+    {
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<double> uniform(-1., 1.);
+        for (size_t i = 0; i < n; ++i) {
+            positions.emplace_back(
+                50. * uniform(rng), 50. * uniform(rng), 50. * uniform(rng));
+            Cartesian3D direction(uniform(rng), uniform(rng), uniform(rng));
+            direction.normalize();
+            directions.push_back(direction);
+        }
+    }
+};
+
+template <typename F> double NanosecondsPerCall(size_t calls, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < calls; ++i)
+        f(i);
+    std::chrono::duration<double, std::nano> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / calls;
+}
+
+void Print(const std::string& name, double t_virtual, double t_variant)
+{
+    std::cout.width(28);
+    std::cout << std::left << name << t_virtual << " ns  " << t_variant
+              << " ns  (x" << t_virtual / t_variant << ")\n";
+}
+
+// the checksum keeps the compiler from dropping the calls
+double checksum = 0.;
+
+void BenchmarkGeometries(const Rays& rays, size_t calls)
+{
+    std::vector<std::pair<std::string, std::shared_ptr<const Geometry>>>
+        geometries = {
+            { "Sphere", std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 80., 10.) },
+            { "Box", std::make_shared<Box>(Cartesian3D(0, 0, 0), 120., 100., 80.) },
+            { "Cylinder",
+                std::make_shared<Cylinder>(Cartesian3D(0, 0, 0), 100., 80., 10.) },
+        };
+
+    auto n = rays.positions.size();
+    for (auto& geometry : geometries) {
+        auto& virtual_geometry = *geometry.second;
+        auto t_virtual = NanosecondsPerCall(calls, [&](size_t i) {
+            checksum += virtual_geometry
+                            .DistanceToBorder(rays.positions[i % n],
+                                rays.directions[i % n])
+                            .first;
+        });
+        GeometryVariant variant(virtual_geometry);
+        auto t_variant = NanosecondsPerCall(calls, [&](size_t i) {
+            checksum += variant
+                            .DistanceToBorder(rays.positions[i % n],
+                                rays.directions[i % n])
+                            .first;
+        });
+        Print(geometry.first + "::DistanceToBorder", t_virtual, t_variant);
+    }
+}
+
+void BenchmarkDensities(const Rays& rays, size_t calls)
+{
+    CartesianAxis axis(Cartesian3D(0, 0, 1), Cartesian3D(0, 0, 0));
+    auto grid = std::make_shared<VoxelGrid>();
+    grid->n = { 10, 10, 10 };
+    grid->origin = Cartesian3D(-50, -50, -50);
+    grid->spacing = { 10., 10., 10. };
+    for (size_t i = 0; i < grid->size(); ++i)
+        grid->values.push_back(0.9 + 0.0002 * i);
+    grid->media.resize(grid->size(), 0);
+
+    std::vector<std::pair<std::string, std::shared_ptr<const Density_distr>>>
+        densities = {
+            { "Homogeneous", std::make_shared<Density_homogeneous>(0.917) },
+            { "Exponential",
+                std::make_shared<Density_exponential>(axis, 100., 0., 0.917) },
+            { "Layered",
+                std::make_shared<Density_layered>(Cartesian3D(0, 0, 0),
+                    Density_layered::PREM(), Density_layered::EARTH_RADIUS) },
+            { "Voxel", std::make_shared<Density_voxel>(grid, 1.) },
+        };
+
+    auto n = rays.positions.size();
+    for (auto& density : densities) {
+        auto& virtual_density = *density.second;
+        auto t_virtual = NanosecondsPerCall(calls, [&](size_t i) {
+            auto& position = rays.positions[i % n];
+            auto& direction = rays.directions[i % n];
+            auto grammage = virtual_density.Calculate(position, direction, 10.);
+            checksum += virtual_density.Correct(position, direction, grammage, 100.);
+            checksum += virtual_density.Evaluate(position);
+        });
+        DensityVariant variant(virtual_density);
+        auto t_variant = NanosecondsPerCall(calls, [&](size_t i) {
+            auto& position = rays.positions[i % n];
+            auto& direction = rays.directions[i % n];
+            auto grammage = variant.Calculate(position, direction, 10.);
+            checksum += variant.Correct(position, direction, grammage, 100.);
+            checksum += variant.Evaluate(position);
+        });
+        Print(density.first + " Calc/Corr/Eval", t_virtual, t_variant);
+    }
+}
+
+void BenchmarkPropagation(const Options& opt)
+{
+    auto config = opt.config.empty() ? nlohmann::json::parse(default_config)
+                                     : Propagator::ParseConfig(opt.config);
+    Propagator propagator(EMinusDef(), config);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    std::function<double()> rnd = [&]() { return uniform(rng); };
+    ParticleState init(ParticleType::EMinus, Cartesian3D(0, 0, 0),
+        Cartesian3D(0, 0, 1), opt.energy, 0., 0.);
+
+    size_t steps = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < opt.events; ++i)
+        steps += propagator.Propagate(init, rnd).GetTrackLength();
+    std::chrono::duration<double, std::nano> elapsed
+        = std::chrono::steady_clock::now() - start;
+    std::cout << "propagation of " << opt.events << " electrons with "
+              << opt.energy << " MeV: " << steps << " steps, "
+              << elapsed.count() / steps << " ns per step\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    try {
+        auto opt = ParseArguments(argc, argv);
+        Rays rays(1024);
+        std::cout << "dispatch                    virtual   variant\n";
+        BenchmarkGeometries(rays, opt.calls);
+        BenchmarkDensities(rays, opt.calls);
+        BenchmarkPropagation(opt);
+        std::cout << "checksum " << checksum << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "proposal-bench: " << e.what() << "\n" << usage;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,510 @@
+/**
+ * proposal-run: propagate a set of primaries with a json config and write
+ * the results to an event file (see PROPOSAL/output/EventFile.h).
+ *
+ * The primaries are read from a text file with one primary per line
+ * (energy in MeV, position in cm, direction) or generated from a json
+ * spectrum description. Every primary has a global event id. The random
+ * numbers of an event only depend on the seed and its id, so splitting a
+ * run into shards or resuming it from a checkpoint gives the same events as
+ * a single run.
+ */
+
+#include "PROPOSAL/Constants.h"
+#include "PROPOSAL/Propagator.h"
+#include "PROPOSAL/output/EventFile.h"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+using namespace PROPOSAL;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* usage = R"(usage: proposal-run --config FILE --output FILE
+                    (--primaries FILE | --generator FILE) [options]
+
+  --config FILE            json config of the propagator
+  --output FILE            event file to write
+  --primaries FILE         text file, one primary per line:
+                           energy x y z dx dy dz
+  --generator FILE         json generator spec, see below
+  --particle PDG           particle type (default 13, or from the generator)
+  --events N               number of primaries to generate
+  --seed N                 seed of the propagation (default 0)
+  --shard I/N              propagate only shard I of N shards (default 0/1)
+  --threads N              number of threads, 0 uses all cores (default 0)
+  --chunk-size N           events per output chunk (default 1000)
+  --checkpoint FILE        checkpoint file, an existing one is resumed
+  --checkpoint-every N     events between two checkpoints (default 100000)
+  --tracks                 store the full tracks
+  --max-distance X         maximal propagation distance in cm
+  --min-energy X           propagate until this energy in MeV
+
+generator spec:
+  {
+    "particle": 13,
+    "n_events": 1000000,
+    "seed": 1,
+    "spectrum": { "type": "powerlaw", "index": 2.7,
+                  "e_min": 1e3, "e_max": 1e9 },     // energies in MeV
+    "zenith": [0, 90],                              // in degree
+    "azimuth": [0, 360],                            // in degree
+    "position": [0, 0, 0],                          // in cm
+    "distance": 0                                   // in cm
+  }
+  Spectrum types are "powerlaw" (index, e_min, e_max) and "mono" (energy).
+  The directions are uniform in cos(zenith) and azimuth. Every primary
+  starts at position - distance * direction.
+)";
+
+struct Options {
+    std::string config;
+    std::string output;
+    std::string primaries;
+    std::string generator;
+    std::string checkpoint;
+    int particle = 13;
+    bool particle_set = false;
+    uint64_t n_events = 0;
+    unsigned int seed = 0;
+    uint64_t shard = 0;
+    uint64_t n_shards = 1;
+    unsigned int n_threads = 0;
+    size_t chunk_size = 1000;
+    uint64_t checkpoint_every = 100000;
+    bool tracks = false;
+    double max_distance = 1e20;
+    double min_energy = 0.;
+};
+
+Options ParseArguments(int argc, char** argv)
+{
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            std::cout << usage;
+            std::exit(0);
+        }
+        if (arg == "--tracks") {
+            opt.tracks = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            throw std::invalid_argument("Missing value of argument " + arg);
+        std::string value = argv[++i];
+        if (arg == "--config")
+            opt.config = value;
+        else if (arg == "--output")
+            opt.output = value;
+        else if (arg == "--primaries")
+            opt.primaries = value;
+        else if (arg == "--generator")
+            opt.generator = value;
+        else if (arg == "--checkpoint")
+            opt.checkpoint = value;
+        else if (arg == "--particle") {
+            opt.particle = std::stoi(value);
+            opt.particle_set = true;
+        } else if (arg == "--events")
+            opt.n_events = std::stoull(value);
+        else if (arg == "--seed")
+            opt.seed = std::stoul(value);
+        else if (arg == "--shard") {
+            auto sep = value.find('/');
+            if (sep == std::string::npos)
+                throw std::invalid_argument("Expected --shard I/N.");
+            opt.shard = std::stoull(value.substr(0, sep));
+            opt.n_shards = std::stoull(value.substr(sep + 1));
+        } else if (arg == "--threads")
+            opt.n_threads = std::stoul(value);
+        else if (arg == "--chunk-size")
+            opt.chunk_size = std::stoull(value);
+        else if (arg == "--checkpoint-every")
+            opt.checkpoint_every = std::stoull(value);
+        else if (arg == "--max-distance")
+            opt.max_distance = std::stod(value);
+        else if (arg == "--min-energy")
+            opt.min_energy = std::stod(value);
+        else
+            throw std::invalid_argument("Unknown argument " + arg);
+    }
+
+    if (opt.config.empty() || opt.output.empty())
+        throw std::invalid_argument("--config and --output are required.");
+    if (opt.primaries.empty() == opt.generator.empty())
+        throw std::invalid_argument(
+            "Either --primaries or --generator is required.");
+    if (opt.n_shards == 0 || opt.shard >= opt.n_shards)
+        throw std::invalid_argument("Shard index must be smaller than the "
+                                    "number of shards.");
+    if (opt.checkpoint_every == 0)
+        throw std::invalid_argument("--checkpoint-every must be positive.");
+    return opt;
+}
+
+// 64 bit FNV-1a, stable across platforms and runs
+uint64_t Hash(const std::string& s)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (auto c : s) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string ReadFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.good())
+        throw std::invalid_argument("Could not open " + path);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/**
+ * Source of the primaries. Primary i must not depend on the primaries
+ * before, so every shard can create its primaries on its own.
+ */
+class PrimarySource {
+public:
+    virtual ~PrimarySource() = default;
+    virtual uint64_t size() const = 0;
+    virtual ParticleState Get(uint64_t event) const = 0;
+};
+
+class PrimaryFile : public PrimarySource {
+    std::vector<ParticleState> primaries;
+
+public:
+    PrimaryFile(const std::string& path, ParticleType type)
+    {
+        std::ifstream file(path);
+        if (!file.good())
+            throw std::invalid_argument("Could not open primaries " + path);
+
+        std::string line;
+        size_t line_number = 0;
+        while (std::getline(file, line)) {
+            ++line_number;
+            auto first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#')
+                continue;
+            std::istringstream ss(line);
+            double e, x, y, z, dx, dy, dz;
+            if (!(ss >> e >> x >> y >> z >> dx >> dy >> dz))
+                throw std::invalid_argument("Invalid primary in line "
+                    + std::to_string(line_number) + " of " + path);
+            Cartesian3D direction(dx, dy, dz);
+            direction.normalize();
+            primaries.emplace_back(type, Cartesian3D(x, y, z), direction, e,
+                0., 0.);
+        }
+    }
+
+    uint64_t size() const override { return primaries.size(); }
+    ParticleState Get(uint64_t event) const override
+    {
+        return primaries[event];
+    }
+};
+
+class PrimaryGenerator : public PrimarySource {
+    // appended to the seed sequence, so the primaries are drawn from a
+    // different stream than the propagation of the same event
+    static constexpr unsigned int SALT = 0x7072696d; // "prim"
+
+    ParticleType type;
+    uint64_t n_events;
+    unsigned int seed;
+    bool mono;
+    double energy, index, e_min, e_max;
+    double cos_min, cos_max, phi_min, phi_max;
+    Cartesian3D position;
+    double distance;
+
+public:
+    PrimaryGenerator(const nlohmann::json& spec, ParticleType type,
+        uint64_t n_events)
+        : type(type)
+        , n_events(n_events)
+        , seed(spec.value("seed", 0u))
+        , position(0, 0, 0)
+        , distance(spec.value("distance", 0.))
+    {
+        if (n_events == 0)
+            this->n_events = spec.at("n_events").get<uint64_t>();
+
+        const auto& spectrum = spec.at("spectrum");
+        auto spectrum_type = spectrum.at("type").get<std::string>();
+        mono = spectrum_type == "mono";
+        if (mono) {
+            energy = spectrum.at("energy").get<double>();
+        } else if (spectrum_type == "powerlaw") {
+            index = spectrum.at("index").get<double>();
+            e_min = spectrum.at("e_min").get<double>();
+            e_max = spectrum.at("e_max").get<double>();
+            if (e_min <= 0 || e_max < e_min)
+                throw std::invalid_argument("Invalid energy range of the "
+                                            "powerlaw spectrum.");
+        } else {
+            throw std::invalid_argument(
+                "Unknown spectrum type " + spectrum_type);
+        }
+
+        auto zenith = spec.value("zenith", std::array<double, 2> { 0., 180. });
+        auto azimuth
+            = spec.value("azimuth", std::array<double, 2> { 0., 360. });
+        cos_min = std::cos(zenith[1] * PI / 180.);
+        cos_max = std::cos(zenith[0] * PI / 180.);
+        phi_min = azimuth[0] * PI / 180.;
+        phi_max = azimuth[1] * PI / 180.;
+
+        if (spec.contains("position")) {
+            auto pos = spec["position"].get<std::array<double, 3>>();
+            position = Cartesian3D(pos[0], pos[1], pos[2]);
+        }
+    }
+
+    uint64_t size() const override { return n_events; }
+
+    ParticleState Get(uint64_t event) const override
+    {
+        std::seed_seq seq { seed, static_cast<unsigned int>(event),
+            static_cast<unsigned int>(event >> 32), SALT };
+        std::mt19937 rng(seq);
+        std::uniform_real_distribution<double> uniform(0., 1.);
+
+        double e = energy;
+        if (!mono) {
+            auto rnd = uniform(rng);
+            if (std::abs(index - 1.) < 1e-9) {
+                e = e_min * std::pow(e_max / e_min, rnd);
+            } else {
+                auto g = 1. - index;
+                auto a = std::pow(e_min, g);
+                auto b = std::pow(e_max, g);
+                e = std::pow(a + rnd * (b - a), 1. / g);
+            }
+        }
+
+        auto cos_theta = cos_min + uniform(rng) * (cos_max - cos_min);
+        auto sin_theta = std::sqrt(std::max(0., 1. - cos_theta * cos_theta));
+        auto phi = phi_min + uniform(rng) * (phi_max - phi_min);
+
+        // the primary comes from the direction (theta, phi) and moves
+        // towards position
+        Cartesian3D direction(-sin_theta * std::cos(phi),
+            -sin_theta * std::sin(phi), -cos_theta);
+        Cartesian3D start = position - distance * direction;
+        return ParticleState(type, start, direction, e, 0., 0.);
+    }
+};
+
+/**
+ * State of a run which is written after every block of events. The random
+ * number generator of an event is seeded with (seed, event id), so the
+ * next event id is the complete state of the random numbers.
+ */
+struct Checkpoint {
+    uint64_t config_hash = 0;
+    unsigned int seed = 0;
+    uint64_t shard = 0;
+    uint64_t n_shards = 1;
+    uint64_t first_event = 0;
+    uint64_t last_event = 0;
+    uint64_t next_event = 0;
+    uint64_t file_size = 0;
+    double elapsed = 0.;
+
+    nlohmann::json ToJson() const
+    {
+        return { { "config_hash", config_hash }, { "seed", seed },
+            { "shard", shard }, { "n_shards", n_shards },
+            { "first_event", first_event }, { "last_event", last_event },
+            { "next_event", next_event }, { "file_size", file_size },
+            { "events_done", next_event - first_event },
+            { "elapsed", elapsed } };
+    }
+
+    static Checkpoint FromJson(const nlohmann::json& j)
+    {
+        Checkpoint c;
+        c.config_hash = j.at("config_hash");
+        c.seed = j.at("seed");
+        c.shard = j.at("shard");
+        c.n_shards = j.at("n_shards");
+        c.first_event = j.at("first_event");
+        c.last_event = j.at("last_event");
+        c.next_event = j.at("next_event");
+        c.file_size = j.at("file_size");
+        c.elapsed = j.value("elapsed", 0.);
+        return c;
+    }
+
+    bool SameRun(const Checkpoint& other) const
+    {
+        return config_hash == other.config_hash && seed == other.seed
+            && shard == other.shard && n_shards == other.n_shards
+            && first_event == other.first_event
+            && last_event == other.last_event;
+    }
+
+    // write to a temporary file first, so a preempted job never leaves a
+    // broken checkpoint behind
+    void Write(const std::string& path) const
+    {
+        auto tmp = path + ".tmp";
+        {
+            std::ofstream file(tmp, std::ios::trunc);
+            file << ToJson().dump(4) << std::endl;
+            if (!file.good())
+                throw std::runtime_error("Could not write checkpoint " + tmp);
+        }
+        fs::rename(tmp, path);
+    }
+};
+
+int Run(const Options& opt)
+{
+    auto config = Propagator::ParseConfig(opt.config);
+
+    nlohmann::json generator_spec;
+    if (!opt.generator.empty())
+        generator_spec = nlohmann::json::parse(ReadFile(opt.generator));
+
+    // the primaries are part of the run, a checkpoint must not be resumed
+    // with a modified primaries file
+    std::string primaries_content;
+    if (!opt.primaries.empty())
+        primaries_content = ReadFile(opt.primaries);
+
+    auto particle = opt.particle;
+    if (!opt.particle_set && generator_spec.contains("particle"))
+        particle = generator_spec["particle"].get<int>();
+    auto p_def = ParticleDef::GetParticleDefForType(particle);
+    auto type = static_cast<ParticleType>(particle);
+
+    std::unique_ptr<PrimarySource> primaries;
+    if (!opt.primaries.empty())
+        primaries = std::make_unique<PrimaryFile>(opt.primaries, type);
+    else
+        primaries = std::make_unique<PrimaryGenerator>(
+            generator_spec, type, opt.n_events);
+
+    Checkpoint state;
+    state.config_hash = Hash(config.dump() + generator_spec.dump()
+        + primaries_content + std::to_string(particle) + std::to_string(opt.max_distance)
+        + std::to_string(opt.min_energy) + std::to_string(opt.tracks));
+    state.seed = opt.seed;
+    state.shard = opt.shard;
+    state.n_shards = opt.n_shards;
+    state.first_event = primaries->size() * opt.shard / opt.n_shards;
+    state.last_event = primaries->size() * (opt.shard + 1) / opt.n_shards;
+    state.next_event = state.first_event;
+
+    std::unique_ptr<EventWriter> writer;
+    if (!opt.checkpoint.empty() && fs::exists(opt.checkpoint)) {
+        nlohmann::json j;
+        std::ifstream(opt.checkpoint) >> j;
+        auto saved = Checkpoint::FromJson(j);
+        if (!saved.SameRun(state))
+            throw std::invalid_argument("Checkpoint " + opt.checkpoint
+                + " belongs to a different run.");
+        state = saved;
+        if (state.next_event == state.last_event) {
+            std::cout << "Run has already been finished." << std::endl;
+            return 0;
+        }
+        // drop the events written after the checkpoint
+        fs::resize_file(opt.output, state.file_size);
+        writer = EventWriter::Append(opt.output, state.next_event);
+        std::cout << "Resuming at event " << state.next_event << std::endl;
+    } else {
+        writer = std::make_unique<EventWriter>(opt.output, state.config_hash,
+            particle, opt.tracks, true, state.first_event);
+        state.file_size = writer->Flush();
+    }
+
+    Propagator prop(p_def, config);
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed_before = state.elapsed;
+    auto events_before = state.next_event;
+    double primary_energy = 0.;
+
+    std::vector<ParticleState> block;
+    while (state.next_event < state.last_event) {
+        auto end
+            = std::min(state.next_event + opt.checkpoint_every, state.last_event);
+        block.clear();
+        for (auto i = state.next_event; i < end; ++i) {
+            block.push_back(primaries->Get(i));
+            primary_energy += block.back().energy;
+        }
+
+        prop.PropagateToFile(block, *writer, opt.n_threads, opt.seed,
+            opt.chunk_size, state.next_event, opt.max_distance,
+            opt.min_energy);
+
+        state.next_event = end;
+        state.file_size = writer->Flush();
+        std::chrono::duration<double> dt
+            = std::chrono::steady_clock::now() - start;
+        state.elapsed = elapsed_before + dt.count();
+        if (!opt.checkpoint.empty())
+            state.Write(opt.checkpoint);
+
+        std::cout << "[" << state.next_event - state.first_event << "/"
+                  << state.last_event - state.first_event << "] events done"
+                  << std::endl;
+    }
+    writer->Close();
+
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+    auto n = state.next_event - events_before;
+    auto n_threads = opt.n_threads ? opt.n_threads
+                                   : std::max(std::thread::hardware_concurrency(), 1u);
+    std::cout << "\nshard " << opt.shard << "/" << opt.n_shards << ": events "
+              << state.first_event << " to " << state.last_event << "\n"
+              << "propagated events: " << n << " in " << dt.count() << " s\n"
+              << "throughput: " << n / dt.count() << " events/s, "
+              << n / dt.count() / n_threads << " events/s per thread ("
+              << n_threads << " threads)\n"
+              << "primary energy: " << primary_energy / dt.count()
+              << " MeV/s\n"
+              << "output: " << opt.output << " (" << state.file_size
+              << " bytes)" << std::endl;
+    return 0;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    try {
+        opt = ParseArguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "proposal-run: " << e.what() << "\n\n" << usage;
+        return 2;
+    }
+
+    try {
+        return Run(opt);
+    } catch (const std::exception& e) {
+        std::cerr << "proposal-run: " << e.what() << std::endl;
+        return 1;
+    }
+}
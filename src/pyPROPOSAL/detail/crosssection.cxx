@@ -1,4 +1,5 @@
 #include "PROPOSAL/crosssection/CrossSection.h"
+#include "PROPOSAL/crosssection/CrossSectionBias.h"
 #include "PROPOSAL/crosssection/CrossSectionMultiplier.h"
 #include "PROPOSAL/math/InterpolantBuilder.h"
 #include "PROPOSAL/crosssection/ParticleDefaultCrossSectionList.h"
@@ -67,6 +68,18 @@ void init_crosssection(py::module& m)
               },
               py::arg("crosssection"), py::arg("multiplier"));
 
+    m_sub.def("make_crosssection_bias",
+              [](std::shared_ptr<CrossSectionBase> c, double b) {
+                  return std::shared_ptr<CrossSectionBase>(
+                          make_crosssection_bias(std::move(c), b));
+              },
+              py::arg("crosssection"), py::arg("bias"),
+              R"pbdoc(
+                Enhance the interaction rate of a crosssection by bias. The
+                particle weight is corrected if the crosssection is part of
+                an InteractionBias, see make_interaction_bias.
+            )pbdoc");
+
     py::class_<CrossSectionBase, std::shared_ptr<CrossSectionBase>>(
         m_sub, "CrossSection")
         .def_property_readonly(
@@ -19,7 +19,7 @@ void init_decay(py::module& m) {
         .def("__str__", &py_print<DecayChannel>)
         .def("__eq__", &DecayChannel::operator==)
         .def("__ne__", &DecayChannel::operator!=)
-        .def("decay", &DecayChannel::Decay, "Decay the given particle")
+        .def("decay", overload_cast_<const ParticleDef&, const ParticleState&>()(&DecayChannel::Decay), "Decay the given particle")
         .def_static("boost", overload_cast_<ParticleState&, const Vector3D&, double, double>()(&DecayChannel::Boost))
         .def_static("boost", overload_cast_<std::vector<ParticleState>&, const Vector3D&, double, double>()(&DecayChannel::Boost));
 
@@ -48,7 +48,20 @@ void init_decay(py::module& m) {
         .def("evaluate", &ManyBodyPhaseSpace::Evaluate,
              "Return the matrix element (default 1)")
         .def("set_uniform_sampling", &DecayChannel::SetUniformSampling,
-             "Decide to use uniform phase space sampling");
+             "Decide to use uniform phase space sampling")
+        .def("decay_batch",
+             [](ManyBodyPhaseSpace& self, const ParticleDef& p_def,
+                const std::vector<ParticleState>& p_conditions) {
+                 std::vector<ParticleState> products;
+                 self.Decay(p_def, p_conditions, products);
+                 return products;
+             },
+             py::arg("particle_def"), py::arg("particle_conditions"),
+             "Decay several parents of the same type. The products of parent "
+             "i are stored at [i * n, (i + 1) * n) with n = "
+             "number_of_daughters.")
+        .def_property_readonly("number_of_daughters",
+             &ManyBodyPhaseSpace::GetNumberOfDaughters);
 
     py::class_<StableChannel, std::shared_ptr<StableChannel>, DecayChannel>(
         m_sub, "StableChannel")
@@ -61,6 +74,19 @@ void init_decay(py::module& m) {
         .def("add_channel", &DecayTable::addChannel, "Add an decay channel")
         .def("select_channel", &DecayTable::SelectChannel, py::return_value_policy::reference_internal, py::arg("rnd"),
              "Select an decay channel according to given branching ratios")
+        .def("decay",
+             [](const DecayTable& self, const ParticleDef& p_def,
+                const std::vector<ParticleState>& p_conditions,
+                const std::vector<double>& rnd_channel) {
+                 std::vector<ParticleState> products;
+                 std::vector<size_t> offsets;
+                 self.Decay(p_def, p_conditions, rnd_channel, products, offsets);
+                 return std::make_pair(products, offsets);
+             },
+             py::arg("particle_def"), py::arg("particle_conditions"),
+             py::arg("rnd_channel"),
+             "Select the channels and decay several parents at once. Returns "
+             "the products and the offsets of the products of every parent.")
         .def("set_stable", &DecayTable::SetStable,
              "Define decay table for stable particles")
         .def("set_uniform_sampling", &DecayTable::SetUniformSampling,
@@ -1,7 +1,9 @@
 #include "PROPOSAL/density_distr/density_exponential.h"
 #include "PROPOSAL/density_distr/density_homogeneous.h"
+#include "PROPOSAL/density_distr/density_layered.h"
 #include "PROPOSAL/density_distr/density_polynomial.h"
 #include "PROPOSAL/density_distr/density_splines.h"
+#include "PROPOSAL/density_distr/density_voxel.h"
 #include "pyPROPOSAL/pyBindings.h"
 
 namespace py = pybind11;
@@ -114,6 +116,77 @@ void init_density_distribution(py::module& m) {
             .def(py::init<const Axis&, const Spline&, double>(), py::arg("density_axis"),
                  py::arg("splines"), py::arg("mass_density"));
 
+    py::class_<Density_layered, Density_distr,
+            std::shared_ptr<Density_layered>> layered(m_sub, "density_layered",
+                 R"pbdoc(
+            Spherically layered density, e.g. the PREM earth model. The
+            density of every layer is a polynomial in r / radius_scale. The
+            grammage along a straight line is calculated in closed form.
+            )pbdoc");
+
+    py::class_<Density_layered::Layer>(layered, "Layer")
+            .def(py::init([](double outer_radius, std::vector<double> coefficients) {
+                     return Density_layered::Layer{outer_radius, std::move(coefficients)};
+                 }),
+                 py::arg("outer_radius"), py::arg("coefficients"))
+            .def_readwrite("outer_radius", &Density_layered::Layer::outer_radius)
+            .def_readwrite("coefficients", &Density_layered::Layer::coefficients);
+
+    layered
+            .def(py::init<const Vector3D&, std::vector<Density_layered::Layer>,
+                          double, double>(),
+                 py::arg("center"), py::arg("layers"), py::arg("radius_scale") = 1.,
+                 py::arg("density_scale") = 1.)
+            .def_property_readonly("layers", &Density_layered::GetLayers)
+            .def_static("prem",
+                        [](const Vector3D& center, double density_scale) {
+                            return std::make_shared<Density_layered>(
+                                    center, Density_layered::PREM(),
+                                    Density_layered::EARTH_RADIUS, density_scale);
+                        },
+                        py::arg("center"), py::arg("density_scale") = 1.,
+                        R"pbdoc(
+                Preliminary reference earth model, centered at center.
+            )pbdoc");
+
+    py::class_<VoxelGrid, std::shared_ptr<VoxelGrid>>(m_sub, "VoxelGrid",
+                 R"pbdoc(
+            Regular voxel grid starting at origin. The values are the mass
+            density scale factors of the voxels, with the x index running
+            fastest. Optionally, every voxel carries a medium index.
+            )pbdoc")
+            .def(py::init([](std::array<size_t, 3> n, const Vector3D& origin,
+                             std::array<double, 3> spacing, std::vector<double> values,
+                             std::vector<int32_t> media) {
+                     return VoxelGrid{n, Cartesian3D(origin), spacing, std::move(values),
+                                      std::move(media)};
+                 }),
+                 py::arg("shape"), py::arg("origin"), py::arg("spacing"), py::arg("values"),
+                 py::arg("media") = std::vector<int32_t>())
+            .def_static("read", &VoxelGrid::Read, py::arg("path"))
+            .def("write", &VoxelGrid::Write, py::arg("path"))
+            .def_readonly("shape", &VoxelGrid::n)
+            .def_readonly("origin", &VoxelGrid::origin)
+            .def_readonly("spacing", &VoxelGrid::spacing)
+            .def_readonly("values", &VoxelGrid::values)
+            .def_readonly("media", &VoxelGrid::media);
+
+    py::class_<Density_voxel, Density_distr, std::shared_ptr<Density_voxel>>(
+            m_sub, "density_voxel",
+            R"pbdoc(
+            Density given by a voxel grid, the density of a voxel is
+            mass_density times its scale factor. Outside of the grid,
+            outside_scale is used.
+            )pbdoc")
+            .def(py::init([](const VoxelGrid& grid, double mass_density, double outside_scale) {
+                     return std::make_shared<Density_voxel>(
+                             std::make_shared<const VoxelGrid>(grid), mass_density, outside_scale);
+                 }),
+                 py::arg("grid"), py::arg("mass_density"), py::arg("outside_scale") = 1.)
+            .def(py::init<const std::string&, double, double>(), py::arg("path"),
+                 py::arg("mass_density"), py::arg("outside_scale") = 1.)
+            .def("medium_index", &Density_voxel::GetMediumIndex, py::arg("xi"));
+
     py::class_<Axis, std::shared_ptr<Axis>>(m_sub, "Density_axis")
             .def_property_readonly("reference_point", &Axis::GetFp0)
             .def("depth", &Axis::GetDepth, py::arg("position"),
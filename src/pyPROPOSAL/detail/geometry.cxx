@@ -1,6 +1,7 @@
 
 #include "PROPOSAL/geometry/Box.h"
 #include "PROPOSAL/geometry/Cylinder.h"
+#include "PROPOSAL/geometry/Mesh.h"
 #include "PROPOSAL/geometry/Sphere.h"
 #include "pyPROPOSAL/pyBindings.h"
 
@@ -24,7 +25,28 @@ void init_geometry(py::module& m) {
     py::enum_<Geometry_Type>(m_sub, "Shape")
         .value("Sphere", Geometry_Type::SPHERE)
         .value("Box", Geometry_Type::BOX)
-        .value("Cylinder", Geometry_Type::CYLINDER);
+        .value("Cylinder", Geometry_Type::CYLINDER)
+        .value("Mesh", Geometry_Type::MESH);
+
+    py::enum_<Geometry::ParticleLocation::Enum>(m_sub, "ParticleLocation")
+        .value("infront", Geometry::ParticleLocation::InfrontGeometry)
+        .value("inside", Geometry::ParticleLocation::InsideGeometry)
+        .value("behind", Geometry::ParticleLocation::BehindGeometry);
+
+    py::class_<Geometry::Intersection>(m_sub, "Intersection")
+        .def_readonly("location", &Geometry::Intersection::location)
+        .def_readonly("entry", &Geometry::Intersection::entry,
+            R"pbdoc(
+            Distance to the entry point, -1 if the particle is not in front
+            of the geometry.
+        )pbdoc")
+        .def_readonly("exit", &Geometry::Intersection::exit,
+            R"pbdoc(
+            Distance to the exit point, -1 if the particle is behind the
+            geometry.
+        )pbdoc")
+        .def_property_readonly("next_border",
+            &Geometry::Intersection::NextBorder);
 
     py::class_<Geometry, std::shared_ptr<Geometry>>(m_sub, "Geometry")
         .def("__str__", &py_print<Geometry>)
@@ -74,6 +96,21 @@ void init_geometry(py::module& m) {
             Return:
                 float: distance to border
         )pbdoc")
+        .def("intersect",
+             py::overload_cast<const Vector3D&, const Vector3D&>(
+                 &Geometry::Intersect, py::const_),
+             py::arg("position"), py::arg("direction"),
+             R"pbdoc(
+            Location of the particle relative to the geometry and the
+            distances to its border, calculated in one pass.
+
+            Parameters:
+                position (Vector3D): particle position
+                direction (Vector3D): particle direction
+
+            Return:
+                Intersection: location, entry and exit distance
+        )pbdoc")
         .def("distance_to_closet_approach",
              &Geometry::DistanceToClosestApproach,
              R"pbdoc(
@@ -88,6 +125,18 @@ void init_geometry(py::module& m) {
             Return:
                 float: distance to closest approach
         )pbdoc")
+        .def("minimal_distance", &Geometry::MinimalDistance,
+             py::arg("position"),
+             R"pbdoc(
+            Lower bound of the distance between the position and the
+            geometry, 0 if the position is inside.
+
+            Parameters:
+                position (Vector3D): particle position
+
+            Return:
+                float: minimal distance
+        )pbdoc")
         .def_property_readonly("name", &Geometry::GetName,
                                R"pbdoc(
             name of the geometry
@@ -163,4 +212,20 @@ void init_geometry(py::module& m) {
                       R"pbdoc(
                 height of the cylinder
             )pbdoc");
+
+    py::class_<Mesh, std::shared_ptr<Mesh>, Geometry>(m_sub, "Mesh",
+                                                      R"pbdoc(
+                Closed triangle mesh, read from an obj, stl or ply file
+                or given by vertices and triangles. The vertices are
+                relative to the position of the geometry.
+            )pbdoc")
+        .def(py::init<const Vector3D&, const std::string&, double>(),
+            py::arg("position"), py::arg("path"), py::arg("scale") = 1.
+        )
+        .def(py::init<const Vector3D&, const std::vector<Mesh::Vertex>&,
+                 const std::vector<Mesh::Face>&>(),
+            py::arg("position"), py::arg("vertices"), py::arg("faces")
+        )
+        .def(py::init<const Mesh&>())
+        .def_property_readonly("n_triangles", &Mesh::GetNumberOfTriangles);
 }
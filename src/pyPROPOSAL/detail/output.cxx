@@ -0,0 +1,114 @@
+#include "PROPOSAL/output/EventFile.h"
+#include "pyPROPOSAL/pyBindings.h"
+
+namespace py = pybind11;
+using namespace PROPOSAL;
+
+namespace {
+template <typename T> py::array_t<T> to_array(std::vector<T>& column)
+{
+    // the vector is moved into a capsule, so no copy of the data is made
+    auto data = new std::vector<T>(std::move(column));
+    py::capsule owner(data, [](void* v) { delete static_cast<std::vector<T>*>(v); });
+    return py::array_t<T>(data->size(), data->data(), owner);
+}
+
+py::dict chunk_to_dict(EventChunk& c)
+{
+    py::dict d;
+    d["first_event"] = c.first_event;
+    d["initial_energy"] = to_array(c.initial_energy);
+    d["final_energy"] = to_array(c.final_energy);
+    d["final_x"] = to_array(c.final_x);
+    d["final_y"] = to_array(c.final_y);
+    d["final_z"] = to_array(c.final_z);
+    d["final_time"] = to_array(c.final_time);
+    d["propagated_distance"] = to_array(c.propagated_distance);
+    d["decayed"] = to_array(c.decayed);
+    d["final_weight"] = to_array(c.final_weight);
+    d["loss_offsets"] = to_array(c.loss_offsets);
+    d["track_offsets"] = to_array(c.track_offsets);
+    d["loss_type"] = to_array(c.loss_type);
+    d["loss_energy"] = to_array(c.loss_energy);
+    d["loss_parent_energy"] = to_array(c.loss_parent_energy);
+    d["loss_x"] = to_array(c.loss_x);
+    d["loss_y"] = to_array(c.loss_y);
+    d["loss_z"] = to_array(c.loss_z);
+    d["loss_time"] = to_array(c.loss_time);
+    d["loss_distance"] = to_array(c.loss_distance);
+    d["loss_target_hash"] = to_array(c.loss_target_hash);
+    d["loss_weight"] = to_array(c.loss_weight);
+    d["track_type"] = to_array(c.track_type);
+    d["track_energy"] = to_array(c.track_energy);
+    d["track_x"] = to_array(c.track_x);
+    d["track_y"] = to_array(c.track_y);
+    d["track_z"] = to_array(c.track_z);
+    d["track_dx"] = to_array(c.track_dx);
+    d["track_dy"] = to_array(c.track_dy);
+    d["track_dz"] = to_array(c.track_dz);
+    d["track_time"] = to_array(c.track_time);
+    d["track_distance"] = to_array(c.track_distance);
+    d["track_weight"] = to_array(c.track_weight);
+    return d;
+}
+} // namespace
+
+void init_output(py::module& m)
+{
+    py::module m_sub = m.def_submodule("output");
+
+    py::class_<EventFileHeader>(m_sub, "EventFileHeader")
+        .def_readonly("version", &EventFileHeader::version)
+        .def_readonly("config_hash", &EventFileHeader::config_hash)
+        .def_readonly("particle_type", &EventFileHeader::particle_type)
+        .def_readonly("has_tracks", &EventFileHeader::has_tracks)
+        .def_readonly("schema", &EventFileHeader::schema);
+
+    py::class_<EventWriter, std::shared_ptr<EventWriter>>(m_sub, "EventWriter",
+        R"pbdoc(
+            Binary event file, filled by Propagator.propagate_to_file. The
+            file is written in chunks of consecutive events, every chunk
+            stores its columns contiguously.
+        )pbdoc")
+        .def(py::init<const std::string&, uint64_t, int32_t, bool, bool,
+                 uint64_t, size_t>(),
+            py::arg("path"), py::arg("config_hash") = 0,
+            py::arg("particle_type") = 0, py::arg("write_tracks") = false,
+            py::arg("ordered") = true, py::arg("first_event") = 0,
+            py::arg("max_pending") = 256)
+        .def("close", &EventWriter::Close, py::call_guard<py::gil_scoped_release>(),
+            R"pbdoc(
+                Close the file. Raises an error if events are missing in
+                ordered mode, the chunks behind the gap are not written.
+            )pbdoc")
+        .def_property_readonly("writes_tracks", &EventWriter::WritesTracks)
+        .def_property_readonly("events_written", &EventWriter::EventsWritten)
+        .def("__enter__", [](EventWriter& w) -> EventWriter& { return w; },
+            py::return_value_policy::reference)
+        .def("__exit__",
+            [](EventWriter& w, py::object, py::object, py::object) { w.Close(); });
+
+    py::class_<EventReader, std::shared_ptr<EventReader>>(m_sub, "EventReader")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def_property_readonly("header", &EventReader::GetHeader)
+        .def("read_chunk",
+            [](EventReader& r) -> py::object {
+                EventChunk chunk;
+                if (!r.ReadChunk(chunk))
+                    return py::none();
+                return chunk_to_dict(chunk);
+            },
+            R"pbdoc(
+                Read the next chunk as dict of numpy arrays, without copying
+                the columns. The losses of event i of the chunk are
+                loss_*[loss_offsets[i]:loss_offsets[i + 1]], the track
+                points accordingly. Returns None at the end of the file.
+            )pbdoc")
+        .def("__iter__", [](py::object self) { return self; })
+        .def("__next__", [](EventReader& r) {
+            EventChunk chunk;
+            if (!r.ReadChunk(chunk))
+                throw py::stop_iteration();
+            return chunk_to_dict(chunk);
+        });
+}
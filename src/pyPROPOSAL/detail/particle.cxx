@@ -5,6 +5,7 @@
 #include "PROPOSAL/medium/Components.h"
 #include "PROPOSAL/Secondaries.h"
 #include "PROPOSAL/geometry/Geometry.h"
+#include "PROPOSAL/secondaries/Thinning.h"
 #include "pyPROPOSAL/pyBindings.h"
 
 #define PARTICLE_DEF(module, cls)                                                    \
@@ -14,7 +15,79 @@
 namespace py = pybind11;
 using namespace PROPOSAL;
 
+namespace {
+// Records of the structured arrays returned for the energy losses
+struct StochasticLossRecord {
+    int type;
+    double energy;
+    double parent_particle_energy;
+    double position[3];
+    double direction[3];
+    double time;
+    double propagated_distance;
+    size_t target_hash;
+    double weight;
+};
+
+struct ContinuousLossRecord {
+    double energy;
+    double parent_particle_energy;
+    double start_position[3];
+    double end_position[3];
+    double direction_initial[3];
+    double direction_final[3];
+    double time_initial;
+    double time_final;
+};
+
+void copy_vector(const Vector3D& vec, double* out)
+{
+    for (size_t k = 0; k < 3; ++k)
+        out[k] = vec[k];
+}
+
+// Read only numpy view on memory owned by the Secondaries object, which is
+// kept alive as base of the array.
+template <typename T>
+py::array secondaries_view(py::object self, const T* data,
+    std::vector<py::ssize_t> shape, std::vector<py::ssize_t> strides)
+{
+    py::array view(py::dtype::of<T>(), shape, strides, data, self);
+    view.attr("setflags")(py::arg("write") = false);
+    return view;
+}
+
+template <typename T>
+py::array track_member_view(py::object self, const T ParticleState::*member)
+{
+    const auto& track = self.cast<const Secondaries&>().GetTrackData();
+    if (track.empty())
+        return py::array_t<T>(0);
+    py::ssize_t n = track.size();
+    py::ssize_t stride = sizeof(ParticleState);
+    return secondaries_view(self, &(track.front().*member), { n }, { stride });
+}
+
+py::array track_vector_view(py::object self, const Cartesian3D ParticleState::*member)
+{
+    const auto& track = self.cast<const Secondaries&>().GetTrackData();
+    if (track.empty())
+        return py::array_t<double>(std::vector<py::ssize_t>{ 0, 3 });
+    py::ssize_t n = track.size();
+    py::ssize_t stride = sizeof(ParticleState);
+    return secondaries_view(self, &(track.front().*member)[0], { n, 3 },
+        { stride, static_cast<py::ssize_t>(sizeof(double)) });
+}
+} // namespace
+
 void init_particle(py::module& m) {
+    PYBIND11_NUMPY_DTYPE(StochasticLossRecord, type, energy,
+        parent_particle_energy, position, direction, time, propagated_distance,
+        target_hash, weight);
+    PYBIND11_NUMPY_DTYPE(ContinuousLossRecord, energy, parent_particle_energy,
+        start_position, end_position, direction_initial, direction_final,
+        time_initial, time_final);
+
     py::module m_sub = m.def_submodule("particle");
 
     m_sub.def("get_ParticleDef_for_type", &ParticleDef::GetParticleDefForType,
@@ -256,6 +329,11 @@ void init_particle(py::module& m) {
         .def_readwrite("propagated_distance", &ParticleState::propagated_distance,
                       R"pbdoc(
                 Propagated distance of primary particle.
+            )pbdoc")
+        .def_readwrite("weight", &ParticleState::weight,
+                      R"pbdoc(
+                Statistical weight of the particle. Differs from 1 only if
+                crosssections are biased.
             )pbdoc");
 
     py::class_<Loss, std::shared_ptr<Loss>>(m_sub, "Loss", R"pbdoc(
@@ -271,17 +349,18 @@ void init_particle(py::module& m) {
             .def_readwrite("parent_particle_energy", &Loss::parent_particle_energy, R"pbdoc(Particle energy in MeV at the time of the stochastic loss or at the beginning of the continuous loss.)pbdoc");
 
     py::class_<StochasticLoss, Loss, std::shared_ptr<StochasticLoss>>(m_sub, "StochasticLoss")
-            .def(py::init<const int&, const double&, const Vector3D&, const Vector3D&, const double&, const double&, const double &, const size_t&>(),
+            .def(py::init<const int&, const double&, const Vector3D&, const Vector3D&, const double&, const double&, const double &, const size_t&, const double&>(),
                  py::arg("type"), py::arg("loss_energy"), py::arg("position"),
                  py::arg("direction"), py::arg("time"),
                  py::arg("propagated_distance"),
                  py::arg("parent_particle_energy"),
-                 py::arg("target_hash") = 0)
+                 py::arg("target_hash") = 0, py::arg("weight") = 1.)
             .def_readwrite("position", &StochasticLoss::position, R"pbdoc(Position of stochastic interaction.)pbdoc")
             .def_readwrite("direction", &StochasticLoss::direction, R"pbdoc(Direction of stochastic loss.)pbdoc")
             .def_readwrite("time", &StochasticLoss::time, R"pbdoc(Time when stochastic loss occured.)pbdoc")
             .def_readwrite("target_hash", &StochasticLoss::target_hash, R"pbdoc(Hash of target with which the stochastic interaction happened. Can be the hash of a Component or the hash of a Medium`.)pbdoc")
-            .def_readwrite("propagated_distance", &StochasticLoss::propagated_distance, R"pbdoc(Distance (in cm) the parent particle has propagated when the stochastic loss occured.)pbdoc");
+            .def_readwrite("propagated_distance", &StochasticLoss::propagated_distance, R"pbdoc(Distance (in cm) the parent particle has propagated when the stochastic loss occured.)pbdoc")
+            .def_readwrite("weight", &StochasticLoss::weight, R"pbdoc(Weight of the event after the stochastic loss. Differs from 1 only if crosssections are biased.)pbdoc");
 
     py::class_<ContinuousLoss, Loss, std::shared_ptr<ContinuousLoss>>(m_sub, "ContinuousLoss")
             .def(py::init<const double&, const double&, const Vector3D&, const Vector3D&, const Vector3D&, const Vector3D&, const double&, const double&>(),
@@ -490,6 +569,16 @@ void init_particle(py::module& m) {
                 Returns:
                     List of doubles, describing the particle propagated distances during propgation (in cm)
                  )pbdoc")
+            .def("track_weights",
+                 &Secondaries::GetTrackWeights,
+                 R"pbdoc(
+                Returns the list of the statistical weights of the propagated particle. The weights differ from 1 only
+                if crosssections are biased, in which case every weighted quantity is an unbiased estimate. The last
+                element is the weight of the whole event.
+
+                Returns:
+                    List of doubles, describing the weights of the particle during propagation
+                 )pbdoc")
             .def("track_types",
                  &Secondaries::GetTrackTypes,
                  R"pbdoc(
@@ -586,7 +675,7 @@ void init_particle(py::module& m) {
                     geometry: Geometry object, find continuous losses within this geometry
                 )pbdoc")
             .def("decay_products",
-                 &Secondaries::GetDecayProducts,
+                 overload_cast_<>()(&Secondaries::GetDecayProducts, py::const_),
                  R"pbdoc(
                 If the particle has decayed at the end of propagation, this function calculated the decay products as a
                 list of particle states. If the particle did not decay during propagation, the returned list will be
@@ -594,6 +683,123 @@ void init_particle(py::module& m) {
 
                 Returns:
                     List of ParticleStates, describing the decay products.
+                )pbdoc")
+            .def("decay_products",
+                 overload_cast_<const Thinning&>()(&Secondaries::GetDecayProducts, py::const_),
+                 py::arg("thinning"),
+                 R"pbdoc(
+                Decay products thinned with the given thinning. The surviving
+                particles carry the corrected weights.
+                )pbdoc")
+            .def("track_energies_array",
+                 [](py::object self) { return track_member_view(self, &ParticleState::energy); },
+                 R"pbdoc(
+                Read-only numpy view on the energies of the track, without copying. The view keeps the Secondaries
+                object alive.
+
+                Returns:
+                    numpy array of shape (N,), total energies in MeV
+                )pbdoc")
+            .def("track_times_array",
+                 [](py::object self) { return track_member_view(self, &ParticleState::time); },
+                 R"pbdoc(
+                Read-only numpy view on the times of the track in s, without copying.
+                )pbdoc")
+            .def("track_propagated_distances_array",
+                 [](py::object self) { return track_member_view(self, &ParticleState::propagated_distance); },
+                 R"pbdoc(
+                Read-only numpy view on the propagated distances of the track in cm, without copying.
+                )pbdoc")
+            .def("track_weights_array",
+                 [](py::object self) { return track_member_view(self, &ParticleState::weight); },
+                 R"pbdoc(
+                Read-only numpy view on the weights of the track, without copying.
+                )pbdoc")
+            .def("track_particle_types_array",
+                 [](py::object self) { return track_member_view(self, &ParticleState::type); },
+                 R"pbdoc(
+                Read-only numpy view on the particle types of the track as integers, without copying.
+                )pbdoc")
+            .def("track_positions_array",
+                 [](py::object self) { return track_vector_view(self, &ParticleState::position); },
+                 R"pbdoc(
+                Read-only numpy view on the positions of the track, without copying.
+
+                Returns:
+                    numpy array of shape (N, 3), positions in cm
+                )pbdoc")
+            .def("track_directions_array",
+                 [](py::object self) { return track_vector_view(self, &ParticleState::direction); },
+                 R"pbdoc(
+                Read-only numpy view on the directions of the track, without copying.
+
+                Returns:
+                    numpy array of shape (N, 3)
+                )pbdoc")
+            .def("track_types_array",
+                 [](py::object self) {
+                     const auto& types = self.cast<const Secondaries&>().GetTrackTypesData();
+                     py::ssize_t n = types.size();
+                     return secondaries_view(self, reinterpret_cast<const int*>(types.data()), { n },
+                         { static_cast<py::ssize_t>(sizeof(InteractionType)) });
+                 },
+                 R"pbdoc(
+                Read-only numpy view on the interaction types of the track as integers, without copying. The values
+                correspond to the Interaction_Type enum.
+                )pbdoc")
+            .def("target_hashes_array",
+                 [](py::object self) {
+                     const auto& hashes = self.cast<const Secondaries&>().GetTargetHashesData();
+                     py::ssize_t n = hashes.size();
+                     return secondaries_view(self, hashes.data(), { n },
+                         { static_cast<py::ssize_t>(sizeof(size_t)) });
+                 },
+                 R"pbdoc(
+                Read-only numpy view on the target hashes of the track, without copying.
+                )pbdoc")
+            .def("stochastic_losses_array",
+                 [](const Secondaries& self) {
+                     auto losses = self.GetStochasticLosses();
+                     py::array_t<StochasticLossRecord> records(losses.size());
+                     auto r = records.mutable_unchecked<1>();
+                     for (size_t i = 0; i < losses.size(); ++i) {
+                         r(i).type = losses[i].type;
+                         r(i).energy = losses[i].energy;
+                         r(i).parent_particle_energy = losses[i].parent_particle_energy;
+                         copy_vector(losses[i].position, r(i).position);
+                         copy_vector(losses[i].direction, r(i).direction);
+                         r(i).time = losses[i].time;
+                         r(i).propagated_distance = losses[i].propagated_distance;
+                         r(i).target_hash = losses[i].target_hash;
+                         r(i).weight = losses[i].weight;
+                     }
+                     return records;
+                 },
+                 R"pbdoc(
+                Get all stochastic losses as one numpy structured array with the fields type, energy,
+                parent_particle_energy, position, direction, time, propagated_distance, target_hash and weight.
+                )pbdoc")
+            .def("continuous_losses_array",
+                 [](const Secondaries& self) {
+                     auto losses = self.GetContinuousLosses();
+                     py::array_t<ContinuousLossRecord> records(losses.size());
+                     auto r = records.mutable_unchecked<1>();
+                     for (size_t i = 0; i < losses.size(); ++i) {
+                         r(i).energy = losses[i].energy;
+                         r(i).parent_particle_energy = losses[i].parent_particle_energy;
+                         copy_vector(losses[i].start_position, r(i).start_position);
+                         copy_vector(losses[i].end_position, r(i).end_position);
+                         copy_vector(losses[i].direction_initial, r(i).direction_initial);
+                         copy_vector(losses[i].direction_final, r(i).direction_final);
+                         r(i).time_initial = losses[i].time_initial;
+                         r(i).time_final = losses[i].time_final;
+                     }
+                     return records;
+                 },
+                 R"pbdoc(
+                Get all continuous losses as one numpy structured array with the fields energy,
+                parent_particle_energy, start_position, end_position, direction_initial, direction_final,
+                time_initial and time_final.
                 )pbdoc");
 
     py::enum_<InteractionType>(m_sub, "Interaction_Type")
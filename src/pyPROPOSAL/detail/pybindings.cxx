@@ -4,6 +4,9 @@
 #include "PROPOSAL/EnergyCutSettings.h"
 #include "PROPOSAL/Logging.h"
 #include "PROPOSAL/Propagator.h"
+#include "PROPOSAL/PropagatorService.h"
+#include "PROPOSAL/output/EventFile.h"
+#include "PROPOSAL/particle/ParticleDef.h"
 #include "PROPOSAL/math/Spherical3D.h"
 #include "PROPOSAL/version.h"
 #include "PROPOSAL/crosssection/CrossSection.h"
@@ -12,6 +15,7 @@
 #include "PROPOSAL/propagation_utility/ContRandBuilder.h"
 #include "PROPOSAL/propagation_utility/DecayBuilder.h"
 #include "PROPOSAL/propagation_utility/Interaction.h"
+#include "PROPOSAL/propagation_utility/InteractionBias.h"
 #include "PROPOSAL/propagation_utility/InteractionBuilder.h"
 #include "PROPOSAL/propagation_utility/PropagationUtility.h"
 #include "PROPOSAL/propagation_utility/TimeBuilder.h"
@@ -24,12 +28,208 @@
 #include "PROPOSAL/EnergyCutSettings.h"
 #include "PROPOSAL/Logging.h"
 #include <spdlog/spdlog.h>
+#include <array>
 
 namespace py = pybind11;
 using namespace PROPOSAL;
 using std::shared_ptr;
 
 
+namespace {
+using array_t = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+std::vector<ParticleState> make_initial_states(const Propagator& prop,
+    array_t energies, array_t positions, array_t directions)
+{
+    auto n = static_cast<size_t>(energies.size());
+    if (energies.ndim() != 1 || positions.ndim() != 2 || directions.ndim() != 2
+        || static_cast<size_t>(positions.shape(0)) != n || positions.shape(1) != 3
+        || static_cast<size_t>(directions.shape(0)) != n || directions.shape(1) != 3)
+        throw std::invalid_argument("Expected energies of shape (N,) and "
+                                    "positions and directions of shape (N, 3).");
+
+    auto e = energies.unchecked<1>();
+    auto pos = positions.unchecked<2>();
+    auto dir = directions.unchecked<2>();
+
+    std::vector<ParticleState> initial_states;
+    initial_states.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        initial_states.emplace_back(
+            static_cast<ParticleType>(prop.GetParticleDef().particle_type),
+            Cartesian3D(pos(i, 0), pos(i, 1), pos(i, 2)),
+            Cartesian3D(dir(i, 0), dir(i, 1), dir(i, 2)), e(i), 0., 0.);
+    }
+    return initial_states;
+}
+
+py::dict propagate_batch(Propagator& prop, array_t energies, array_t positions,
+    array_t directions, double max_distance, double min_energy,
+    unsigned int hierarchy_condition, unsigned int n_threads, unsigned int seed)
+{
+    auto initial_states
+        = make_initial_states(prop, energies, positions, directions);
+    auto n = initial_states.size();
+
+    std::vector<Secondaries> tracks;
+    {
+        py::gil_scoped_release release;
+        tracks = prop.PropagateBatch(initial_states, n_threads, seed,
+            max_distance, min_energy, hierarchy_condition);
+    }
+
+    py::array_t<double> final_energy(n);
+    py::array_t<double> final_position({ n, size_t(3) });
+    py::array_t<double> final_direction({ n, size_t(3) });
+    py::array_t<double> final_time(n);
+    py::array_t<double> propagated_distance(n);
+    py::array_t<bool> decayed(n);
+    py::array_t<size_t> loss_offsets(n + 1);
+
+    auto f_e = final_energy.mutable_unchecked<1>();
+    auto f_pos = final_position.mutable_unchecked<2>();
+    auto f_dir = final_direction.mutable_unchecked<2>();
+    auto f_t = final_time.mutable_unchecked<1>();
+    auto f_d = propagated_distance.mutable_unchecked<1>();
+    auto f_dec = decayed.mutable_unchecked<1>();
+    auto offsets = loss_offsets.mutable_unchecked<1>();
+
+    std::vector<std::vector<StochasticLoss>> losses(n);
+    offsets(0) = 0;
+    for (size_t i = 0; i < n; ++i) {
+        auto state = tracks[i].GetFinalState();
+        f_e(i) = state.energy;
+        f_t(i) = state.time;
+        f_d(i) = state.propagated_distance;
+        for (size_t k = 0; k < 3; ++k) {
+            f_pos(i, k) = state.position[k];
+            f_dir(i, k) = state.direction[k];
+        }
+        f_dec(i) = tracks[i].GetTrackTypes().back() == InteractionType::Decay;
+        losses[i] = tracks[i].GetStochasticLosses();
+        offsets(i + 1) = offsets(i) + losses[i].size();
+    }
+
+    size_t n_losses = offsets(n);
+    py::array_t<double> loss_energy(n_losses);
+    py::array_t<int> loss_type(n_losses);
+    py::array_t<double> loss_parent_energy(n_losses);
+    py::array_t<double> loss_position({ n_losses, size_t(3) });
+    py::array_t<double> loss_time(n_losses);
+    py::array_t<double> loss_distance(n_losses);
+
+    auto l_e = loss_energy.mutable_unchecked<1>();
+    auto l_type = loss_type.mutable_unchecked<1>();
+    auto l_parent = loss_parent_energy.mutable_unchecked<1>();
+    auto l_pos = loss_position.mutable_unchecked<2>();
+    auto l_t = loss_time.mutable_unchecked<1>();
+    auto l_d = loss_distance.mutable_unchecked<1>();
+
+    size_t j = 0;
+    for (const auto& event_losses : losses) {
+        for (const auto& loss : event_losses) {
+            l_e(j) = loss.energy;
+            l_type(j) = loss.type;
+            l_parent(j) = loss.parent_particle_energy;
+            for (size_t k = 0; k < 3; ++k)
+                l_pos(j, k) = loss.position[k];
+            l_t(j) = loss.time;
+            l_d(j) = loss.propagated_distance;
+            ++j;
+        }
+    }
+
+    py::dict result;
+    result["final_energy"] = final_energy;
+    result["final_position"] = final_position;
+    result["final_direction"] = final_direction;
+    result["final_time"] = final_time;
+    result["propagated_distance"] = propagated_distance;
+    result["decayed"] = decayed;
+    result["loss_offsets"] = loss_offsets;
+    result["loss_energy"] = loss_energy;
+    result["loss_type"] = loss_type;
+    result["loss_parent_energy"] = loss_parent_energy;
+    result["loss_position"] = loss_position;
+    result["loss_time"] = loss_time;
+    result["loss_propagated_distance"] = loss_distance;
+    return result;
+}
+
+uint64_t propagate_to_file(Propagator& prop, array_t energies,
+    array_t positions, array_t directions, EventWriter& writer,
+    unsigned int n_threads, unsigned int seed, size_t chunk_size,
+    uint64_t first_event, double max_distance, double min_energy,
+    unsigned int hierarchy_condition)
+{
+    auto initial_states
+        = make_initial_states(prop, energies, positions, directions);
+    py::gil_scoped_release release;
+    return prop.PropagateToFile(initial_states, writer, n_threads, seed,
+        chunk_size, first_event, max_distance, min_energy, hierarchy_condition);
+}
+
+// A propagator is pickled as its particle type, its json config and the
+// InterpolationSettings it has been built with. Unpickling rebuilds it from
+// the tables written by the original propagator, so no table has to be
+// recalculated.
+py::tuple propagator_getstate(const Propagator& prop)
+{
+    if (prop.GetConfig().is_null())
+        throw std::runtime_error("Only propagators created from a config "
+                                 "can be pickled.");
+
+    const auto& p_def = prop.GetParticleDef();
+    if (ParticleDef::GetParticleDefForType(p_def.particle_type) != p_def)
+        throw std::runtime_error("Only propagators of the predefined particles "
+                                 "can be pickled.");
+
+    const auto& settings = prop.GetInterpolationSettings();
+    if (settings.tables_path.empty())
+        throw std::runtime_error("Only propagators with tables written to "
+                                 "InterpolationSettings.tables_path can be "
+                                 "pickled, the tables path was empty.");
+
+    return py::make_tuple(p_def.particle_type, prop.GetConfig().dump(),
+        settings.tables_path, settings.upper_energy_lim, settings.nodes_dedx,
+        settings.nodes_de2dx, settings.nodes_dndx_e, settings.nodes_dndx_v,
+        settings.nodes_utility, settings.nodes_rate_interpolant);
+}
+
+// Applies pickled InterpolationSettings while a propagator is built and
+// restores the previous settings afterwards, so unpickling does not change
+// the settings of the process.
+class PickledInterpolationSettings {
+public:
+    explicit PickledInterpolationSettings(const py::tuple& state)
+        : previous(Propagator::TableSettings::Current())
+    {
+        Propagator::TableSettings { state[2].cast<std::string>(),
+            state[3].cast<double>(), state[4].cast<unsigned int>(),
+            state[5].cast<unsigned int>(), state[6].cast<unsigned int>(),
+            state[7].cast<unsigned int>(), state[8].cast<unsigned int>(),
+            state[9].cast<unsigned int>() }
+            .Apply();
+    }
+
+    ~PickledInterpolationSettings() { previous.Apply(); }
+
+private:
+    Propagator::TableSettings previous;
+};
+
+std::shared_ptr<Propagator> propagator_setstate(py::tuple state)
+{
+    if (state.size() != 10)
+        throw std::runtime_error("Invalid state of a pickled Propagator.");
+
+    PickledInterpolationSettings settings(state);
+    return std::make_shared<Propagator>(
+        ParticleDef::GetParticleDefForType(state[0].cast<int>()),
+        nlohmann::json::parse(state[1].cast<std::string>()));
+}
+} // namespace
+
 void init_components(py::module& m);
 void init_medium(py::module& m);
 void init_density_distribution(py::module& m);
@@ -41,6 +241,7 @@ void init_crosssection(py::module& m);
 void init_scattering(py::module& m);
 void init_math(py::module&);
 void init_secondaries(py::module&);
+void init_output(py::module&);
 
 PYBIND11_MODULE(proposal, m)
 {
@@ -59,6 +260,7 @@ PYBIND11_MODULE(proposal, m)
     init_scattering(m);
     init_math(m);
     init_secondaries(m);
+    init_output(m);
 
     m.attr("__version__") = getPROPOSALVersion();
 
@@ -173,6 +375,20 @@ PYBIND11_MODULE(proposal, m)
         .def("rates", &Interaction::Rates, py::arg("energy"))
         .def("sample_loss", &Interaction::SampleLoss, py::arg("energy"),
             py::arg("rates"), py::arg("random number"))
+        .def("build_binned_sampling", &Interaction::BuildBinnedSampling,
+            py::arg("bins_per_decade") = 20, py::arg("loss_bins") = 100,
+            R"pbdoc(
+                Precompute alias tables for the approximate binned sampling
+                of stochastic losses.
+
+                Args:
+                    bins_per_decade(int): energy nodes per decade
+                    loss_bins(int): number of bins in log(v) per channel
+            )pbdoc")
+        .def("has_binned_sampling", &Interaction::HasBinnedSampling)
+        .def("sample_loss_binned", &Interaction::SampleLossBinned,
+            py::arg("energy"), py::arg("random number 1"),
+            py::arg("random number 2"))
         .def("mean_free_path", py::vectorize(&Interaction::MeanFreePath),
             py::arg("energy"));
 
@@ -190,6 +406,28 @@ PYBIND11_MODULE(proposal, m)
               }, py::arg("displacement"), py::arg("cross"), py::arg("interpolate_interaction_integral"),
                  py::arg("interpolate_mean_free_path") = false);
 
+    py::class_<InteractionBias, std::shared_ptr<InteractionBias>>(
+        m, "InteractionBias")
+        .def("weight_continuous", &InteractionBias::WeightContinuous,
+            py::arg("E_i"), py::arg("E_f"))
+        .def("weight_stochastic", &InteractionBias::WeightStochastic,
+            py::arg("type"))
+        .def("bias", &InteractionBias::GetBias, py::arg("type"));
+
+    m.def("make_interaction_bias",
+          [](std::shared_ptr<Interaction> interaction,
+                  std::shared_ptr<Displacement> displacement,
+                  crosssection_list_t cross, bool interpolate) {
+              return shared_ptr<InteractionBias>(make_interaction_bias(
+                      interaction, displacement, cross, interpolate));
+              }, py::arg("interaction"), py::arg("displacement"),
+                 py::arg("cross"), py::arg("interpolate"),
+              R"pbdoc(
+                Weight correction for the biased crosssections in cross,
+                which are sampled by interaction. Returns None if no
+                crosssection is biased.
+            )pbdoc");
+
     py::class_<Interaction::Rate,
             std::shared_ptr<Interaction::Rate>>(m, "InteractionRate")
             .def_readwrite("comp_hash", &Interaction::Rate::comp_hash)
@@ -395,13 +633,16 @@ PYBIND11_MODULE(proposal, m)
         .def_readwrite(
             "scattering", &PropagationUtility::Collection::scattering)
         .def_readwrite("decay", &PropagationUtility::Collection::decay_calc)
-        .def_readwrite("cont_rand", &PropagationUtility::Collection::cont_rand);
+        .def_readwrite("cont_rand", &PropagationUtility::Collection::cont_rand)
+        .def_readwrite("bias", &PropagationUtility::Collection::bias);
 
     py::class_<PropagationUtility, std::shared_ptr<PropagationUtility>>(
         m, "PropagationUtility")
         .def(py::init<PropagationUtility::Collection const&>(),
             py::arg("collection"))
-        .def("energy_stochasticloss", &PropagationUtility::EnergyStochasticloss)
+        .def("energy_stochasticloss",
+            overload_cast_<double, double>()(
+                &PropagationUtility::EnergyStochasticloss))
         .def("energy_decay", &PropagationUtility::EnergyDecay)
         .def("energy_interaction", &PropagationUtility::EnergyInteraction)
         .def("energy_randomize", &PropagationUtility::EnergyRandomize)
@@ -450,19 +691,129 @@ PYBIND11_MODULE(proposal, m)
         .def(py::init<const ParticleDef&, std::vector<Sector>>())
         .def(py::init<const ParticleDef&, const std::string&>(),
             py::arg("particle_def"), py::arg("path_to_config_file"))
-        .def("propagate", &Propagator::Propagate, py::arg("initial_particle"),
+        .def("propagate",
+            overload_cast_<const ParticleState&, double, double,
+                unsigned int>()(&Propagator::Propagate),
+            py::arg("initial_particle"), py::arg("max_distance") = 1.e20,
+            py::arg("min_energy") = 0., py::arg("hierarchy_condition") = 0)
+        .def("propagate_adjoint",
+            overload_cast_<const ParticleState&, size_t, double>()(
+                &Propagator::PropagateAdjoint),
+            py::arg("target_particle"), py::arg("n_samples"),
+            py::arg("max_distance") = 1.e20,
+            R"pbdoc(
+                Propagate the state of the particle at a target backwards
+                until max_distance or the border of the sectors is reached.
+
+                Returns:
+                    List of n_samples weighted source states. The mean of
+                    weight * S(source energy) is the differential flux at the
+                    target caused by a source with the differential flux S.
+            )pbdoc")
+        .def("propagate_batch", &propagate_batch, py::arg("energies"),
+            py::arg("positions"), py::arg("directions"),
             py::arg("max_distance") = 1.e20, py::arg("min_energy") = 0.,
-            py::arg("hierarchy_condition") = 0);
+            py::arg("hierarchy_condition") = 0, py::arg("n_threads") = 0,
+            py::arg("seed") = 0,
+            R"pbdoc(
+                Propagate many particles without holding the GIL.
+
+                Args:
+                    energies: initial energies in MeV, shape (N,)
+                    positions: initial positions in cm, shape (N, 3)
+                    directions: initial directions, shape (N, 3)
+                    n_threads: number of threads, 0 uses all cores
+                    seed: every particle gets its own generator seeded with
+                        (seed, index), the result does not depend on n_threads
+
+                Returns:
+                    dict of numpy arrays. The final states are stored in
+                    final_energy, final_position, final_direction, final_time,
+                    propagated_distance and decayed, one entry per particle.
+                    The stochastic losses of all particles are flattened into
+                    the loss_* arrays, the losses of particle i are
+                    loss_*[loss_offsets[i]:loss_offsets[i + 1]].
+            )pbdoc")
+        .def("set_target", &Propagator::SetTarget, py::arg("target"),
+            py::arg("safety_factor") = 1.2, py::arg("min_density") = 0.,
+            R"pbdoc(
+                Stop the propagation of particles whose continuous slowing
+                down range, times safety_factor, can not reach the target
+                geometry. None disables the check.
+            )pbdoc")
+        .def("set_forced_volume", &Propagator::SetForcedVolume,
+            py::arg("volume"), py::arg("force_interaction") = true,
+            py::arg("n_copies") = 1,
+            R"pbdoc(
+                Force the first stochastic interaction inside volume and/or
+                split particles entering it into n_copies weighted copies
+                in propagate_split. None disables both. The weighted mean
+                over forced tracks estimates E[f * 1{interaction}], tracks
+                which end before the forced interaction get the weight 0.
+            )pbdoc")
+        .def("propagate_split",
+            [](Propagator& prop, const ParticleState& initial_particle,
+                double max_distance, double min_energy,
+                unsigned int hierarchy_condition) {
+                std::function<double()> rnd = std::bind(
+                    &RandomGenerator::RandomDouble, &RandomGenerator::Get());
+                return prop.PropagateSplit(initial_particle, rnd,
+                    max_distance, min_energy, hierarchy_condition);
+            },
+            py::arg("initial_particle"), py::arg("max_distance") = 1.e20,
+            py::arg("min_energy") = 0., py::arg("hierarchy_condition") = 0,
+            R"pbdoc(
+                Propagate the particle and split it on entry into the forced
+                volume.
 
-    /* py::class_<PropagatorService, std::shared_ptr<PropagatorService>>( */
-    /*     m, "PropagatorService") */
-    /*     .def(py::init<>()) */
-    /*     .def("propagate", &PropagatorService::Propagate, */
-    /*         py::arg("particle_definition"), py::arg("particle_condition"), */
-    /*         py::arg("max_distance") = 1e20, py::arg("min_energy") = 1e20) */
-    /*     .def("register_propagator", &PropagatorService::RegisterPropagator,
-     */
-    /*         py::arg("propagator")); */
+                Returns:
+                    List of secondaries, one per copy, with the weights
+                    divided by the number of copies.
+            )pbdoc")
+        .def("propagate_to_file", &propagate_to_file, py::arg("energies"),
+            py::arg("positions"), py::arg("directions"), py::arg("writer"),
+            py::arg("n_threads") = 0, py::arg("seed") = 0,
+            py::arg("chunk_size") = 1000, py::arg("first_event") = 0,
+            py::arg("max_distance") = 1.e20, py::arg("min_energy") = 0.,
+            py::arg("hierarchy_condition") = 0,
+            R"pbdoc(
+                Propagate many particles without holding the GIL and stream
+                the results to an output.EventWriter instead of returning
+                them. Particle i gets the event id first_event + i, the
+                seeding is the same as in propagate_batch.
+
+                Returns:
+                    number of propagated particles
+            )pbdoc")
+        .def(py::pickle(&propagator_getstate, &propagator_setstate));
+
+    py::class_<PropagatorService, std::shared_ptr<PropagatorService>>(
+        m, "PropagatorService",
+        R"pbdoc(
+            Owns one propagator per particle type and propagates every
+            particle with the propagator of its type. Can be used from
+            several threads.
+        )pbdoc")
+        .def(py::init<>())
+        .def(py::init<const std::string&, std::vector<ParticleType>>(),
+            py::arg("path_to_config_file"),
+            py::arg("particle_types") = PropagatorService::DefaultTypes())
+        .def("propagate",
+            [](PropagatorService& self, const ParticleState& state,
+                double max_distance, double min_energy,
+                unsigned int hierarchy_condition) {
+                py::gil_scoped_release release;
+                return self.Propagate(
+                    state, max_distance, min_energy, hierarchy_condition);
+            },
+            py::arg("initial_particle"), py::arg("max_distance") = 1e20,
+            py::arg("min_energy") = 0., py::arg("hierarchy_condition") = 0)
+        .def("register_propagator", &PropagatorService::RegisterPropagator,
+            py::arg("propagator"))
+        .def("is_registered", &PropagatorService::IsRegistered,
+            py::arg("particle_type"))
+        .def("get_propagator", &PropagatorService::GetPropagator,
+            py::arg("particle_type"));
 
     py::module m_sub = m.def_submodule("logging");
     m_sub.def("set_loglevel", &Logging::SetGlobalLoglevel, "Set logging level");
@@ -18,12 +18,25 @@
 #include "PROPOSAL/secondaries/parametrization/weakinteraction/WeakCooperSarkarMertsch.h"
 
 #include "PROPOSAL/secondaries/SecondariesCalculator.h"
+#include "PROPOSAL/secondaries/Thinning.h"
+#include "PROPOSAL/math/RandomGenerator.h"
 
 #include "pyPROPOSAL/pyBindings.h"
 
 namespace py = pybind11;
 using namespace PROPOSAL;
 
+constexpr const char* calculate_rho_doc = R"pbdoc(
+                Samples the asymmetry factor for interactions where two particles
+                are created. For EpairProduction and MupairProduction, this
+                factor is defined as :math:`\frac{E_+ - E_-}{E_+ + E_-}`, where
+                :math:`E_-` is the energy of the created particle and :math:`E_+`
+                the energy of the created antiparticle. For annihilation and
+                photopairproduction, this factor is defined as
+                :math:`\frac{E_{\gamma,1}}{E_+ + m_e}`, respectively
+                :math:`\frac{E_-}{E_{\gamma}}`.
+            )pbdoc";
+
 template <typename T, typename BaseT> struct SecondariesBuilder {
     template <typename... Args> auto decl_virtual_param(Args... args)
     {
@@ -42,17 +55,7 @@ template <typename T, typename BaseT> struct SecondariesBuilder {
         py::class_<T, BaseT, std::shared_ptr<T>>(args...)
             .def(py::init<ParticleDef, Medium>(), py::arg("particle_def"),
                 py::arg("medium"))
-            .def("calculate_rho", &T::CalculateRho,
-                 R"pbdoc(
-                Samples the asymmetry factor for interactions where two particles
-                are created. For EpairProduction and MupairProduction, this
-                factor is defined as :math:`\frac{E_+ - E_-}{E_+ + E_-}`, where
-                :math:`E_-` is the energy of the created particle and :math:`E_+`
-                the energy of the created antiparticle. For annihilation and
-                photopairproduction, this factor is defined as
-                :math:`\frac{E_{\gamma,1}}{E_+ + m_e}`, respectively
-                :math:`\frac{E_-}{E_{\gamma}}`.
-            )pbdoc");
+            .def("calculate_rho", &T::CalculateRho, calculate_rho_doc);
     }
 };
 
@@ -130,9 +133,22 @@ void init_secondaries(py::module& m)
     SecondariesBuilder<secondaries::NaivIonization, secondaries::Ionization> {}
         .decl_param(m_sub, "NaivIonization");
 
-    SecondariesBuilder<secondaries::KelnerKokoulinPetrukhinMupairProduction,
-        secondaries::MupairProduction> {}
-        .decl_rho_param(m_sub, "KelnerKokoulinPetrukhinMupairProduction");
+    py::class_<secondaries::KelnerKokoulinPetrukhinMupairProduction,
+        secondaries::MupairProduction,
+        std::shared_ptr<secondaries::KelnerKokoulinPetrukhinMupairProduction>>(
+        m_sub, "KelnerKokoulinPetrukhinMupairProduction")
+        .def(py::init<ParticleDef, Medium, bool>(), py::arg("particle_def"),
+            py::arg("medium"), py::arg("interpolate") = true,
+            R"pbdoc(
+                If interpolate is true, the asymmetry factor rho is sampled
+                from precalculated tables of its inverse cumulative
+                distribution. Otherwise, the distribution is integrated
+                for every secondary, which is only recommended for
+                validation purposes.
+            )pbdoc")
+        .def("calculate_rho",
+            &secondaries::KelnerKokoulinPetrukhinMupairProduction::CalculateRho,
+            calculate_rho_doc);
 
     py::class_<secondaries::PhotoMuPairProductionBurkhardtKelnerKokoulin, secondaries::PhotoMuPairProduction,
     std::shared_ptr<secondaries::PhotoMuPairProductionBurkhardtKelnerKokoulin>>(m_sub,
@@ -169,7 +185,41 @@ void init_secondaries(py::module& m)
             Medium const&>())
         .def("n_rnd", &SecondariesCalculator::RequiredRandomNumbers)
         .def("calculate_secondaries",
-            &SecondariesCalculator::CalculateSecondaries);
+            py::overload_cast<StochasticLoss, Component const&,
+                std::vector<double>&>(
+                &SecondariesCalculator::CalculateSecondaries))
+        .def("calculate_secondaries",
+            py::overload_cast<StochasticLoss, Component const&,
+                std::vector<double>&, std::function<double()>>(
+                &SecondariesCalculator::CalculateSecondaries),
+            py::arg("loss"), py::arg("component"), py::arg("rnd"),
+            py::arg("rnd_thinning"))
+        .def("set_thinning", &SecondariesCalculator::SetThinning,
+            py::arg("thinning"));
+
+    py::class_<Thinning, std::shared_ptr<Thinning>>(m_sub, "Thinning",
+        R"pbdoc(
+            Weighted thinning of secondary particles with russian roulette
+            below per type energy thresholds, Hillas thinning and weight
+            windows. The surviving particles carry corrected weights.
+        )pbdoc")
+        .def(py::init<>())
+        .def(py::init<std::vector<ParticleType>>(), py::arg("thinned_types"))
+        .def("set_roulette", &Thinning::SetRoulette, py::arg("type"),
+            py::arg("threshold"), py::arg("survival_probability"))
+        .def("set_hillas_thinning", &Thinning::SetHillasThinning,
+            py::arg("thinning_energy"))
+        .def("set_weight_window", &Thinning::SetWeightWindow,
+            py::arg("lower"), py::arg("upper"), py::arg("survival"))
+        .def("apply",
+            [](const Thinning& thinning, std::vector<ParticleState> particles,
+                double parent_energy) {
+                return thinning.Apply(std::move(particles),
+                    std::bind(&RandomGenerator::RandomDouble,
+                        &RandomGenerator::Get()),
+                    parent_energy);
+            },
+            py::arg("particles"), py::arg("parent_energy") = INF);
 
     m_sub.def("make_secondary",
         [](InteractionType type, ParticleDef const& p, Medium const& m) {
@@ -1,10 +1,67 @@
 #include "gtest/gtest.h"
 
+#include "PROPOSAL/crosssection/parametrization/Bremsstrahlung.h"
+#include "PROPOSAL/crosssection/parametrization/Compton.h"
 #include "PROPOSAL/crosssection/parametrization/EpairProduction.h"
+#include "PROPOSAL/crosssection/parametrization/Ionization.h"
 #include "PROPOSAL/crosssection/CrossSectionBuilder.h"
+#include "PROPOSAL/medium/Medium.h"
 
 using namespace PROPOSAL;
 
+namespace {
+// Compare the losses sampled from the inverse dNdx table with the losses of
+// the integral cross section, which are found by root finding on the
+// cumulative integral. The losses of the interpolated cross section have to
+// reproduce the rate on its own dNdx table, the same condition the root
+// finder on the table solves. Both samples may differ by less than 1e-3 of
+// the total rate in their cumulative distribution.
+template <typename ParamFactory>
+void CompareStochasticLoss(ParamFactory make_param, const ParticleDef& p_def,
+    const Medium& medium, std::vector<double> energies)
+{
+    std::vector<std::shared_ptr<const EnergyCutSettings>> cuts = {
+        std::make_shared<EnergyCutSettings>(500, 0.05, false),
+        std::make_shared<EnergyCutSettings>(INF, 1e-3, false),
+        std::make_shared<EnergyCutSettings>(10, 1, false),
+    };
+    for (auto& cut : cuts) {
+        auto param = make_param(*cut);
+        auto interpolated = make_crosssection(param, p_def, medium, cut, true);
+        auto integrated = make_crosssection(param, p_def, medium, cut, false);
+        for (auto energy : energies) {
+            for (auto& target : integrated->CalculatedNdx_PerTarget(energy)) {
+                auto total = target.second;
+                if (!(total > 0))
+                    continue;
+                auto total_table
+                    = interpolated->CalculatedNdx(energy, target.first);
+                for (auto fraction : { 0.01, 0.1, 0.5, 0.9, 0.99 }) {
+                    SCOPED_TRACE(interpolated->GetParametrizationName()
+                        + ", e_cut " + std::to_string(cut->GetEcut())
+                        + ", v_cut " + std::to_string(cut->GetVcut())
+                        + ", E " + std::to_string(energy) + ", rate fraction "
+                        + std::to_string(fraction));
+                    auto v_table = interpolated->CalculateStochasticLoss(
+                        target.first, energy, fraction * total_table);
+                    auto v_root = integrated->CalculateStochasticLoss(
+                        target.first, energy, fraction * total);
+
+                    EXPECT_NEAR(interpolated->CalculateCumulativeCrosssection(
+                                    energy, target.first, v_table),
+                        fraction * total_table, 1e-3 * total_table);
+                    EXPECT_NEAR(integrated->CalculateCumulativeCrosssection(
+                                    energy, target.first, v_table),
+                        integrated->CalculateCumulativeCrosssection(
+                            energy, target.first, v_root),
+                        1e-3 * total);
+                }
+            }
+        }
+    }
+}
+} // namespace
+
 TEST(CalculateStochasticLoss, GetUpperLimit_Exception)
 {
     // This causes cubic_splines::find_parameter to fail in
@@ -29,6 +86,31 @@ TEST(CalculateStochasticLoss, GetUpperLimit_Exception)
                 rate_failed, rate_failed*1e-5);
 }
 
+TEST(CalculateStochasticLoss, InverseTable)
+{
+    auto energies = std::vector<double> { 1e3, 1e5, 1e8 };
+    CompareStochasticLoss(
+        [](const EnergyCutSettings&) {
+            return crosssection::BremsKelnerKokoulinPetrukhin();
+        },
+        MuMinusDef(), StandardRock(), energies);
+    CompareStochasticLoss(
+        [](const EnergyCutSettings&) {
+            return crosssection::EpairKelnerKokoulinPetrukhin();
+        },
+        MuMinusDef(), StandardRock(), energies);
+    CompareStochasticLoss(
+        [](const EnergyCutSettings& cut) {
+            return crosssection::IonizBetheBlochRossi(cut);
+        },
+        MuMinusDef(), Water(), energies);
+    CompareStochasticLoss(
+        [](const EnergyCutSettings&) {
+            return crosssection::ComptonKleinNishina();
+        },
+        GammaDef(), Water(), { 1., 1e2, 1e5 });
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
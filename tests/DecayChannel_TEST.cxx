@@ -6,10 +6,13 @@
 #include "PROPOSAL/decay/LeptonicDecayChannel.h"
 #include "PROPOSAL/decay/ManyBodyPhaseSpace.h"
 #include "PROPOSAL/decay/TwoBodyPhaseSpace.h"
+#include "PROPOSAL/math/MathMethods.h"
 #include "PROPOSAL/math/RandomGenerator.h"
 #include "PROPOSALTestUtilities/TestFilesHandling.h"
 
 #include <memory>
+#include <random>
+#include <thread>
 
 using namespace PROPOSAL;
 
@@ -941,6 +944,181 @@ TEST(DecaySpectrum, TauMinus_energy)
     in.close();
 }
 
+TEST(ManyBodyPhaseSpace, BatchDecay)
+{
+    std::vector<std::shared_ptr<const ParticleDef>> daughters = {
+        std::make_shared<ParticleDef>(EMinusDef()),
+        std::make_shared<ParticleDef>(NuEBarDef()),
+        std::make_shared<ParticleDef>(NuTauDef()),
+    };
+
+    std::vector<ParticleState> parents;
+    for (int i = 0; i < 100; ++i)
+        parents.emplace_back(ParticleType::TauMinus, Cartesian3D(0, 0, 0),
+            Cartesian3D(0, 0, 1), tau.mass + 10. * i, 0., 0.);
+
+    ManyBodyPhaseSpace single(daughters);
+    RandomGenerator::Get().SetSeed(1234);
+    std::vector<ParticleState> expected;
+    for (const auto& p : parents) {
+        auto products = single.Decay(tau, p);
+        expected.insert(expected.end(), products.begin(), products.end());
+    }
+
+    ManyBodyPhaseSpace batch(daughters);
+    RandomGenerator::Get().SetSeed(1234);
+    std::vector<ParticleState> products;
+    batch.Decay(tau, parents, products);
+
+    ASSERT_EQ(products.size(), parents.size() * batch.GetNumberOfDaughters());
+    for (size_t i = 0; i < products.size(); ++i) {
+        EXPECT_EQ(products[i].type, expected[i].type);
+        EXPECT_DOUBLE_EQ(products[i].energy, expected[i].energy);
+    }
+}
+
+TEST(ManyBodyPhaseSpace, Threads)
+{
+    // the phase space parameters of the parents are calculated while other
+    // threads decay, the products have to match a decay on one thread
+    std::vector<std::shared_ptr<const ParticleDef>> daughters = {
+        std::make_shared<ParticleDef>(EMinusDef()),
+        std::make_shared<ParticleDef>(NuEBarDef()),
+        std::make_shared<ParticleDef>(NuTauDef()),
+    };
+    std::vector<ParticleDef> parent_defs = { mu, tau };
+
+    auto decay = [&](ManyBodyPhaseSpace& channel, unsigned int seed) {
+        const auto& p_def = parent_defs[seed % parent_defs.size()];
+        std::vector<ParticleState> parents(100,
+            ParticleState(static_cast<ParticleType>(p_def.particle_type),
+                Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), 2 * p_def.mass,
+                0., 0.));
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> uniform(0., 1.);
+        std::vector<ParticleState> products;
+        channel.Decay(p_def, parents, products, [&]() { return uniform(rng); });
+        return products;
+    };
+
+    const unsigned int n_threads = 4;
+    ManyBodyPhaseSpace single(daughters, matrix_element_evaluate);
+    std::vector<std::vector<ParticleState>> expected;
+    for (unsigned int t = 0; t < n_threads; ++t)
+        expected.push_back(decay(single, t));
+
+    ManyBodyPhaseSpace shared(daughters, matrix_element_evaluate);
+    std::vector<std::vector<ParticleState>> products(n_threads);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < n_threads; ++t)
+        threads.emplace_back([&, t]() { products[t] = decay(shared, t); });
+    for (auto& thread : threads)
+        thread.join();
+
+    for (unsigned int t = 0; t < n_threads; ++t) {
+        ASSERT_EQ(products[t].size(), expected[t].size());
+        for (size_t i = 0; i < products[t].size(); ++i)
+            EXPECT_EQ(products[t][i].energy, expected[t][i].energy);
+    }
+}
+
+namespace {
+// exposes the inverse rate table of the leptonic decay
+template <typename Channel> class InverseRateChannel : public Channel {
+public:
+    using Channel::Channel;
+    double Sample(double parent_mass, double rnd)
+    {
+        return Channel::SampleEnergyFraction(
+            *this->GetInverseRateTable(parent_mass), rnd);
+    }
+    const void* Table(double parent_mass)
+    {
+        return this->GetInverseRateTable(parent_mass).get();
+    }
+};
+} // namespace
+
+TEST(LeptonicDecayChannel, InverseRateTable)
+{
+    // the table has to reproduce the NewtonRaphson inversion of the decay
+    // rate, which has been solved for every decay before
+    auto m = eminus.mass;
+    auto approx_rate = [](double x) { return x * x * x * (1. - 0.5 * x); };
+    auto approx_drate = [](double x) { return (3 - 2 * x) * x * x; };
+    auto rate = [m](double x, double M, double E_max) {
+        double E_l = E_max * x;
+        double sqrt_EM = std::sqrt(E_l * E_l - m * m);
+        return 1.5 * m * m * m * m * M * std::log(sqrt_EM + E_l)
+            + sqrt_EM * ((M * M + m * m - M * E_l) * (E_l * E_l - m * m)
+                - 1.5 * M * E_l * m * m);
+    };
+    auto drate = [m](double x, double M, double E_max) {
+        double E_l = E_max * x;
+        return E_max * std::sqrt(E_l * E_l - m * m)
+            * (M * E_l * (3.0 * M - 4.0 * E_l) + m * m * (3.0 * E_l - 2 * M));
+    };
+
+    InverseRateChannel<LeptonicDecayChannelApprox> approx(eminus, nue, nuebar);
+    InverseRateChannel<LeptonicDecayChannel> exact(eminus, nue, nuebar);
+
+    for (auto M : { mu.mass, tau.mass }) {
+        auto E_max = (M * M + m * m) / (2 * M);
+        auto x_min = m / E_max;
+        for (int i = 0; i <= 1000; ++i) {
+            auto rnd = i / 1000.;
+
+            auto f_min = approx_rate(x_min);
+            auto f_max = approx_rate(1.);
+            auto right_side = f_min + (f_max - f_min) * rnd;
+            auto x = NewtonRaphson(
+                [&](double xx) { return approx_rate(xx) - right_side; },
+                approx_drate, x_min, 1., 0.5, 100, 1e-10);
+            EXPECT_NEAR(approx.Sample(M, rnd), x, 1e-6);
+
+            f_min = rate(x_min, M, E_max);
+            f_max = rate(1., M, E_max);
+            right_side = f_min + (f_max - f_min) * rnd;
+            x = NewtonRaphson(
+                [&](double xx) { return rate(xx, M, E_max) - right_side; },
+                [&](double xx) { return drate(xx, M, E_max); }, x_min, 1., 0.5,
+                100, 1e-10);
+            EXPECT_NEAR(exact.Sample(M, rnd), x, 1e-6);
+        }
+    }
+
+    // the tables are cached per parent mass and shared with copies
+    auto table = exact.Table(tau.mass);
+    EXPECT_EQ(exact.Table(tau.mass), table);
+    InverseRateChannel<LeptonicDecayChannel> copy(exact);
+    EXPECT_EQ(copy.Table(tau.mass), table);
+    EXPECT_NE(exact.Table(mu.mass), table);
+    EXPECT_EQ(exact.Table(tau.mass), table);
+}
+
+TEST(LeptonicDecayChannel, InverseRateTableThreads)
+{
+    // threads asking for tables of different parent masses at once have to
+    // get one table per mass
+    InverseRateChannel<LeptonicDecayChannel> channel(eminus, nue, nuebar);
+    std::vector<double> masses = { mu.mass, tau.mass, 2 * tau.mass };
+
+    const int n_threads = 4;
+    std::vector<std::vector<const void*>> tables(n_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; ++t)
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 100; ++i)
+                tables[t].push_back(channel.Table(masses[(t + i) % masses.size()]));
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    for (int t = 0; t < n_threads; ++t)
+        for (int i = 0; i < 100; ++i)
+            EXPECT_EQ(tables[t][i], channel.Table(masses[(t + i) % masses.size()]));
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
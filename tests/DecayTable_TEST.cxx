@@ -1,6 +1,9 @@
 
 #include "gtest/gtest.h"
 
+#include <random>
+#include <thread>
+
 #include "PROPOSAL/decay/DecayTable.h"
 #include "PROPOSAL/decay/LeptonicDecayChannel.h"
 #include "PROPOSAL/decay/StableChannel.h"
@@ -177,6 +180,85 @@ TEST(SelectChannel, Tau)
     EXPECT_TRUE(twobody_count > 0);
 }
 
+TEST(Decay, Batch)
+{
+    ParticleDef tau_def = TauMinusDef();
+
+    std::vector<ParticleState> parents;
+    std::vector<double> rnd_channel;
+    for (int i = 0; i < 1000; ++i)
+    {
+        parents.emplace_back(ParticleType::TauMinus, Cartesian3D(0, 0, 0),
+            Cartesian3D(0, 0, 1), 1e4, 0., 0.);
+        rnd_channel.push_back(RandomGenerator::Get().RandomDouble());
+    }
+
+    std::vector<ParticleState> products;
+    std::vector<size_t> offsets;
+    tau_def.decay_table.Decay(tau_def, parents, rnd_channel, products, offsets);
+
+    ASSERT_EQ(offsets.size(), parents.size() + 1);
+    EXPECT_EQ(offsets.back(), products.size());
+
+    for (size_t i = 0; i < parents.size(); ++i)
+    {
+        double energy_sum = 0;
+        for (size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+            energy_sum += products[k].energy;
+        EXPECT_NEAR(energy_sum, parents[i].energy, 1e-6 * parents[i].energy);
+    }
+}
+
+TEST(Decay, Threads)
+{
+    // every thread decays with its own generator, the products have to match
+    // the decays of the same generators one after another
+    ParticleDef tau_def = TauMinusDef();
+    const DecayTable& table = tau_def.decay_table;
+
+    std::vector<ParticleState> parents;
+    for (int i = 0; i < 1000; ++i)
+        parents.emplace_back(ParticleType::TauMinus, Cartesian3D(0, 0, 0),
+            Cartesian3D(0, 0, 1), 1e4 + i, 0., 0.);
+
+    auto decay = [&](unsigned int seed, std::vector<ParticleState>& products,
+                     std::vector<size_t>& offsets) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> uniform(0., 1.);
+        std::function<double()> rnd = [&]() { return uniform(rng); };
+        std::vector<double> rnd_channel;
+        for (size_t i = 0; i < parents.size(); ++i)
+            rnd_channel.push_back(rnd());
+        table.Decay(tau_def, parents, rnd_channel, products, offsets, rnd);
+    };
+
+    const unsigned int n_threads = 4;
+    std::vector<std::vector<ParticleState>> expected(n_threads);
+    std::vector<std::vector<size_t>> expected_offsets(n_threads);
+    for (unsigned int t = 0; t < n_threads; ++t)
+        decay(t, expected[t], expected_offsets[t]);
+
+    std::vector<std::vector<ParticleState>> products(n_threads);
+    std::vector<std::vector<size_t>> offsets(n_threads);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < n_threads; ++t)
+        threads.emplace_back(decay, t, std::ref(products[t]), std::ref(offsets[t]));
+    for (auto& thread : threads)
+        thread.join();
+
+    for (unsigned int t = 0; t < n_threads; ++t)
+    {
+        EXPECT_EQ(offsets[t], expected_offsets[t]);
+        ASSERT_EQ(products[t].size(), expected[t].size());
+        for (size_t i = 0; i < products[t].size(); ++i)
+        {
+            EXPECT_EQ(products[t][i].type, expected[t][i].type);
+            EXPECT_EQ(products[t][i].energy, expected[t][i].energy);
+            EXPECT_EQ(products[t][i].direction, expected[t][i].direction);
+        }
+    }
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -3,8 +3,16 @@
 
 #include "PROPOSAL/density_distr/density_exponential.h"
 #include "PROPOSAL/density_distr/density_homogeneous.h"
+#include "PROPOSAL/density_distr/density_layered.h"
 #include "PROPOSAL/density_distr/density_polynomial.h"
 #include "PROPOSAL/density_distr/density_splines.h"
+#include "PROPOSAL/density_distr/density_variant.h"
+#include "PROPOSAL/density_distr/density_voxel.h"
+#include "PROPOSAL/math/Cartesian3D.h"
+#include "PROPOSALTestUtilities/DensityChecks.h"
+
+#include <nlohmann/json.hpp>
+#include <cstdio>
 
 using namespace PROPOSAL;
 
@@ -98,6 +106,167 @@ TEST(Assignment, Copyconstructor)
     EXPECT_TRUE(A == C);
 }
 
+TEST(Correct, Polynomial)
+{
+    CartesianAxis axis(Cartesian3D(0, 0, 1), Cartesian3D(0, 0, 0));
+    Cartesian3D position(0, 0, 2);
+    for (auto coefficients : std::vector<std::vector<double>>{
+             { 2. }, { 1., 0.5 }, { 1., 0.5, 0.1 }, { 1., 0.5, 0.1, 0.01 } }) {
+        Density_polynomial density(axis, Polynom(coefficients), 1.3);
+        for (auto direction : { Cartesian3D(0, 0, 1), Cartesian3D(0.6, 0, 0.8) }) {
+            for (auto distance : { 0., 0.1, 1., 10. }) {
+                auto grammage = density.Calculate(position, direction, distance);
+                EXPECT_NEAR(density.Correct(position, direction, grammage, 20.),
+                    distance, 1e-6);
+            }
+            auto grammage = density.Calculate(position, direction, 20.);
+            EXPECT_THROW(density.Correct(position, direction, 2 * grammage, 20.),
+                DensityException);
+        }
+
+        // direction perpendicular to the axis
+        Cartesian3D direction(1, 0, 0);
+        auto grammage = density.Calculate(position, direction, 3.);
+        EXPECT_DOUBLE_EQ(grammage, 3. * density.Evaluate(position));
+        EXPECT_DOUBLE_EQ(density.Correct(position, direction, grammage, 20.), 3.);
+    }
+}
+
+TEST(Correct, Splines)
+{
+    CartesianAxis axis(Cartesian3D(0, 0, 1), Cartesian3D(0, 0, 0));
+    std::vector<double> x = { 0., 1., 2., 4., 8. };
+    std::vector<double> y = { 1., 2., 1.5, 3., 2. };
+    Cartesian3D position(0, 0, 0.5);
+    Cartesian3D direction(0, 0.6, 0.8);
+
+    Density_splines linear(axis, Linear_Spline(x, y), 1.);
+    Density_splines cubic(axis, Cubic_Spline(x, y), 1.);
+    for (auto density : { linear, cubic }) {
+        // the last distance exceeds the domain of the spline
+        for (auto distance : { 0., 0.3, 2., 5., 9., 12. }) {
+            auto grammage = density.Calculate(position, direction, distance);
+            EXPECT_NEAR(density.Correct(position, direction, grammage, 15.),
+                distance, 1e-6);
+        }
+    }
+}
+
+TEST(Layered, PREM_Evaluate)
+{
+    Density_layered prem(Cartesian3D(0, 0, 0), Density_layered::PREM(),
+        Density_layered::EARTH_RADIUS);
+    EXPECT_DOUBLE_EQ(prem.Evaluate(Cartesian3D(0, 0, 0)), 13.0885);
+    EXPECT_DOUBLE_EQ(prem.Evaluate(Cartesian3D(0, 0, 6.37e8)), 1.02);
+    EXPECT_DOUBLE_EQ(prem.Evaluate(Cartesian3D(0, 0, 6.4e8)), 0.);
+
+    auto config = nlohmann::json::parse(R"({"type": "prem"})");
+    EXPECT_TRUE(*CreateDensityDistribution(config) == prem);
+
+    auto layer = nlohmann::json::parse(R"({"type": "layered", "layers": [
+        {"outer_radius": 1e8, "coefficients": [7.9], "medium": "iron"}]})");
+    EXPECT_THROW(CreateDensityDistribution(layer), std::invalid_argument);
+}
+
+TEST(Layered, PREM_Grammage)
+{
+    Density_layered prem(Cartesian3D(0, 0, 0), Density_layered::PREM(),
+        Density_layered::EARTH_RADIUS);
+    Cartesian3D position(1e8, 2e8, -6.3e8);
+    Cartesian3D direction(0.1, -0.3, 0.9);
+    direction.normalize();
+
+    for (auto distance : { 1e8, 5e8, 1.2e9 })
+        ExpectGrammageRoundTrip(prem, position, direction, distance, 2e9, 1e-3);
+
+    // the target grammage is behind the earth
+    EXPECT_THROW(prem.Correct(position, direction, 1e11, 2e9),
+        DensityException);
+}
+
+TEST(Voxel, Grammage)
+{
+    VoxelGrid grid;
+    grid.n = { 4, 3, 2 };
+    grid.origin = Cartesian3D(-2, -1.5, 0);
+    grid.spacing = { 1., 1., 2. };
+    for (size_t i = 0; i < grid.size(); ++i)
+        grid.values.push_back(0.5 + 0.1 * i);
+    grid.media.resize(grid.size(), 3);
+
+    std::string path = "Density_distribution_TEST_grid.ppvx";
+    grid.Write(path);
+    Density_voxel density(path, 2., 0.25);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(density.GetGrid()->values, grid.values);
+    EXPECT_DOUBLE_EQ(density.Evaluate(Cartesian3D(-1.5, -1, 3)),
+        2. * grid.values[grid.GetIndex(0, 0, 1)]);
+    EXPECT_DOUBLE_EQ(density.Evaluate(Cartesian3D(5, 0, 0)), 0.5);
+    EXPECT_EQ(density.GetMediumIndex(Cartesian3D(0, 0, 1)), 3);
+    EXPECT_EQ(density.GetMediumIndex(Cartesian3D(0, 0, -1)), -1);
+
+    // track starting outside, crossing the grid and leaving it again
+    Cartesian3D position(-3, -2, -0.5);
+    Cartesian3D direction(0.6, 0.3, 0.4);
+    direction.normalize();
+    for (auto distance : { 0.5, 2., 4., 8. })
+        ExpectGrammageRoundTrip(density, position, direction, distance, 10., 1e-9);
+    EXPECT_THROW(density.Correct(position, direction, 100., 10.),
+        DensityException);
+}
+
+TEST(DensityVariant, SameAsVirtual)
+{
+    // derived from a built-in distribution, has to use the virtual interface
+    struct ScaledDensity : public Density_homogeneous {
+        using Density_homogeneous::Density_homogeneous;
+        double Evaluate(const Vector3D& xi) const override
+        {
+            return 2. * Density_homogeneous::Evaluate(xi);
+        }
+    };
+
+    VoxelGrid grid;
+    grid.n = { 2, 3, 4 };
+    grid.origin = Cartesian3D(-1, 0, 0);
+    grid.spacing = { 1., 1., 1. };
+    for (size_t i = 0; i < grid.size(); ++i)
+        grid.values.push_back(1. + 0.2 * i);
+    grid.media.resize(grid.size(), 0);
+    std::string path = "Density_distribution_TEST_variant.ppvx";
+    grid.Write(path);
+    auto voxel = std::make_shared<Density_voxel>(path, 1., 0.5);
+    std::remove(path.c_str());
+
+    CartesianAxis axis(Cartesian3D(0, 0, 1), Cartesian3D(0, 0, 0));
+    std::vector<std::shared_ptr<Density_distr>> densities = {
+        std::make_shared<Density_homogeneous>(2.7),
+        std::make_shared<Density_exponential>(axis, 10., 0., 1.5),
+        std::make_shared<Density_polynomial>(axis, Polynom(std::vector<double> { 1., 0.1 }), 1.),
+        std::make_shared<Density_splines>(axis,
+            Linear_Spline(std::vector<double> { 0., 5., 10. },
+                std::vector<double> { 1., 2., 1.5 }),
+            1.),
+        std::make_shared<Density_layered>(Cartesian3D(0, 0, 0),
+            Density_layered::PREM(), Density_layered::EARTH_RADIUS),
+        voxel, std::make_shared<ScaledDensity>(2.7) };
+
+    Cartesian3D position(0, 1, 2);
+    Cartesian3D direction(0, 0.6, 0.8);
+    for (auto& density : densities) {
+        DensityVariant variant(*density);
+        EXPECT_EQ(&variant.GetDensity(), density.get());
+        EXPECT_EQ(variant.Evaluate(position), density->Evaluate(position));
+        for (auto distance : { 0., 0.5, 3. }) {
+            auto grammage = density->Calculate(position, direction, distance);
+            EXPECT_EQ(variant.Calculate(position, direction, distance), grammage);
+            EXPECT_EQ(variant.Correct(position, direction, grammage, 10.),
+                density->Correct(position, direction, grammage, 10.));
+        }
+    }
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -1,6 +1,7 @@
 #include "gtest/gtest.h"
 
 #include "PROPOSAL/crosssection/CrossSectionBuilder.h"
+#include "PROPOSAL/propagation_utility/CSDARange.h"
 #include "PROPOSAL/propagation_utility/DisplacementBuilder.h"
 #include "PROPOSAL/propagation_utility/PropagationUtilityIntegral.h"
 #include "PROPOSAL/propagation_utility/PropagationUtilityInterpolant.h"
@@ -118,6 +119,24 @@ TEST(UpperLimitTrackIntegral, LowerLimCheck)
     EXPECT_NEAR(E_f, lower_lim, lower_lim * COMPUTER_PRECISION);
 }
 
+TEST(CSDARange, UpperBound)
+{
+    // the tabulated range must never be smaller than the exact range
+    DisplacementBuilder disp_calc(GetCrossSections(), std::true_type());
+    CSDARange range(disp_calc);
+    auto lower_lim = disp_calc.GetLowerLim();
+    EXPECT_EQ(range.GetGrammage(lower_lim), 0.);
+    double previous = 0.;
+    for (double logE = 3.; logE < 12; logE += 1.e-2) {
+        auto E = std::pow(10., logE);
+        auto grammage = range.GetGrammage(E);
+        EXPECT_GE(grammage, disp_calc.SolveTrackIntegral(E, lower_lim));
+        EXPECT_GE(grammage, previous);
+        previous = grammage;
+    }
+    EXPECT_EQ(range.GetGrammage(2 * InterpolationSettings::UPPER_ENERGY_LIM), INF);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,267 @@
+#include "gtest/gtest.h"
+
+#include "PROPOSAL/output/EventFile.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace PROPOSAL;
+
+namespace {
+EventRecord CreateEvent(size_t id, bool store_track)
+{
+    EventRecord record(store_track);
+    double energy = 1e6 + id;
+    ParticleState state(ParticleType::MuMinus, Cartesian3D(0, 0, 0),
+        Cartesian3D(0, 0, 1), energy, 0., 0.);
+    record.push_back(state, InteractionType::ContinuousEnergyLoss);
+    for (size_t i = 0; i < id % 4; ++i) {
+        state.energy -= 10.;
+        state.propagated_distance += 100.;
+        state.position = Cartesian3D(0, 0, state.propagated_distance);
+        state.weight *= 0.5;
+        record.push_back(state, InteractionType::Brems, 42);
+    }
+    record.push_back(state, InteractionType::Decay);
+    return record;
+}
+
+EventChunk CreateChunk(size_t first, size_t n, bool store_track)
+{
+    EventChunk chunk;
+    chunk.first_event = first;
+    for (size_t i = first; i < first + n; ++i)
+        chunk.Append(CreateEvent(i, store_track));
+    return chunk;
+}
+} // namespace
+
+TEST(EventRecord, Losses)
+{
+    auto record = CreateEvent(3, false);
+    EXPECT_EQ(record.n_points, 5);
+    EXPECT_TRUE(record.decayed);
+    EXPECT_TRUE(record.track.empty());
+    ASSERT_EQ(record.losses.size(), 3);
+    for (auto& loss : record.losses) {
+        EXPECT_EQ(loss.type, static_cast<int>(InteractionType::Brems));
+        EXPECT_DOUBLE_EQ(loss.energy, 10.);
+        EXPECT_EQ(loss.target_hash, 42);
+    }
+    EXPECT_DOUBLE_EQ(record.losses.back().weight, 0.125);
+    EXPECT_DOUBLE_EQ(record.final_state.weight, 0.125);
+    EXPECT_DOUBLE_EQ(record.initial_state.energy, 1e6 + 3);
+    EXPECT_DOUBLE_EQ(record.final_state.energy, 1e6 + 3 - 30.);
+
+    record.clear();
+    EXPECT_EQ(record.n_points, 0);
+    EXPECT_TRUE(record.losses.empty());
+}
+
+TEST(EventFile, Roundtrip)
+{
+    std::string path = "EventFile_TEST_roundtrip.ppev";
+    for (bool store_track : { false, true }) {
+        {
+            EventWriter writer(path, 1234, 13, store_track);
+            // chunks arriving out of order are sorted by the writer
+            writer.Write(CreateChunk(10, 5, store_track));
+            writer.Write(CreateChunk(0, 10, store_track));
+            writer.Write(CreateChunk(15, 3, store_track));
+            writer.Close();
+            EXPECT_EQ(writer.EventsWritten(), 18);
+        }
+
+        EventReader reader(path);
+        EXPECT_EQ(reader.GetHeader().config_hash, 1234);
+        EXPECT_EQ(reader.GetHeader().particle_type, 13);
+        EXPECT_EQ(reader.GetHeader().has_tracks, store_track);
+
+        EventChunk chunk;
+        size_t next_event = 0;
+        while (reader.ReadChunk(chunk)) {
+            EXPECT_EQ(chunk.first_event, next_event);
+            auto expected = CreateChunk(chunk.first_event, chunk.size(), store_track);
+            EXPECT_EQ(chunk.initial_energy, expected.initial_energy);
+            EXPECT_EQ(chunk.final_energy, expected.final_energy);
+            EXPECT_EQ(chunk.final_z, expected.final_z);
+            EXPECT_EQ(chunk.decayed, expected.decayed);
+            EXPECT_EQ(chunk.final_weight, expected.final_weight);
+            EXPECT_EQ(chunk.loss_offsets, expected.loss_offsets);
+            EXPECT_EQ(chunk.loss_energy, expected.loss_energy);
+            EXPECT_EQ(chunk.loss_type, expected.loss_type);
+            EXPECT_EQ(chunk.loss_target_hash, expected.loss_target_hash);
+            EXPECT_EQ(chunk.loss_weight, expected.loss_weight);
+            EXPECT_EQ(chunk.track_offsets, expected.track_offsets);
+            EXPECT_EQ(chunk.track_energy, expected.track_energy);
+            EXPECT_EQ(chunk.track_type, expected.track_type);
+            EXPECT_EQ(chunk.track_weight, expected.track_weight);
+            next_event += chunk.size();
+        }
+        EXPECT_EQ(next_event, 18);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(EventFile, Gap)
+{
+    std::string path = "EventFile_TEST_gap.ppev";
+    {
+        EventWriter writer(path, 0);
+        writer.Write(CreateChunk(0, 5, false));
+        writer.Write(CreateChunk(10, 5, false));
+        EXPECT_THROW(writer.Close(), std::runtime_error);
+        EXPECT_EQ(writer.EventsWritten(), 5);
+    }
+
+    // the chunk behind the gap is not written
+    EventReader reader(path);
+    EventChunk chunk;
+    ASSERT_TRUE(reader.ReadChunk(chunk));
+    EXPECT_EQ(chunk.first_event, 0);
+    EXPECT_FALSE(reader.ReadChunk(chunk));
+    std::remove(path.c_str());
+}
+
+TEST(EventFile, MaxPending)
+{
+    std::string path = "EventFile_TEST_pending.ppev";
+    {
+        EventWriter writer(path, 0, 0, false, true, 0, 2);
+        writer.Write(CreateChunk(5, 5, false));
+        writer.Write(CreateChunk(10, 5, false));
+        EXPECT_THROW(writer.Write(CreateChunk(15, 5, false)),
+            std::runtime_error);
+
+        // the next chunk is always accepted
+        writer.Write(CreateChunk(0, 5, false));
+        EXPECT_EQ(writer.EventsWritten(), 15);
+        writer.Write(CreateChunk(15, 5, false));
+        writer.Close();
+        EXPECT_EQ(writer.EventsWritten(), 20);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(EventFile, DuplicateChunk)
+{
+    std::string path = "EventFile_TEST_duplicate.ppev";
+    {
+        EventWriter writer(path, 0);
+        writer.Write(CreateChunk(0, 5, false));
+        writer.Write(CreateChunk(10, 5, false));
+
+        // already written, held back or overlapping a held back chunk
+        EXPECT_THROW(writer.Write(CreateChunk(0, 5, false)),
+            std::invalid_argument);
+        EXPECT_THROW(writer.Write(CreateChunk(3, 2, false)),
+            std::invalid_argument);
+        EXPECT_THROW(writer.Write(CreateChunk(10, 5, false)),
+            std::invalid_argument);
+        EXPECT_THROW(writer.Write(CreateChunk(8, 5, false)),
+            std::invalid_argument);
+        EXPECT_THROW(writer.Write(CreateChunk(12, 5, false)),
+            std::invalid_argument);
+
+        writer.Write(CreateChunk(5, 5, false));
+        writer.Close();
+        EXPECT_EQ(writer.EventsWritten(), 15);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(EventFile, ByteOrder)
+{
+    std::string path = "EventFile_TEST_byteorder.ppev";
+    {
+        EventWriter writer(path, 0x0102030405060708, 13);
+        writer.Close();
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::vector<unsigned char> bytes(20);
+    file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+    std::vector<unsigned char> expected = { 'P', 'P', 'E', 'V', 2, 0, 0, 0,
+        8, 7, 6, 5, 4, 3, 2, 1, 13, 0, 0, 0 };
+    EXPECT_EQ(bytes, expected);
+    file.close();
+
+    EventReader reader(path);
+    EXPECT_EQ(reader.GetHeader().config_hash, 0x0102030405060708);
+    EXPECT_NE(reader.GetHeader().schema.find("\"<f8\""), std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(EventFile, Version1)
+{
+    // version 1 has no weight columns, they are read as 1
+    std::string path = "EventFile_TEST_version1.ppev";
+    {
+        std::ofstream file(path, std::ios::binary);
+        auto write = [&file](auto value) {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        };
+        std::string schema = "[]";
+        write(EventFileHeader::MAGIC);
+        write(uint32_t(1));
+        write(uint64_t(1234));
+        write(int32_t(13));
+        write(uint8_t(0));
+        write(uint64_t(schema.size()));
+        file.write(schema.data(), schema.size());
+
+        // chunk of two events, the second one with one loss
+        write(uint32_t(0x4b4e4843));
+        write(uint64_t(7));
+        write(uint64_t(2));
+        write(uint64_t(1));
+        write(uint64_t(0));
+        for (auto energy : { 1e6, 2e6 }) // initial_energy
+            write(energy);
+        for (auto energy : { 1e5, 2e5 }) // final_energy
+            write(energy);
+        for (auto i = 0; i < 5 * 2; ++i) // position, time, distance
+            write(0.);
+        write(uint8_t(1)); // decayed
+        write(uint8_t(0));
+        for (auto offset : { 0, 0, 1 }) // loss_offsets
+            write(uint64_t(offset));
+        for (auto i = 0; i < 3; ++i) // track_offsets
+            write(uint64_t(0));
+        write(int32_t(InteractionType::Brems));
+        write(1e3); // loss_energy
+        for (auto i = 0; i < 6; ++i) // parent energy, position, time, distance
+            write(0.);
+        write(uint64_t(42));
+    }
+
+    EventReader reader(path);
+    EXPECT_EQ(reader.GetHeader().version, 1);
+    EXPECT_EQ(reader.GetHeader().config_hash, 1234);
+    EventChunk chunk;
+    ASSERT_TRUE(reader.ReadChunk(chunk));
+    EXPECT_EQ(chunk.first_event, 7);
+    EXPECT_EQ(chunk.final_energy, std::vector<double>({ 1e5, 2e5 }));
+    EXPECT_EQ(chunk.final_weight, std::vector<double>({ 1., 1. }));
+    EXPECT_EQ(chunk.loss_energy, std::vector<double>({ 1e3 }));
+    EXPECT_EQ(chunk.loss_target_hash, std::vector<uint64_t>({ 42 }));
+    EXPECT_EQ(chunk.loss_weight, std::vector<double>({ 1. }));
+    EXPECT_TRUE(chunk.track_weight.empty());
+    EXPECT_FALSE(reader.ReadChunk(chunk));
+
+    // new chunks would not match the columns of the file
+    EXPECT_THROW(EventWriter::Append(path, 9), std::invalid_argument);
+    std::remove(path.c_str());
+}
+
+TEST(EventFile, InvalidFile)
+{
+    EXPECT_THROW(EventReader("EventFile_TEST_missing.ppev"),
+        std::invalid_argument);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -6,10 +6,17 @@
 #include "PROPOSAL/geometry/Box.h"
 #include "PROPOSAL/geometry/Cylinder.h"
 #include "PROPOSAL/geometry/Geometry.h"
+#include "PROPOSAL/geometry/GeometryFactory.h"
+#include "PROPOSAL/geometry/GeometryVariant.h"
+#include "PROPOSAL/geometry/Mesh.h"
 #include "PROPOSAL/geometry/Sphere.h"
 #include "PROPOSAL/math/RandomGenerator.h"
 #include "PROPOSAL/math/Spherical3D.h"
 
+#include <cstdio>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
 using namespace PROPOSAL;
 
 Cartesian3D posi = Cartesian3D(0,0,0);
@@ -100,6 +107,40 @@ TEST(DistanceToClosestApproach, Method)
     ASSERT_NEAR(distance_closest_approach, 1., 1e-9);
 }
 
+TEST(MinimalDistance, Method)
+{
+    Sphere sphere(Cartesian3D(0, 0, 0), 10, 5);
+    EXPECT_DOUBLE_EQ(sphere.MinimalDistance(Cartesian3D(0, 0, 0)), 0.);
+    EXPECT_DOUBLE_EQ(sphere.MinimalDistance(Cartesian3D(0, 30, 0)), 20.);
+
+    Box box(Cartesian3D(0, 0, 0), 2, 4, 6);
+    EXPECT_DOUBLE_EQ(box.MinimalDistance(Cartesian3D(0.5, 1, 1)), 0.);
+    EXPECT_DOUBLE_EQ(box.MinimalDistance(Cartesian3D(0, 0, 10)), 7.);
+    EXPECT_DOUBLE_EQ(box.MinimalDistance(Cartesian3D(4, 6, 3)), 5.);
+
+    Cylinder cylinder(Cartesian3D(0, 0, 0), 10, 3);
+    EXPECT_DOUBLE_EQ(cylinder.MinimalDistance(Cartesian3D(1, 1, 4)), 0.);
+    EXPECT_DOUBLE_EQ(cylinder.MinimalDistance(Cartesian3D(0, 7, 0)), 4.);
+    EXPECT_DOUBLE_EQ(cylinder.MinimalDistance(Cartesian3D(0, 6, 9)), 5.);
+
+    // no geometry point may be closer than the bound
+    for (int i = 0; i < 100; ++i) {
+        Cartesian3D pos(RandomGenerator::Get().RandomDouble() * 40 - 20,
+            RandomGenerator::Get().RandomDouble() * 40 - 20,
+            RandomGenerator::Get().RandomDouble() * 40 - 20);
+        Geometry* geometries[] = { &sphere, &box, &cylinder };
+        for (auto geometry : geometries) {
+            auto d = geometry->MinimalDistance(pos);
+            auto dir = geometry->GetPosition() - pos;
+            dir.normalize();
+            auto dist = geometry->DistanceToBorder(pos, dir).first;
+            if (d > 0 && dist > 0) {
+                EXPECT_LE(d, dist + 1e-9);
+            }
+        }
+    }
+}
+
 TEST(IsInside, Box)
 {
     Cartesian3D particle_position(0, 0, 0);
@@ -1197,6 +1238,222 @@ TEST(DistanceTo, Box)
     }
 }
 
+TEST(Intersect, Sphere)
+{
+    Sphere sphere(Cartesian3D(0, 0, 0), 5);
+    Cartesian3D direction(0, 0, 1);
+
+    auto infront = sphere.Intersect(Cartesian3D(0, 0, -10), direction);
+    EXPECT_EQ(infront.location, Geometry::ParticleLocation::InfrontGeometry);
+    EXPECT_DOUBLE_EQ(infront.entry, 5);
+    EXPECT_DOUBLE_EQ(infront.exit, 15);
+    EXPECT_DOUBLE_EQ(infront.NextBorder(), 5);
+
+    auto inside = sphere.Intersect(Cartesian3D(0, 0, 1), direction);
+    EXPECT_EQ(inside.location, Geometry::ParticleLocation::InsideGeometry);
+    EXPECT_EQ(inside.entry, -1);
+    EXPECT_DOUBLE_EQ(inside.exit, 4);
+    EXPECT_DOUBLE_EQ(inside.NextBorder(), 4);
+
+    // on the border and moving outside
+    auto behind = sphere.Intersect(Cartesian3D(0, 0, 5), direction);
+    EXPECT_EQ(behind.location, Geometry::ParticleLocation::BehindGeometry);
+    EXPECT_EQ(behind.entry, -1);
+    EXPECT_EQ(behind.exit, -1);
+}
+
+namespace {
+// box of the size x, y, z around center as triangle mesh, the triangles of
+// every second box are oriented inwards
+void AddBox(std::vector<Mesh::Vertex>& vertices, std::vector<Mesh::Face>& faces,
+    Mesh::Vertex center, double x, double y, double z, bool inwards = false)
+{
+    auto first = vertices.size();
+    for (int i = 0; i < 8; ++i)
+        vertices.push_back({ center[0] + (i & 1 ? 0.5 : -0.5) * x,
+            center[1] + (i & 2 ? 0.5 : -0.5) * y,
+            center[2] + (i & 4 ? 0.5 : -0.5) * z });
+    std::vector<Mesh::Face> box_faces = { { 0, 2, 1 }, { 1, 2, 3 }, { 4, 5, 6 },
+        { 5, 7, 6 }, { 0, 1, 4 }, { 1, 5, 4 }, { 2, 6, 3 }, { 3, 6, 7 },
+        { 0, 4, 2 }, { 2, 4, 6 }, { 1, 3, 5 }, { 3, 7, 5 } };
+    for (auto f : box_faces) {
+        if (inwards)
+            std::swap(f[1], f[2]);
+        faces.push_back({ first + f[0], first + f[1], first + f[2] });
+    }
+}
+} // namespace
+
+TEST(Mesh, CompareWithBox)
+{
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<Mesh::Face> faces;
+    AddBox(vertices, faces, { 0, 0, 0 }, 10, 6, 4, true);
+
+    Cartesian3D center(1, 2, 3);
+    Mesh mesh(center, vertices, faces);
+    Box box(center, 10, 6, 4);
+    EXPECT_EQ(mesh.GetNumberOfTriangles(), 12);
+
+    for (int i = 0; i < 10000; ++i) {
+        Cartesian3D position(RandomGenerator::Get().RandomDouble() * 30 - 14,
+            RandomGenerator::Get().RandomDouble() * 30 - 13,
+            RandomGenerator::Get().RandomDouble() * 30 - 12);
+        Spherical3D direction(1, RandomGenerator::Get().RandomDouble() * 2 * PI,
+            RandomGenerator::Get().RandomDouble() * PI);
+
+        auto expected = box.DistanceToBorder(position, direction);
+        auto distance = mesh.DistanceToBorder(position, direction);
+        EXPECT_NEAR(distance.first, expected.first, 1e-9);
+        EXPECT_NEAR(distance.second, expected.second, 1e-9);
+        EXPECT_EQ(mesh.IsInside(position, direction), box.IsInside(position, direction));
+        EXPECT_LE(mesh.MinimalDistance(position), box.MinimalDistance(position) + 1e-12);
+    }
+
+    // on the border, moving inside or outside
+    EXPECT_TRUE(mesh.IsInside(Cartesian3D(6, 2, 3), Cartesian3D(-1, 0, 0)));
+    EXPECT_FALSE(mesh.IsInside(Cartesian3D(6, 2, 3), Cartesian3D(1, 0, 0)));
+}
+
+TEST(Mesh, NonConvex)
+{
+    // many boxes along the x axis, the trajectory has to stop at the first
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<Mesh::Face> faces;
+    for (int i = 0; i < 100; ++i)
+        AddBox(vertices, faces, { 3. * i, 0, 0 }, 1, 1, 1);
+    Mesh mesh(Cartesian3D(0, 0, 0), vertices, faces);
+    EXPECT_GT(mesh.GetNumberOfNodes(), 1);
+
+    auto distance = mesh.DistanceToBorder(Cartesian3D(-10, 0, 0), Cartesian3D(1, 0, 0));
+    EXPECT_NEAR(distance.first, 9.5, 1e-9);
+    EXPECT_NEAR(distance.second, 10.5, 1e-9);
+
+    // the public Geometry::Intersect is reachable on a Mesh
+    auto intersection = mesh.Intersect(Cartesian3D(-10, 0, 0), Cartesian3D(1, 0, 0));
+    EXPECT_EQ(intersection.location, Geometry::ParticleLocation::InfrontGeometry);
+    EXPECT_NEAR(intersection.entry, 9.5, 1e-9);
+    EXPECT_NEAR(intersection.exit, 10.5, 1e-9);
+
+    distance = mesh.DistanceToBorder(Cartesian3D(151.5, 0, 0), Cartesian3D(-1, 0, 0));
+    EXPECT_NEAR(distance.first, 1., 1e-9);
+    EXPECT_NEAR(distance.second, 2., 1e-9);
+
+    distance = mesh.DistanceToBorder(Cartesian3D(150.2, 0, 0), Cartesian3D(0, 1, 0));
+    EXPECT_NEAR(distance.first, 0.5, 1e-9);
+    EXPECT_EQ(distance.second, -1);
+
+    distance = mesh.DistanceToBorder(Cartesian3D(151, 0, 0), Cartesian3D(0, 1, 0));
+    EXPECT_EQ(distance.first, -1);
+    EXPECT_EQ(distance.second, -1);
+}
+
+TEST(Mesh, ReadFiles)
+{
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<Mesh::Face> faces;
+    AddBox(vertices, faces, { 0, 0, 0 }, 2, 2, 2);
+    Mesh reference(Cartesian3D(0, 0, 5), vertices, faces);
+
+    {
+        std::ofstream obj("Geometry_TEST_mesh.obj");
+        for (auto& v : vertices)
+            obj << "v " << v[0] << " " << v[1] << " " << v[2] << "\n";
+        for (auto& f : faces)
+            obj << "f " << f[0] + 1 << " " << f[1] + 1 << "/1 " << f[2] + 1 << "//2\n";
+    }
+    {
+        std::ofstream stl("Geometry_TEST_mesh.stl");
+        stl << "solid box\n";
+        for (auto& f : faces) {
+            stl << "facet normal 0 0 0\nouter loop\n";
+            for (auto i : f)
+                stl << "vertex " << vertices[i][0] << " " << vertices[i][1] << " "
+                    << vertices[i][2] << "\n";
+            stl << "endloop\nendfacet\n";
+        }
+        stl << "endsolid box\n";
+    }
+    {
+        std::ofstream ply("Geometry_TEST_mesh.ply");
+        ply << "ply\nformat ascii 1.0\nelement vertex " << vertices.size()
+            << "\nproperty float x\nproperty float y\nproperty float z\n"
+            << "element face " << faces.size()
+            << "\nproperty list uchar int vertex_indices\nend_header\n";
+        for (auto& v : vertices)
+            ply << v[0] << " " << v[1] << " " << v[2] << "\n";
+        for (auto& f : faces)
+            ply << "3 " << f[0] << " " << f[1] << " " << f[2] << "\n";
+    }
+
+    for (std::string path : { "Geometry_TEST_mesh.obj", "Geometry_TEST_mesh.stl",
+             "Geometry_TEST_mesh.ply" }) {
+        auto config = nlohmann::json::parse(R"({"shape": "mesh", "origin": [0, 0, 5]})");
+        config["path"] = path;
+        config["scale"] = 1;
+        auto mesh = CreateGeometry(config);
+        auto distance = mesh->DistanceToBorder(Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1));
+        EXPECT_NEAR(distance.first, 4, 1e-9);
+        EXPECT_NEAR(distance.second, 6, 1e-9);
+        std::remove(path.c_str());
+    }
+
+    EXPECT_THROW(Mesh(Cartesian3D(0, 0, 0), "Geometry_TEST_missing.obj"),
+        std::invalid_argument);
+}
+
+TEST(GeometryVariant, SameAsVirtual)
+{
+    // derived from a built-in geometry, has to use the virtual interface
+    struct ShiftedSphere : public Sphere {
+        using Sphere::Sphere;
+        std::pair<double, double> DistanceToBorder(
+            const Vector3D& position, const Vector3D& direction) const override
+        {
+            return Sphere::DistanceToBorder(
+                Cartesian3D(position) - Cartesian3D(1, 0, 0), direction);
+        }
+    };
+
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<Mesh::Face> faces;
+    AddBox(vertices, faces, { 0, 0, 0 }, 4, 5, 6);
+
+    Cartesian3D center(1, -2, 3);
+    std::vector<std::shared_ptr<Geometry>> geometries = {
+        std::make_shared<Sphere>(center, 5, 2),
+        std::make_shared<Box>(center, 4, 5, 6),
+        std::make_shared<Cylinder>(center, 6, 5, 1),
+        std::make_shared<Mesh>(center, vertices, faces),
+        std::make_shared<ShiftedSphere>(center, 5, 2) };
+
+    for (auto& geometry : geometries) {
+        GeometryVariant variant(*geometry);
+        EXPECT_EQ(&variant.GetGeometry(), geometry.get());
+        for (int i = 0; i < 1000; ++i) {
+            Cartesian3D position(RandomGenerator::Get().RandomDouble() * 20 - 9,
+                RandomGenerator::Get().RandomDouble() * 20 - 12,
+                RandomGenerator::Get().RandomDouble() * 20 - 7);
+            Spherical3D direction(1,
+                RandomGenerator::Get().RandomDouble() * 2 * PI,
+                RandomGenerator::Get().RandomDouble() * PI);
+            auto distance = geometry->DistanceToBorder(position, direction);
+            EXPECT_EQ(variant.DistanceToBorder(position, direction), distance);
+
+            auto intersection = variant.Intersect(position, direction);
+            EXPECT_EQ(intersection.location,
+                geometry->GetLocation(position, direction));
+            EXPECT_EQ(intersection.NextBorder(), distance.first);
+            EXPECT_EQ(intersection.location == Geometry::ParticleLocation::InsideGeometry,
+                geometry->IsInside(position, direction));
+            EXPECT_EQ(intersection.location == Geometry::ParticleLocation::InfrontGeometry,
+                geometry->IsInfront(position, direction));
+            EXPECT_EQ(intersection.location == Geometry::ParticleLocation::BehindGeometry,
+                geometry->IsBehind(position, direction));
+        }
+    }
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
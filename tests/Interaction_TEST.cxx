@@ -1,10 +1,12 @@
 #include "gtest/gtest.h"
 
 #include "PROPOSAL/Constants.h"
+#include "PROPOSAL/crosssection/CrossSectionBias.h"
 #include "PROPOSAL/crosssection/CrossSectionBuilder.h"
 #include "PROPOSAL/crosssection/ParticleDefaultCrossSectionList.h"
 #include "PROPOSAL/math/RandomGenerator.h"
 #include "PROPOSAL/medium/Medium.h"
+#include "PROPOSAL/propagation_utility/InteractionBias.h"
 #include "PROPOSAL/propagation_utility/InteractionBuilder.h"
 #include "PROPOSAL/propagation_utility/PropagationUtilityIntegral.h"
 #include "PROPOSAL/propagation_utility/DisplacementBuilder.h"
@@ -244,6 +246,101 @@ TEST(MeanFreePath, RateInterpolant)
     }
 }
 
+TEST(SampleLossBinned, PerBinValidation)
+{
+    // compare the binned sampler with the exact channel probabilities and
+    // the exact cumulative loss distribution for energies between the nodes
+    RandomGenerator::Get().SetSeed(24601);
+    auto cross = GetCrossSections();
+    auto interaction = make_interaction(cross, true);
+    interaction->BuildBinnedSampling(20, 100);
+    EXPECT_TRUE(interaction->HasBinnedSampling());
+
+    int statistics = 1e4;
+    for (double logE = 3.025; logE < 12; logE += 0.5) {
+        auto energy = std::pow(10., logE);
+        auto rates = interaction->Rates(energy);
+        auto total_rate = 0.;
+        for (auto& r : rates)
+            total_rate += r.rate;
+
+        std::vector<int> counts(rates.size(), 0);
+        std::vector<double> pit_sum(rates.size(), 0.);
+        for (int n = 0; n < statistics; ++n) {
+            auto loss = interaction->SampleLossBinned(
+                energy, rnd_number(), rnd_number());
+            EXPECT_GT(loss.v_loss, 0.);
+            EXPECT_LE(loss.v_loss, 1.);
+            for (size_t i = 0; i < rates.size(); ++i) {
+                if (rates[i].crosssection->GetInteractionType() == loss.type
+                    && rates[i].comp_hash == loss.comp_hash) {
+                    counts[i] += 1;
+                    pit_sum[i] += rates[i].crosssection
+                                      ->CalculateCumulativeCrosssection(
+                                          energy, rates[i].comp_hash,
+                                          loss.v_loss)
+                        / rates[i].rate;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < rates.size(); ++i) {
+            auto p = rates[i].rate / total_rate;
+            auto sigma = std::sqrt(p * (1 - p) / statistics);
+            EXPECT_NEAR(counts[i] / double(statistics), p, 5 * sigma + 1e-2);
+
+            // the exact cumulative distribution of the sampled losses has to
+            // be uniform
+            if (counts[i] > 100)
+                EXPECT_NEAR(pit_sum[i] / counts[i], 0.5,
+                    5 / std::sqrt(12. * counts[i]) + 1e-2);
+        }
+    }
+}
+
+TEST(InteractionBias, Weights)
+{
+    auto cross = GetCrossSections();
+    auto bias = 10.;
+    auto biased_cross = cross;
+    std::shared_ptr<CrossSectionBase> photo;
+    for (auto& c : biased_cross) {
+        if (c->GetInteractionType() == InteractionType::Photonuclear) {
+            photo = c;
+            c = make_crosssection_bias(c, bias);
+        }
+    }
+    ASSERT_TRUE(photo);
+
+    auto disp = std::shared_ptr<Displacement>(
+        make_displacement(biased_cross, true));
+    auto interaction
+        = std::shared_ptr<Interaction>(make_interaction(disp, biased_cross, true));
+    EXPECT_EQ(make_interaction_bias(interaction, disp, cross, true), nullptr);
+    auto interaction_bias
+        = make_interaction_bias(interaction, disp, biased_cross, true);
+    ASSERT_TRUE(interaction_bias);
+
+    EXPECT_DOUBLE_EQ(
+        interaction_bias->WeightStochastic(InteractionType::Photonuclear),
+        1. / bias);
+    EXPECT_DOUBLE_EQ(
+        interaction_bias->WeightStochastic(InteractionType::Brems), 1.);
+
+    // the continuous weight is the ratio of the true and the biased survival
+    // probability, exp(I_biased - I_true) = exp((bias - 1) * I_photo)
+    auto photo_interaction = make_interaction(disp, { photo }, true);
+    for (double logE = 4; logE < 12; logE += 0.5) {
+        auto E_i = std::pow(10., logE);
+        auto E_f = 0.5 * E_i;
+        auto weight = interaction_bias->WeightContinuous(E_i, E_f);
+        auto expected = (bias - 1) * photo_interaction->EnergyIntegral(E_i, E_f);
+        EXPECT_GT(weight, 1.);
+        EXPECT_NEAR(std::log(weight), expected, std::abs(expected) * 1e-3);
+        EXPECT_DOUBLE_EQ(interaction_bias->WeightContinuous(E_i, E_i), 1.);
+    }
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
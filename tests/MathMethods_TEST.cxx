@@ -76,6 +76,41 @@ TEST(Bisection, Comparison_equal)
 }
 
 
+TEST(PolynomialRoots, Comparison_equal)
+{
+    // (x - 1) * (x + 2) * (x - 3)
+    auto roots = PolynomialRoots({6., -5., -2., 1.});
+    ASSERT_EQ(roots.size(), 3);
+    EXPECT_NEAR(roots[0], -2., 1e-12);
+    EXPECT_NEAR(roots[1], 1., 1e-12);
+    EXPECT_NEAR(roots[2], 3., 1e-12);
+
+    roots = PolynomialRoots({-4., 0., 0., 1.});
+    ASSERT_EQ(roots.size(), 1);
+    EXPECT_NEAR(roots[0], pow(4., 1./3), 1e-12);
+
+    roots = PolynomialRoots({1., 0., 1.});
+    EXPECT_TRUE(roots.empty());
+
+    roots = PolynomialRoots({-2., 4., 0., 0.});
+    ASSERT_EQ(roots.size(), 1);
+    EXPECT_DOUBLE_EQ(roots[0], 0.5);
+
+    EXPECT_THROW(PolynomialRoots({1., 1., 1., 1., 1.}), MathException);
+}
+
+TEST(SolvePolynomial, Interval)
+{
+    std::vector<double> coefficients = {6., -5., -2., 1.};
+    EXPECT_NEAR(SolvePolynomial(coefficients, 0., 0., 5.), 1., 1e-12);
+    EXPECT_NEAR(SolvePolynomial(coefficients, 0., 5., 0.), 3., 1e-12);
+    EXPECT_NEAR(SolvePolynomial(coefficients, 6., -1., 1.), 0., 1e-12);
+    EXPECT_THROW(SolvePolynomial(coefficients, 0., 1.5, 2.5), MathException);
+
+    // degree four is solved numerically: x^4 = 16
+    EXPECT_NEAR(SolvePolynomial({0., 0., 0., 0., 1.}, 16., 0., 5.), 2., 1e-6);
+}
+
 TEST(SampleFromGaussian, Momenta){
     RandomGenerator::Get().SetSeed(24601);
     double sigma = 2;
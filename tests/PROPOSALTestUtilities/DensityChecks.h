@@ -0,0 +1,30 @@
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include "PROPOSAL/density_distr/density_distr.h"
+#include "PROPOSAL/math/Cartesian3D.h"
+
+//!
+//! Compare the grammage of density along the track from position to a
+//! midpoint Riemann sum of Evaluate with n steps, and check that Correct
+//! returns the distance for the calculated grammage.
+//!
+inline void ExpectGrammageRoundTrip(const PROPOSAL::Density_distr& density,
+    const PROPOSAL::Cartesian3D& position,
+    const PROPOSAL::Cartesian3D& direction, double distance,
+    double distance_to_border, double distance_tolerance, int n = 100000)
+{
+    SCOPED_TRACE("distance " + std::to_string(distance));
+    auto step = distance / n;
+    auto grammage = 0.;
+    for (auto i = 0; i < n; ++i)
+        grammage
+            += step * density.Evaluate(position + (i + 0.5) * step * direction);
+
+    auto calculated = density.Calculate(position, direction, distance);
+    EXPECT_NEAR(calculated, grammage, 1e-4 * grammage);
+    EXPECT_NEAR(
+        density.Correct(position, direction, calculated, distance_to_border),
+        distance, distance_tolerance);
+}
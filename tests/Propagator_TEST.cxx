@@ -1,14 +1,22 @@
 #include "gtest/gtest.h"
 #include "PROPOSAL/crosssection/ParticleDefaultCrossSectionList.h"
+#include "PROPOSAL/crosssection/CrossSectionBias.h"
+#include "PROPOSAL/propagation_utility/InteractionBias.h"
 #include "PROPOSAL/Propagator.h"
+#include "PROPOSAL/PropagatorService.h"
 #include "PROPOSAL/propagation_utility/TimeBuilder.h"
 #include "PROPOSAL/propagation_utility/InteractionBuilder.h"
 #include "PROPOSAL/propagation_utility/ContRandBuilder.h"
+#include "PROPOSAL/propagation_utility/DecayBuilder.h"
 #include "PROPOSAL/density_distr/density_homogeneous.h"
 #include "PROPOSAL/scattering/ScatteringFactory.h"
 #include "PROPOSAL/geometry/Sphere.h"
+#include "PROPOSAL/math/RandomGenerator.h"
 #include "PROPOSAL/particle/Particle.h"
 
+#include <random>
+#include <thread>
+
 using namespace PROPOSAL;
 
 TEST(Propagator, min_energy)
@@ -57,6 +65,609 @@ TEST(Propagator, min_energy)
     }
 }
 
+TEST(Propagator, PropagateBatchIndependentOfThreads)
+{
+    auto p_def = MuMinusDef();
+    auto medium = Ice();
+    auto cuts = std::make_shared<EnergyCutSettings>(INF, 0.05, true);
+    auto cross = GetStdCrossSections(p_def, medium, cuts, true);
+
+    auto collection = PropagationUtility::Collection();
+    collection.interaction_calc = make_interaction(cross, true);
+    collection.displacement_calc = make_displacement(cross, true);
+    collection.time_calc = make_time(cross, p_def, true);
+    collection.scattering = make_scattering(MultipleScatteringType::Highland, {}, p_def, medium);
+
+    auto density_distr = std::make_shared<Density_homogeneous>(medium);
+    auto world = std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 1e20);
+    std::vector<Sector> sec_vec = {
+        std::make_tuple(world, PropagationUtility(collection), density_distr)};
+
+    auto prop = Propagator(p_def, sec_vec);
+
+    auto init_state = ParticleState();
+    init_state.energy = 1e6;
+    init_state.position = Cartesian3D(0, 0, 0);
+    init_state.direction = Cartesian3D(0, 0, 1);
+    std::vector<ParticleState> initial_states(100, init_state);
+
+    auto tracks_single = prop.PropagateBatch(initial_states, 1, 42, 1e5);
+    auto tracks_multi = prop.PropagateBatch(initial_states, 4, 42, 1e5);
+
+    ASSERT_EQ(tracks_single.size(), initial_states.size());
+    ASSERT_EQ(tracks_multi.size(), initial_states.size());
+    for (size_t i = 0; i < initial_states.size(); ++i) {
+        EXPECT_EQ(tracks_single[i].GetTrackLength(), tracks_multi[i].GetTrackLength());
+        EXPECT_DOUBLE_EQ(tracks_single[i].GetFinalState().energy,
+            tracks_multi[i].GetFinalState().energy);
+    }
+}
+
+TEST(Propagator, InteractionBiasUnbiased)
+{
+    // the weighted number of photonuclear losses has to agree with the
+    // number propagated without bias
+    auto p_def = MuMinusDef();
+    auto medium = Ice();
+    auto cuts = std::make_shared<EnergyCutSettings>(500, 0.05, false);
+    auto cross = GetStdCrossSections(p_def, medium, cuts, true);
+    auto biased_cross = cross;
+    for (auto& c : biased_cross) {
+        if (c->GetInteractionType() == InteractionType::Photonuclear)
+            c = make_crosssection_bias(c, 10.);
+    }
+
+    auto density_distr = std::make_shared<Density_homogeneous>(medium);
+    auto world = std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 1e20);
+    auto create_propagator = [&](std::vector<std::shared_ptr<CrossSectionBase>> c) {
+        auto collection = PropagationUtility::Collection();
+        auto disp = std::shared_ptr<Displacement>(make_displacement(c, true));
+        collection.displacement_calc = disp;
+        collection.interaction_calc = make_interaction(disp, c, true);
+        collection.time_calc = make_time(c, p_def, true);
+        collection.bias = make_interaction_bias(
+            collection.interaction_calc, disp, c, true);
+        std::vector<Sector> sec_vec = { std::make_tuple(
+            world, PropagationUtility(collection), density_distr) };
+        return Propagator(p_def, sec_vec);
+    };
+    auto prop = create_propagator(cross);
+    auto prop_biased = create_propagator(biased_cross);
+
+    auto init_state = ParticleState(ParticleType::MuMinus,
+        Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), 1e6, 0., 0.);
+    auto rnd = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+
+    // mean and variance of the weighted number of photonuclear losses
+    auto count = [&](Propagator& p, int statistics) {
+        auto sum = 0.;
+        auto sum2 = 0.;
+        for (int i = 0; i < statistics; ++i) {
+            auto n = 0.;
+            auto track = p.Propagate(init_state, rnd, 1e5);
+            for (auto& loss : track.GetStochasticLosses(InteractionType::Photonuclear))
+                n += loss.weight;
+            sum += n;
+            sum2 += n * n;
+        }
+        auto mean = sum / statistics;
+        return std::make_pair(mean, (sum2 / statistics - mean * mean) / statistics);
+    };
+    auto unbiased = count(prop, 2000);
+    auto biased = count(prop_biased, 2000);
+    EXPECT_GT(unbiased.first, 0.);
+    EXPECT_NEAR(biased.first, unbiased.first,
+        5 * std::sqrt(unbiased.second + biased.second));
+}
+
+TEST(Propagator, PropagateBatchMoliere)
+{
+    // Moliere scattering and the integrals of utilities without
+    // interpolation are evaluated concurrently by the threads
+    auto p_def = MuMinusDef();
+    auto medium = Ice();
+    auto cuts = std::make_shared<EnergyCutSettings>(INF, 0.05, true);
+    for (auto interpolate : { true, false }) {
+        auto cross = GetStdCrossSections(p_def, medium, cuts, interpolate);
+
+        auto collection = PropagationUtility::Collection();
+        collection.interaction_calc = make_interaction(cross, interpolate);
+        collection.displacement_calc = make_displacement(cross, interpolate);
+        collection.time_calc = make_time(cross, p_def, interpolate);
+        collection.scattering = make_scattering(
+            MultipleScatteringType::Moliere, {}, p_def, medium);
+
+        auto density_distr = std::make_shared<Density_homogeneous>(medium);
+        auto world = std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 1e20);
+        std::vector<Sector> sec_vec = { std::make_tuple(
+            world, PropagationUtility(collection), density_distr) };
+        auto prop = Propagator(p_def, sec_vec);
+
+        auto init_state = ParticleState();
+        init_state.energy = 1e6;
+        init_state.position = Cartesian3D(0, 0, 0);
+        init_state.direction = Cartesian3D(0, 0, 1);
+        std::vector<ParticleState> initial_states(
+            interpolate ? 100 : 8, init_state);
+        auto max_distance = interpolate ? 1e5 : 1e3;
+
+        auto tracks_single
+            = prop.PropagateBatch(initial_states, 1, 42, max_distance);
+        auto tracks_multi
+            = prop.PropagateBatch(initial_states, 4, 42, max_distance);
+        for (size_t i = 0; i < initial_states.size(); ++i) {
+            auto single = tracks_single[i].GetFinalState();
+            auto multi = tracks_multi[i].GetFinalState();
+            EXPECT_EQ(tracks_single[i].GetTrackLength(),
+                tracks_multi[i].GetTrackLength());
+            EXPECT_DOUBLE_EQ(single.energy, multi.energy);
+            EXPECT_DOUBLE_EQ(single.position.GetX(), multi.position.GetX());
+            EXPECT_DOUBLE_EQ(single.direction.GetY(), multi.direction.GetY());
+        }
+    }
+}
+
+TEST(Propagator, TargetOutOfRange)
+{
+    auto p_def = MuMinusDef();
+    auto medium = Ice();
+    auto cuts = std::make_shared<EnergyCutSettings>(INF, 0.05, true);
+    auto cross = GetStdCrossSections(p_def, medium, cuts, true);
+
+    auto collection = PropagationUtility::Collection();
+    collection.interaction_calc = make_interaction(cross, true);
+    collection.displacement_calc = make_displacement(cross, true);
+    collection.time_calc = make_time(cross, p_def, true);
+
+    auto density_distr = std::make_shared<Density_homogeneous>(medium);
+    auto world = std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 1e20);
+    std::vector<Sector> sec_vec = {
+        std::make_tuple(world, PropagationUtility(collection), density_distr)};
+
+    auto prop = Propagator(p_def, sec_vec);
+
+    auto init_state = ParticleState();
+    init_state.energy = 1e4;
+    init_state.position = Cartesian3D(0, 0, 0);
+    init_state.direction = Cartesian3D(0, 0, 1);
+
+    // a 10 GeV muon has a range of about 50 m in ice
+    auto far_target = std::make_shared<Sphere>(Cartesian3D(0, 0, 1e6), 100);
+    prop.SetTarget(far_target);
+    auto track = prop.Propagate(init_state);
+    EXPECT_EQ(track.GetTrackLength(), 1);
+    EXPECT_EQ(track.GetFinalState().energy, init_state.energy);
+
+    auto near_target = std::make_shared<Sphere>(Cartesian3D(0, 0, 2e3), 100);
+    prop.SetTarget(near_target);
+    track = prop.Propagate(init_state);
+    EXPECT_GT(track.GetTrackLength(), 1);
+
+    prop.SetTarget(nullptr);
+    track = prop.Propagate(init_state);
+    EXPECT_LT(track.GetFinalState().energy, p_def.mass * 2);
+}
+
+TEST(Propagator, AdjointContinuousLosses)
+{
+    // without stochastic losses, the adjoint propagation has to invert the
+    // continuous losses of the forward propagation
+    auto p_def = MuMinusDef();
+    auto medium = Ice();
+    auto cuts = std::make_shared<EnergyCutSettings>(INF, 1, false);
+    auto cross = GetStdCrossSections(p_def, medium, cuts, true);
+
+    auto collection = PropagationUtility::Collection();
+    collection.interaction_calc = make_interaction(cross, true);
+    collection.displacement_calc = make_displacement(cross, true);
+    collection.time_calc = make_time(cross, p_def, true);
+
+    auto density_distr = std::make_shared<Density_homogeneous>(medium);
+    auto world = std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 1e20);
+    std::vector<Sector> sec_vec = {
+        std::make_tuple(world, PropagationUtility(collection), density_distr)};
+    auto prop = Propagator(p_def, sec_vec);
+
+    auto target_state = ParticleState(ParticleType::MuMinus,
+        Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), 1e5, 0., 0.);
+    auto rnd = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+    auto source = prop.PropagateAdjoint(target_state, rnd, 1e4);
+    EXPECT_NEAR(source.position.GetZ(), -1e4, 1e-6);
+    EXPECT_DOUBLE_EQ(source.propagated_distance, -1e4);
+    EXPECT_LT(source.time, 0.);
+    EXPECT_GT(source.energy, target_state.energy);
+
+    // the weight is the jacobian dE_source / dE_target = dEdx(E_source) /
+    // dEdx(E_target)
+    auto& disp = collection.displacement_calc;
+    EXPECT_NEAR(source.weight,
+        disp->FunctionToIntegral(target_state.energy)
+            / disp->FunctionToIntegral(source.energy),
+        1e-6 * source.weight);
+
+    source.weight = 1.;
+    auto track = prop.Propagate(source, rnd, 1e4);
+    EXPECT_NEAR(track.GetFinalState().energy, target_state.energy,
+        1e-4 * target_state.energy);
+}
+
+TEST(Propagator, AdjointSources)
+{
+    auto p_def = MuMinusDef();
+    auto medium = Ice();
+    auto cuts = std::make_shared<EnergyCutSettings>(500, 0.05, false);
+    auto cross = GetStdCrossSections(p_def, medium, cuts, true);
+
+    auto collection = PropagationUtility::Collection();
+    collection.interaction_calc = make_interaction(cross, true);
+    collection.displacement_calc = make_displacement(cross, true);
+    collection.time_calc = make_time(cross, p_def, true);
+
+    auto density_distr = std::make_shared<Density_homogeneous>(medium);
+    auto world = std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 1e5);
+    std::vector<Sector> sec_vec = {
+        std::make_tuple(world, PropagationUtility(collection), density_distr)};
+    auto prop = Propagator(p_def, sec_vec);
+
+    auto target_state = ParticleState(ParticleType::MuMinus,
+        Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), 1e5, 0., 0.);
+    auto sources = prop.PropagateAdjoint(target_state, 1000);
+    ASSERT_EQ(sources.size(), 1000);
+    for (auto& source : sources) {
+        // the particles are traced back to the border of the world
+        EXPECT_NEAR(source.position.GetZ(), -1e5, 1e-3);
+        EXPECT_GT(source.energy, target_state.energy);
+        EXPECT_GE(source.weight, 0.);
+        EXPECT_TRUE(std::isfinite(source.weight));
+    }
+
+    auto outside = target_state;
+    outside.position = Cartesian3D(0, 0, 2e5);
+    EXPECT_THROW(prop.PropagateAdjoint(outside, 1), std::invalid_argument);
+}
+
+TEST(Propagator, AdjointForwardFlux)
+{
+    // the adjoint estimate mean(weight * S(E_source)) of the differential
+    // flux at the target has to agree with the forward propagation of the
+    // source spectrum S. At the target energy, v_cut * E is below e_cut.
+    auto p_def = MuMinusDef();
+    auto medium = Ice();
+    auto cuts = std::make_shared<EnergyCutSettings>(500, 0.02, false);
+    auto cross = GetStdCrossSections(p_def, medium, cuts, true);
+    auto biased_cross = cross;
+    for (auto& c : biased_cross) {
+        if (c->GetInteractionType() == InteractionType::Brems)
+            c = make_crosssection_bias(c, 5.);
+    }
+
+    auto density_distr = std::make_shared<Density_homogeneous>(medium);
+    auto world = std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 1e20);
+    auto create_propagator = [&](std::vector<std::shared_ptr<CrossSectionBase>> c) {
+        auto collection = PropagationUtility::Collection();
+        auto disp = std::shared_ptr<Displacement>(make_displacement(c, true));
+        collection.displacement_calc = disp;
+        collection.interaction_calc = make_interaction(disp, c, true);
+        collection.time_calc = make_time(c, p_def, true);
+        collection.bias = make_interaction_bias(
+            collection.interaction_calc, disp, c, true);
+        std::vector<Sector> sec_vec = { std::make_tuple(
+            world, PropagationUtility(collection), density_distr) };
+        return Propagator(p_def, sec_vec);
+    };
+    auto prop = create_propagator(cross);
+    auto prop_biased = create_propagator(biased_cross);
+    auto rnd = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+
+    // source spectrum E^-2 between 1e4 MeV and 1e5 MeV, normalized to 1
+    auto e_min = 1e4;
+    auto e_max = 1e5;
+    auto spectrum = [&](double E) {
+        if (E < e_min || E > e_max)
+            return 0.;
+        return 1. / (E * E * (1. / e_min - 1. / e_max));
+    };
+    auto distance = 1e3;
+    auto bin_low = 1.9e4;
+    auto bin_up = 2.1e4;
+    int statistics = 20000;
+
+    auto forward_count = 0.;
+    for (int i = 0; i < statistics; ++i) {
+        auto energy = 1. / (1. / e_min - rnd() * (1. / e_min - 1. / e_max));
+        auto init_state = ParticleState(ParticleType::MuMinus,
+            Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), energy, 0., 0.);
+        auto final_state = prop.Propagate(init_state, rnd, distance).GetFinalState();
+        if (final_state.energy >= bin_low && final_state.energy < bin_up)
+            forward_count += 1.;
+    }
+    auto forward = forward_count / statistics / (bin_up - bin_low);
+    auto forward_var = forward_count / std::pow(statistics * (bin_up - bin_low), 2);
+    EXPECT_GT(forward_count, 100.);
+
+    for (auto* p : { &prop, &prop_biased }) {
+        auto sum = 0.;
+        auto sum2 = 0.;
+        for (int i = 0; i < statistics; ++i) {
+            auto energy = bin_low + rnd() * (bin_up - bin_low);
+            auto target_state = ParticleState(ParticleType::MuMinus,
+                Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), energy, 0., 0.);
+            auto source = p->PropagateAdjoint(target_state, rnd, distance);
+            auto flux = source.weight * spectrum(source.energy);
+            sum += flux;
+            sum2 += flux * flux;
+        }
+        auto adjoint = sum / statistics;
+        auto adjoint_var = (sum2 / statistics - adjoint * adjoint) / statistics;
+        EXPECT_NEAR(adjoint, forward, 5 * std::sqrt(forward_var + adjoint_var));
+    }
+}
+
+TEST(Propagator, ForcedVolume)
+{
+    auto p_def = MuMinusDef();
+    auto medium = Ice();
+    auto cuts = std::make_shared<EnergyCutSettings>(500, 0.05, false);
+    auto cross = GetStdCrossSections(p_def, medium, cuts, true);
+
+    auto collection = PropagationUtility::Collection();
+    collection.interaction_calc = make_interaction(cross, true);
+    collection.displacement_calc = make_displacement(cross, true);
+    collection.time_calc = make_time(cross, p_def, true);
+
+    auto density_distr = std::make_shared<Density_homogeneous>(medium);
+    auto world = std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 1e5);
+    std::vector<Sector> sec_vec = {
+        std::make_tuple(world, PropagationUtility(collection), density_distr)};
+    auto prop = Propagator(p_def, sec_vec);
+
+    auto volume = std::make_shared<Sphere>(Cartesian3D(0, 0, 1000), 1);
+    auto init_state = ParticleState(ParticleType::MuMinus,
+        Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), 1e6, 0., 0.);
+    auto rnd = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+
+    // every track has an interaction inside the volume
+    prop.SetForcedVolume(volume);
+    for (int i = 0; i < 100; ++i) {
+        auto track = prop.Propagate(init_state, rnd, 2000);
+        auto losses = track.GetStochasticLosses(*volume);
+        ASSERT_FALSE(losses.empty());
+        EXPECT_GT(losses.front().weight, 0.);
+        EXPECT_LT(losses.front().weight, 1.);
+        EXPECT_DOUBLE_EQ(track.GetFinalState().weight, losses.front().weight);
+    }
+
+    // splitting on entry
+    prop.SetForcedVolume(volume, false, 4);
+    auto tracks = prop.PropagateSplit(init_state, rnd, 2000);
+    ASSERT_EQ(tracks.size(), 4);
+    for (auto& track : tracks) {
+        EXPECT_DOUBLE_EQ(track.GetInitialState().weight, 0.25);
+        EXPECT_DOUBLE_EQ(track.GetFinalState().weight, 0.25);
+        EXPECT_NEAR(track.GetFinalState().propagated_distance, 2000, 1e-3);
+    }
+
+    // particles missing the volume are not split
+    auto missing = init_state;
+    missing.direction = Cartesian3D(1, 0, 0);
+    EXPECT_EQ(prop.PropagateSplit(missing, rnd, 2000).size(), 1);
+
+    EXPECT_THROW(prop.SetForcedVolume(volume, true, 0), std::invalid_argument);
+}
+
+TEST(Propagator, ForcedVolumeProbability)
+{
+    // the mean forced weight is the probability of an interaction inside
+    // the volume in the forward propagation
+    auto p_def = MuMinusDef();
+    auto medium = Ice();
+    auto cuts = std::make_shared<EnergyCutSettings>(500, 0.05, false);
+    auto cross = GetStdCrossSections(p_def, medium, cuts, true);
+
+    auto collection = PropagationUtility::Collection();
+    collection.interaction_calc = make_interaction(cross, true);
+    collection.displacement_calc = make_displacement(cross, true);
+    collection.time_calc = make_time(cross, p_def, true);
+
+    auto density_distr = std::make_shared<Density_homogeneous>(medium);
+    auto world = std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 1e5);
+    std::vector<Sector> sec_vec = {
+        std::make_tuple(world, PropagationUtility(collection), density_distr)};
+    auto prop = Propagator(p_def, sec_vec);
+
+    auto volume = std::make_shared<Sphere>(Cartesian3D(0, 0, 1000), 10);
+    auto init_state = ParticleState(ParticleType::MuMinus,
+        Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), 1e6, 0., 0.);
+    auto rnd = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+
+    int statistics = 20000;
+    auto n_interacting = 0.;
+    for (int i = 0; i < statistics; ++i) {
+        auto track = prop.Propagate(init_state, rnd, 2000);
+        if (!track.GetStochasticLosses(*volume).empty())
+            n_interacting += 1.;
+    }
+    auto probability = n_interacting / statistics;
+    EXPECT_GT(n_interacting, 100.);
+
+    prop.SetForcedVolume(volume);
+    auto weight_sum = 0.;
+    auto weight_sum2 = 0.;
+    int forced_statistics = 2000;
+    for (int i = 0; i < forced_statistics; ++i) {
+        auto track = prop.Propagate(init_state, rnd, 2000);
+        auto losses = track.GetStochasticLosses(*volume);
+        auto weight = losses.empty() ? 0. : losses.front().weight;
+        weight_sum += weight;
+        weight_sum2 += weight * weight;
+    }
+    auto forced = weight_sum / forced_statistics;
+    auto forced_var
+        = (weight_sum2 / forced_statistics - forced * forced) / forced_statistics;
+    EXPECT_NEAR(forced, probability,
+        5 * std::sqrt(probability * (1 - probability) / statistics + forced_var));
+}
+
+TEST(Propagator, ForcedVolumeSectors)
+{
+    // the volume spans two sectors, only the part inside the sector of the
+    // entry is forced
+    auto p_def = MuMinusDef();
+    auto medium = Ice();
+    auto cuts = std::make_shared<EnergyCutSettings>(500, 0.05, false);
+    auto cross = GetStdCrossSections(p_def, medium, cuts, true);
+
+    auto collection = PropagationUtility::Collection();
+    collection.interaction_calc = make_interaction(cross, true);
+    collection.displacement_calc = make_displacement(cross, true);
+    collection.time_calc = make_time(cross, p_def, true);
+
+    auto density_distr = std::make_shared<Density_homogeneous>(medium);
+    auto world = std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 1e5);
+    auto second = std::make_shared<Box>(Cartesian3D(0, 0, 2000), 1e4, 1e4, 2000);
+    second->SetHierarchy(1);
+    std::vector<Sector> sec_vec = {
+        std::make_tuple(world, PropagationUtility(collection), density_distr),
+        std::make_tuple(second, PropagationUtility(collection), density_distr) };
+    auto prop = Propagator(p_def, sec_vec);
+
+    auto volume = std::make_shared<Sphere>(Cartesian3D(0, 0, 1000), 10);
+    auto init_state = ParticleState(ParticleType::MuMinus,
+        Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), 1e6, 0., 0.);
+    auto rnd = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+
+    // probability of the first interaction inside the volume to happen
+    // before the second sector
+    int statistics = 20000;
+    auto n_interacting = 0.;
+    for (int i = 0; i < statistics; ++i) {
+        auto track = prop.Propagate(init_state, rnd, 1500);
+        auto losses = track.GetStochasticLosses(*volume);
+        if (!losses.empty() && losses.front().position.GetZ() < 1000)
+            n_interacting += 1.;
+    }
+    auto probability = n_interacting / statistics;
+    EXPECT_GT(n_interacting, 100.);
+
+    prop.SetForcedVolume(volume);
+    auto weight_sum = 0.;
+    auto weight_sum2 = 0.;
+    int forced_statistics = 2000;
+    for (int i = 0; i < forced_statistics; ++i) {
+        auto track = prop.Propagate(init_state, rnd, 1500);
+        auto losses = track.GetStochasticLosses(*volume);
+        ASSERT_FALSE(losses.empty());
+        EXPECT_LT(losses.front().position.GetZ(), 1000 + 1e-6);
+        auto weight = losses.front().weight;
+        weight_sum += weight;
+        weight_sum2 += weight * weight;
+    }
+    auto forced = weight_sum / forced_statistics;
+    auto forced_var
+        = (weight_sum2 / forced_statistics - forced * forced) / forced_statistics;
+    EXPECT_NEAR(forced, probability,
+        5 * std::sqrt(probability * (1 - probability) / statistics + forced_var));
+}
+
+TEST(PropagatorService, RouteByType)
+{
+    auto p_def = MuMinusDef();
+    auto medium = Ice();
+    auto cuts = std::make_shared<EnergyCutSettings>(INF, 0.05, true);
+    auto cross = GetStdCrossSections(p_def, medium, cuts, true);
+
+    auto collection = PropagationUtility::Collection();
+    collection.interaction_calc = make_interaction(cross, true);
+    collection.displacement_calc = make_displacement(cross, true);
+    collection.time_calc = make_time(cross, p_def, true);
+
+    auto density_distr = std::make_shared<Density_homogeneous>(medium);
+    auto world = std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 1e20);
+    std::vector<Sector> sec_vec = {
+        std::make_tuple(world, PropagationUtility(collection), density_distr)};
+
+    PropagatorService service;
+    service.RegisterPropagator(std::make_shared<Propagator>(p_def, sec_vec));
+
+    EXPECT_TRUE(service.IsRegistered(ParticleType::MuMinus));
+    EXPECT_FALSE(service.IsRegistered(ParticleType::TauMinus));
+
+    auto init_state = ParticleState(ParticleType::MuMinus,
+        Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), 1e6, 0., 0.);
+    auto track = service.Propagate(init_state, 1e4);
+    EXPECT_LT(track.GetFinalState().energy, init_state.energy);
+
+    init_state.type = static_cast<int>(ParticleType::TauMinus);
+    EXPECT_THROW(service.Propagate(init_state, 1e4), std::out_of_range);
+}
+
+TEST(PropagatorService, Threads)
+{
+    // several threads route particles of mixed types while a propagator is
+    // replaced, the tracks have to match a propagation on one thread
+    auto make_propagator = [](const ParticleDef& p_def) {
+        auto medium = Ice();
+        auto cuts = std::make_shared<EnergyCutSettings>(INF, 0.05, false);
+        auto cross = GetStdCrossSections(p_def, medium, cuts, true);
+
+        auto collection = PropagationUtility::Collection();
+        collection.interaction_calc = make_interaction(cross, true);
+        collection.displacement_calc = make_displacement(cross, true);
+        collection.time_calc = make_time(cross, p_def, true);
+        collection.decay_calc = make_decay(cross, p_def, true);
+
+        auto density_distr = std::make_shared<Density_homogeneous>(medium);
+        auto world = std::make_shared<Sphere>(Cartesian3D(0, 0, 0), 1e20);
+        std::vector<Sector> sec_vec = { std::make_tuple(
+            world, PropagationUtility(collection), density_distr) };
+        return std::make_shared<Propagator>(p_def, sec_vec);
+    };
+
+    PropagatorService service;
+    service.RegisterPropagator(make_propagator(MuMinusDef()));
+    service.RegisterPropagator(make_propagator(MuPlusDef()));
+    service.RegisterPropagator(make_propagator(TauMinusDef()));
+    auto replacement = make_propagator(MuPlusDef());
+
+    std::vector<ParticleType> types
+        = { ParticleType::MuMinus, ParticleType::MuPlus, ParticleType::TauMinus };
+    const unsigned int n_events = 60;
+    auto propagate = [&](unsigned int event) {
+        auto init_state = ParticleState(types[event % types.size()],
+            Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), 1e6, 0., 0.);
+        std::mt19937 rng(event);
+        std::uniform_real_distribution<double> uniform(0., 1.);
+        std::function<double()> rnd = [&]() { return uniform(rng); };
+        return service.Propagate(init_state, rnd, 1e4).GetFinalState();
+    };
+
+    std::vector<ParticleState> expected;
+    for (unsigned int event = 0; event < n_events; ++event)
+        expected.push_back(propagate(event));
+
+    const unsigned int n_threads = 4;
+    std::vector<ParticleState> final_states(n_events);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < n_threads; ++t)
+        threads.emplace_back([&, t]() {
+            for (auto event = t; event < n_events; event += n_threads) {
+                if (t == 0 && event == n_events / 2)
+                    service.RegisterPropagator(replacement);
+                final_states[event] = propagate(event);
+            }
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(service.GetPropagator(ParticleType::MuPlus), replacement);
+    for (unsigned int event = 0; event < n_events; ++event) {
+        EXPECT_EQ(final_states[event].type, expected[event].type);
+        EXPECT_EQ(final_states[event].energy, expected[event].energy);
+        EXPECT_EQ(final_states[event].propagated_distance,
+            expected[event].propagated_distance);
+    }
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
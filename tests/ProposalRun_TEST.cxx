@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+
+#include "PROPOSAL/output/EventFile.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace PROPOSAL;
+
+namespace {
+const std::string config_path = "ProposalRun_TEST_config.json";
+const std::string primaries_path = "ProposalRun_TEST_primaries.txt";
+const std::string generator_path = "ProposalRun_TEST_generator.json";
+
+void WriteInputs(size_t n_primaries)
+{
+    std::ofstream config(config_path);
+    config << R"({
+        "global": { "cuts": { "e_cut": 500, "v_cut": 1, "cont_rand": false } },
+        "sectors": [ { "medium": "ice", "geometries": [ { "hierarchy": 0,
+            "shape": "sphere", "origin": [0, 0, 0], "outer_radius": 1e20 }
+        ] } ] })";
+
+    std::ofstream primaries(primaries_path);
+    primaries << "# energy x y z dx dy dz\n";
+    for (size_t i = 0; i < n_primaries; ++i)
+        primaries << 1e4 + 100. * i << " 0 0 0 0 0 1\n";
+
+    std::ofstream generator(generator_path);
+    generator << R"({ "particle": 13, "n_events": 40, "seed": 3,
+        "spectrum": { "type": "powerlaw", "index": 2,
+                      "e_min": 1e3, "e_max": 1e5 } })";
+}
+
+int RunProposal(const std::string& args)
+{
+    std::string cmd = std::string(PROPOSAL_RUN_EXECUTABLE) + " --config "
+        + config_path + " --max-distance 1e5 " + args + " > /dev/null 2>&1";
+    return std::system(cmd.c_str());
+}
+
+struct Events {
+    uint64_t config_hash = 0;
+    std::vector<double> initial_energy;
+    std::vector<double> final_energy;
+};
+
+Events ReadEvents(const std::vector<std::string>& paths)
+{
+    Events events;
+    for (auto& path : paths) {
+        EventReader reader(path);
+        events.config_hash = reader.GetHeader().config_hash;
+        EventChunk chunk;
+        while (reader.ReadChunk(chunk)) {
+            EXPECT_EQ(chunk.first_event, events.final_energy.size());
+            events.initial_energy.insert(events.initial_energy.end(),
+                chunk.initial_energy.begin(), chunk.initial_energy.end());
+            events.final_energy.insert(events.final_energy.end(),
+                chunk.final_energy.begin(), chunk.final_energy.end());
+        }
+    }
+    return events;
+}
+} // namespace
+
+TEST(ProposalRun, Shards)
+{
+    WriteInputs(30);
+    ASSERT_EQ(RunProposal("--primaries " + primaries_path
+                  + " --output ProposalRun_TEST_full.ppev --threads 3"
+                    " --chunk-size 4"),
+        0);
+    ASSERT_EQ(RunProposal("--primaries " + primaries_path
+                  + " --output ProposalRun_TEST_0.ppev --shard 0/2"),
+        0);
+    ASSERT_EQ(RunProposal("--primaries " + primaries_path
+                  + " --output ProposalRun_TEST_1.ppev --shard 1/2"),
+        0);
+
+    auto full = ReadEvents({ "ProposalRun_TEST_full.ppev" });
+    auto sharded
+        = ReadEvents({ "ProposalRun_TEST_0.ppev", "ProposalRun_TEST_1.ppev" });
+    ASSERT_EQ(full.final_energy.size(), 30);
+    EXPECT_EQ(full.initial_energy[7], 1e4 + 700.);
+    EXPECT_EQ(full.final_energy, sharded.final_energy);
+    EXPECT_EQ(full.config_hash, sharded.config_hash);
+
+    for (auto path : { "ProposalRun_TEST_full.ppev", "ProposalRun_TEST_0.ppev",
+             "ProposalRun_TEST_1.ppev" })
+        std::remove(path);
+}
+
+TEST(ProposalRun, Checkpoint)
+{
+    std::string checkpoint = "ProposalRun_TEST_checkpoint.json";
+    std::string output = "ProposalRun_TEST_checkpoint.ppev";
+    std::remove(checkpoint.c_str());
+    WriteInputs(20);
+    auto args = "--primaries " + primaries_path + " --output " + output
+        + " --checkpoint " + checkpoint + " --checkpoint-every 6";
+    ASSERT_EQ(RunProposal(args), 0);
+    auto first = ReadEvents({ output });
+    ASSERT_EQ(first.final_energy.size(), 20);
+
+    // a finished run is not propagated again
+    ASSERT_EQ(RunProposal(args), 0);
+    EXPECT_EQ(ReadEvents({ output }).final_energy, first.final_energy);
+
+    // the checkpoint belongs to other primaries
+    WriteInputs(21);
+    EXPECT_NE(RunProposal(args), 0);
+
+    // the primaries file is part of the config hash
+    ASSERT_EQ(RunProposal("--primaries " + primaries_path
+                  + " --output ProposalRun_TEST_other.ppev"),
+        0);
+    EXPECT_NE(ReadEvents({ "ProposalRun_TEST_other.ppev" }).config_hash,
+        first.config_hash);
+
+    for (auto path : { checkpoint, output, std::string("ProposalRun_TEST_other.ppev") })
+        std::remove(path.c_str());
+}
+
+TEST(ProposalRun, Generator)
+{
+    WriteInputs(0);
+    ASSERT_EQ(RunProposal("--generator " + generator_path
+                  + " --output ProposalRun_TEST_gen.ppev --seed 3"),
+        0);
+    auto events = ReadEvents({ "ProposalRun_TEST_gen.ppev" });
+    ASSERT_EQ(events.initial_energy.size(), 40);
+    for (size_t i = 0; i < events.initial_energy.size(); ++i) {
+        EXPECT_GE(events.initial_energy[i], 1e3);
+        EXPECT_LE(events.initial_energy[i], 1e5);
+        EXPECT_LE(events.final_energy[i], events.initial_energy[i]);
+    }
+    std::remove("ProposalRun_TEST_gen.ppev");
+}
+
+TEST(ProposalRun, InvalidArguments)
+{
+    WriteInputs(1);
+    EXPECT_NE(RunProposal("--output ProposalRun_TEST_invalid.ppev"), 0);
+    EXPECT_NE(RunProposal("--primaries " + primaries_path + " --generator "
+                  + generator_path + " --output ProposalRun_TEST_invalid.ppev"),
+        0);
+    EXPECT_NE(RunProposal("--primaries " + primaries_path
+                  + " --output ProposalRun_TEST_invalid.ppev --shard 2/2"),
+        0);
+    std::remove("ProposalRun_TEST_invalid.ppev");
+}
@@ -17,9 +17,11 @@
 #include "PROPOSAL/scattering/multiple_scattering/Highland.h"
 #include "PROPOSAL/scattering/multiple_scattering/HighlandIntegral.h"
 #include "PROPOSAL/scattering/multiple_scattering/Moliere.h"
+#include "PROPOSAL/scattering/multiple_scattering/MoliereInterpol.h"
 #include "PROPOSAL/crosssection/ParticleDefaultCrossSectionList.h"
 #include "PROPOSAL/crosssection/CrossSection.h"
 #include <nlohmann/json.hpp>
+#include <thread>
 
 #include "PROPOSAL/propagation_utility/PropagationUtility.h"
 #include "PROPOSAL/propagation_utility/PropagationUtilityIntegral.h"
@@ -209,6 +211,29 @@ TEST(Scattering, BorderCases){
     }
 }
 
+TEST(Scattering, MoliereInterpolVsMoliere){
+    std::array<double, 6> rnds = {1e-5, 0.1, 0.4999, 0.5, 0.75, 0.99999};
+    std::array<double, 3> grammages = {1e-1, 1e1, 1e3};
+    std::array<double, 3> energies = {1e3, 1e5, 1e8};
+
+    for (auto const& medium : std::vector<Medium>{Water(), StandardRock(), Ice()}) {
+        multiple_scattering::Moliere moliere(MuMinusDef(), medium);
+        multiple_scattering::MoliereInterpol moliere_interpol(MuMinusDef(), medium);
+
+        for (auto grammage : grammages) {
+            for (auto energy : energies) {
+                for (auto rnd : rnds) {
+                    std::array<double, 4> rnd_list = {rnd, rnd, rnd, rnd};
+                    auto exact = moliere.CalculateRandomAngle(grammage, energy, energy, rnd_list);
+                    auto interpol = moliere_interpol.CalculateRandomAngle(grammage, energy, energy, rnd_list);
+                    EXPECT_NEAR(interpol.tx, exact.tx, std::abs(exact.tx) * 1e-3 + 1e-12);
+                    EXPECT_NEAR(interpol.sx, exact.sx, std::abs(exact.sx) * 1e-3 + 1e-12);
+                }
+            }
+        }
+    }
+}
+
 TEST(Scattering, ZeroDisplacement){
     // No displacement should mean no scattering
     auto medium = StandardRock();
@@ -467,6 +492,39 @@ TEST(Scattering, ScatterReproducibilityTest)
     }
 }
 
+TEST(Scattering, MoliereMultiThread)
+{
+    // the scattering parameters of a step must not be shared between calls
+    auto moliere = multiple_scattering::Moliere(MuMinusDef(), StandardRock());
+    auto sample = [&moliere](size_t i) {
+        auto energy = 1e3 * (1 + i % 100);
+        auto grammage = 1. + i % 7;
+        return moliere.CalculateRandomAngle(
+            grammage, energy, 0.9 * energy, { 0.1, 0.3, 0.6, 0.9 });
+    };
+
+    size_t n_samples = 10000;
+    std::vector<multiple_scattering::ScatteringOffset> expected;
+    for (size_t i = 0; i < n_samples; ++i)
+        expected.push_back(sample(i));
+
+    std::vector<multiple_scattering::ScatteringOffset> result(n_samples);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = t; i < n_samples; i += 4)
+                result[i] = sample(i);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (size_t i = 0; i < n_samples; ++i) {
+        EXPECT_DOUBLE_EQ(result[i].sx, expected[i].sx);
+        EXPECT_DOUBLE_EQ(result[i].ty, expected[i].ty);
+    }
+}
+
 TEST(Scattering, NoScattering)
 {
     // Check that "NoScattering" does not scatter the initial direction
@@ -1,7 +1,9 @@
 #include "gtest/gtest.h"
 #include <cmath>
+#include <random>
 
 #include "PROPOSAL/secondaries/parametrization/ionization/NaivIonization.h"
+#include "PROPOSAL/secondaries/parametrization/mupairproduction/KelnerKokoulinPetrukhinMupairProduction.h"
 #include "PROPOSAL/secondaries/parametrization/photomupairproduction/PhotoMuPairProductionBurkhardtKelnerKokoulin.h"
 #include "PROPOSAL/secondaries/parametrization/photopairproduction/PhotoPairProductionKochMotz.h"
 #include "PROPOSAL/secondaries/parametrization/photopairproduction/PhotoPairProductionTsai.h"
@@ -12,6 +14,8 @@
 #include "PROPOSAL/Constants.h"
 #include "PROPOSAL/medium/MediumFactory.h"
 #include "PROPOSAL/math/RandomGenerator.h"
+#include "PROPOSAL/secondaries/SecondariesCalculator.h"
+#include "PROPOSAL/secondaries/Thinning.h"
 
 using namespace PROPOSAL;
 
@@ -133,6 +137,60 @@ TEST(PhotoMuPairProduction, EnergyConservation)
 
 }
 
+TEST(MupairProduction, RhoInterpolantVsIntegral)
+{
+    auto particle = MuMinusDef();
+    auto medium = StandardRock();
+    auto comp = medium.GetComponents().front();
+
+    auto param_interpol = secondaries::KelnerKokoulinPetrukhinMupairProduction(particle, medium, true);
+    auto param_integral = secondaries::KelnerKokoulinPetrukhinMupairProduction(particle, medium, false);
+
+    for (auto E_i : {1e4, 1e6, 1e8}) {
+        for (auto v : {0.01, 0.1, 0.5}) {
+            for (auto rnd : {0.05, 0.3, 0.5, 0.7, 0.95}) {
+                auto rho_interpol = param_interpol.CalculateRho(E_i, v, comp, rnd, 0.9);
+                auto rho_integral = param_integral.CalculateRho(E_i, v, comp, rnd, 0.9);
+                EXPECT_GE(rho_interpol, 0.);
+                EXPECT_LE(rho_interpol, 1.);
+                EXPECT_NEAR(rho_interpol, rho_integral, 1e-2);
+            }
+        }
+    }
+}
+
+TEST(MupairProduction, EnergyConservation)
+{
+    RandomGenerator::Get().SetSeed(2);
+    auto particle = MuMinusDef();
+    auto medium = StandardRock();
+    auto param = secondaries::KelnerKokoulinPetrukhinMupairProduction(particle, medium);
+
+    auto E_i = 1e6;
+    auto init_direction = Cartesian3D(0, 0, 1);
+    auto init_position = Cartesian3D(0, 0, 0);
+
+    for (auto v : {0.001, 0.01, 0.1, 0.5}) {
+        auto loss = StochasticLoss((int)InteractionType::MuPair, v * E_i, init_position, init_direction, 0, 0, E_i);
+
+        std::vector<double> rnd;
+        for (int i=0; i < param.RequiredRandomNumbers(); i++) {
+            rnd.push_back(RandomGenerator::Get().RandomDouble());
+        }
+
+        auto secs = param.CalculateSecondaries(loss, medium.GetComponents().front(), rnd);
+
+        double E_sum = 0.;
+        for (auto sec : secs)
+            E_sum += sec.energy;
+
+        // expect primary particle and the created muon pair
+        EXPECT_EQ(secs.size(), 3);
+        // check energy conservation
+        EXPECT_NEAR(E_sum, E_i, E_i * COMPUTER_PRECISION);
+    }
+}
+
 TEST(Photoeffect, PhotoeffectNoDeflection)
 {
 
@@ -208,6 +266,178 @@ TEST(HeitlerAnnihilation, EnergyMomentumConservation)
     }
 }
 
+TEST(Thinning, RussianRoulette)
+{
+    auto thinning = Thinning();
+    thinning.SetRoulette(ParticleType::EMinus, 10, 0.1);
+    auto rnd = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+
+    auto electron = ParticleState(ParticleType::EMinus, Cartesian3D(0, 0, 0),
+        Cartesian3D(0, 0, 1), 1, 0, 0);
+    auto photon = electron;
+    photon.SetType(ParticleType::Gamma);
+    auto fast_electron = electron;
+    fast_electron.energy = 100;
+
+    int statistics = 100000;
+    auto weight_sum = 0.;
+    for (int i = 0; i < statistics; ++i) {
+        auto survivors = thinning.Apply({ electron, photon, fast_electron }, rnd);
+        ASSERT_GE(survivors.size(), 2);
+        for (auto& p : survivors) {
+            if (p.energy < 10 && p.type == electron.type) {
+                EXPECT_DOUBLE_EQ(p.weight, 10.);
+                weight_sum += p.weight;
+            } else {
+                EXPECT_DOUBLE_EQ(p.weight, 1.);
+            }
+        }
+    }
+    EXPECT_NEAR(weight_sum / statistics, 1., 0.05);
+
+    EXPECT_THROW(thinning.SetRoulette(ParticleType::Gamma, 10, 0),
+        std::invalid_argument);
+}
+
+TEST(Thinning, Hillas)
+{
+    auto thinning = Thinning();
+    thinning.SetHillasThinning(100);
+    auto rnd = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+
+    auto electron = ParticleState(ParticleType::EMinus, Cartesian3D(0, 0, 0),
+        Cartesian3D(0, 0, 1), 30, 0, 0);
+    auto photon = electron;
+    photon.SetType(ParticleType::Gamma);
+    photon.energy = 20;
+    auto muon = electron;
+    muon.SetType(ParticleType::MuMinus);
+    muon.energy = 1e3;
+
+    // the weighted energy of the thinned particles stays the same on average
+    int statistics = 100000;
+    auto energy_above = 0.;
+    auto energy_below = 0.;
+    for (int i = 0; i < statistics; ++i) {
+        auto survivors = thinning.Apply({ muon, electron, photon }, rnd, 1e4);
+        for (auto& p : survivors) {
+            if (p.type != muon.type) {
+                EXPECT_DOUBLE_EQ(p.energy * p.weight, 100.);
+                energy_above += p.energy * p.weight;
+            }
+        }
+
+        // the parent is below the thinning energy, one particle survives
+        survivors = thinning.Apply({ muon, electron, photon }, rnd, 50);
+        ASSERT_EQ(survivors.size(), 2);
+        EXPECT_EQ(survivors.front().type, muon.type);
+        EXPECT_DOUBLE_EQ(survivors.back().energy * survivors.back().weight, 50.);
+        energy_below += survivors.back().energy * survivors.back().weight;
+    }
+    EXPECT_NEAR(energy_above / statistics, 50., 1.);
+    EXPECT_NEAR(energy_below / statistics, 50., 1e-6);
+}
+
+TEST(Thinning, WeightWindow)
+{
+    auto thinning = Thinning();
+    thinning.SetWeightWindow(0.5, 2, 1);
+    auto rnd = std::bind(&RandomGenerator::RandomDouble, &RandomGenerator::Get());
+
+    auto light = ParticleState(ParticleType::Gamma, Cartesian3D(0, 0, 0),
+        Cartesian3D(0, 0, 1), 1, 0, 0);
+    light.weight = 0.05;
+    auto heavy = light;
+    heavy.weight = 5;
+
+    int statistics = 100000;
+    auto weight_sum = 0.;
+    for (int i = 0; i < statistics; ++i) {
+        for (auto& p : thinning.Apply({ light }, rnd)) {
+            EXPECT_DOUBLE_EQ(p.weight, 1.);
+            weight_sum += p.weight;
+        }
+    }
+    EXPECT_NEAR(weight_sum / statistics, 0.05, 0.005);
+
+    auto copies = thinning.Apply({ heavy }, rnd);
+    ASSERT_EQ(copies.size(), 3);
+    for (auto& p : copies)
+        EXPECT_DOUBLE_EQ(p.weight, 5. / 3.);
+
+    EXPECT_THROW(thinning.SetWeightWindow(0.5, 2, 3), std::invalid_argument);
+}
+
+TEST(Thinning, OutgoingPrimary)
+{
+    // the outgoing electron of an electron ionization must survive, only the
+    // delta electron is thinned
+    auto calc = SecondariesCalculator();
+    calc.addInteraction(PROPOSAL::make_unique<secondaries::NaivIonization>(
+        EMinusDef(), StandardRock()));
+    auto thinning = std::make_shared<Thinning>();
+    thinning->SetRoulette(ParticleType::EMinus, 1e9, 0.1);
+    calc.SetThinning(thinning);
+
+    auto loss = StochasticLoss((int)InteractionType::Ioniz, 1e1,
+        Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), 0, 0, 1e2);
+    auto rnd = std::vector<double>(
+        calc.RequiredRandomNumbers(InteractionType::Ioniz));
+
+    int statistics = 100000;
+    auto weight_sum = 0.;
+    for (int i = 0; i < statistics; ++i) {
+        for (auto& r : rnd)
+            r = RandomGenerator::Get().RandomDouble();
+        auto secs = calc.CalculateSecondaries(
+            loss, Components::StandardRock(), rnd);
+        ASSERT_GE(secs.size(), 1);
+        ASSERT_LE(secs.size(), 2);
+        EXPECT_EQ(secs.front().type, (int)ParticleType::EMinus);
+        EXPECT_DOUBLE_EQ(secs.front().energy, 1e2 - 1e1);
+        EXPECT_DOUBLE_EQ(secs.front().weight, 1.);
+        if (secs.size() == 2) {
+            EXPECT_DOUBLE_EQ(secs.back().weight, 10.);
+            weight_sum += secs.back().weight;
+        }
+    }
+    EXPECT_NEAR(weight_sum / statistics, 1., 0.05);
+}
+
+TEST(Thinning, CallerRandomNumbers)
+{
+    // the thinning draws from the given generator, equal seeds have to give
+    // equal secondaries
+    auto calc = SecondariesCalculator();
+    calc.addInteraction(PROPOSAL::make_unique<secondaries::NaivIonization>(
+        EMinusDef(), StandardRock()));
+    auto thinning = std::make_shared<Thinning>();
+    thinning->SetRoulette(ParticleType::EMinus, 1e9, 0.5);
+    calc.SetThinning(thinning);
+
+    auto loss = StochasticLoss((int)InteractionType::Ioniz, 1e1,
+        Cartesian3D(0, 0, 0), Cartesian3D(0, 0, 1), 0, 0, 1e2);
+    auto rnd = std::vector<double>(
+        calc.RequiredRandomNumbers(InteractionType::Ioniz), 0.5);
+
+    auto n_secondaries = [&](unsigned int seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> uniform(0., 1.);
+        std::function<double()> rnd_thinning = [&]() { return uniform(rng); };
+        std::vector<size_t> n;
+        for (int i = 0; i < 1000; ++i)
+            n.push_back(calc.CalculateSecondaries(
+                loss, Components::StandardRock(), rnd, rnd_thinning).size());
+        return n;
+    };
+
+    RandomGenerator::Get().SetSeed(1);
+    auto n = n_secondaries(7);
+    RandomGenerator::Get().SetSeed(2);
+    EXPECT_EQ(n_secondaries(7), n);
+    EXPECT_NE(n_secondaries(8), n);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
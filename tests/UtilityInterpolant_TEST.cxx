@@ -1,6 +1,7 @@
 #include "gtest/gtest.h"
 
 #include "PROPOSAL/propagation_utility/PropagationUtility.h"
+#include "PROPOSAL/propagation_utility/PropagationUtilityInterpolant.h"
 
 using namespace PROPOSAL;
 
@@ -9,6 +10,27 @@ int main(int argc, char** argv) {
     return RUN_ALL_TESTS();
 }
 
+TEST(GetUpperLimit, InverseInterpolant){
+    auto integrand = [](double x)->double {return -1/x;};
+    double lower_lim = 100;
+
+    for (bool reverse : {false, true}) {
+        auto interpolant = UtilityInterpolant(integrand, lower_lim, 4325465);
+        interpolant.BuildTables("unittest_interpolant_", 200, reverse);
+
+        for (double loglower = 3; loglower < 13; loglower+=1e-1) {
+            for (double logxi = -6; logxi < 1; logxi+=1e-1) {
+                double lower = std::pow(10, loglower);
+                double xi = std::pow(10, logxi);
+                double analytical_upper = lower * std::exp(-xi);
+                if (analytical_upper < lower_lim)
+                    continue;
+                EXPECT_NEAR(interpolant.GetUpperLimit(lower, xi), analytical_upper, analytical_upper*1e-5);
+            }
+        }
+    }
+}
+
 /* TEST(Calculate, Forward){ */
 /*     auto integrand = [](double x)->double {return -1/x;}; */
 /*     double lower_lim = 100; */
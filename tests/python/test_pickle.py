@@ -0,0 +1,96 @@
+import pickle
+
+import numpy as np
+import proposal as pp
+import pytest
+
+
+CONFIG = """{
+    "global": { "cuts": { "e_cut": 500, "v_cut": 0.05, "cont_rand": false } },
+    "sectors": [ { "medium": "ice", "geometries": [ { "hierarchy": 0,
+        "shape": "sphere", "origin": [0, 0, 0], "outer_radius": 1e20 }
+    ] } ]
+}"""
+
+
+def propagate(prop):
+    n = 20
+    energies = np.full(n, 1e5)
+    positions = np.zeros((n, 3))
+    directions = np.tile([0.0, 0.0, 1.0], (n, 1))
+    return prop.propagate_batch(
+        energies, positions, directions, max_distance=1e5, n_threads=1, seed=3
+    )
+
+
+def test_pickle_roundtrip(tmp_path):
+    config = tmp_path / "config.json"
+    config.write_text(CONFIG)
+    tables = tmp_path / "tables"
+    tables.mkdir()
+    other_tables = tmp_path / "other_tables"
+    other_tables.mkdir()
+
+    initial_path = pp.InterpolationSettings.tables_path
+    try:
+        pp.InterpolationSettings.tables_path = str(tables)
+        prop = pp.Propagator(pp.particle.MuMinusDef(), str(config))
+        n_tables = len(list(tables.iterdir()))
+
+        # the settings at the construction of the propagator are pickled,
+        # unpickling builds the propagator from them and keeps the settings
+        # of the process
+        pp.InterpolationSettings.tables_path = str(other_tables)
+        state = pickle.dumps(prop)
+        copy = pickle.loads(state)
+        assert pp.InterpolationSettings.tables_path == str(other_tables)
+        assert len(list(other_tables.iterdir())) == 0
+        assert len(list(tables.iterdir())) == n_tables
+    finally:
+        pp.InterpolationSettings.tables_path = initial_path
+
+    result, result_copy = propagate(prop), propagate(copy)
+    np.testing.assert_array_equal(
+        result["final_energy"], result_copy["final_energy"]
+    )
+    np.testing.assert_array_equal(
+        result["loss_energy"], result_copy["loss_energy"]
+    )
+
+
+def test_pickle_empty_tables_path(tmp_path):
+    # without a tables path the tables are not written and unpickling would
+    # have to recalculate all of them
+    config = tmp_path / "config.json"
+    config.write_text(CONFIG)
+
+    initial_path = pp.InterpolationSettings.tables_path
+    try:
+        pp.InterpolationSettings.tables_path = ""
+        prop = pp.Propagator(pp.particle.MuMinusDef(), str(config))
+    finally:
+        pp.InterpolationSettings.tables_path = initial_path
+    with pytest.raises(RuntimeError):
+        pickle.dumps(prop)
+
+
+def test_pickle_sectors():
+    # propagators built from sector lists have no config to pickle
+    cross = pp.crosssection.make_std_crosssection(
+        particle_def=pp.particle.MuMinusDef(),
+        target=pp.medium.Ice(),
+        interpolate=False,
+        cuts=pp.EnergyCutSettings(500, 0.05),
+    )
+    collection = pp.PropagationUtilityCollection()
+    collection.displacement = pp.make_displacement(cross, False)
+    collection.interaction = pp.make_interaction(cross, False)
+    utility = pp.PropagationUtility(collection=collection)
+    sector = (
+        pp.geometry.Sphere(pp.Cartesian3D(0, 0, 0), 1e20),
+        utility,
+        pp.density_distribution.density_homogeneous(pp.medium.Ice().mass_density),
+    )
+    prop = pp.Propagator(pp.particle.MuMinusDef(), [sector])
+    with pytest.raises(RuntimeError):
+        pickle.dumps(prop)